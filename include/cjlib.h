@@ -22,14 +22,18 @@
 #define CJLIB_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <memory.h>
 #include <malloc.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include <threads.h>
 
 #include "cjlib_dictionary.h"
 #include "cjlib_list.h"
 #include "cjlib_error.h"
+#include "cjlib_memory.h"
 
 typedef double cjlib_json_num; /* Represents a JSON number. */
 typedef bool cjlib_json_bool;  /* Represents a JSON boolean entry. */
@@ -38,6 +42,8 @@ typedef char *cjlib_json_path; /* A string that represents the location of the J
 typedef FILE *cjlib_json_fd;                /* The file descriptor of the JSON file. */
 typedef cjlib_dict_t cjlib_json_object;     /* Represents a JSON object. */
 typedef struct cjlib_list cjlib_json_array; /* Represents a JSON array. */
+typedef struct cjlib_dict_key cjlib_json_key_t; /* A key, whose length, hash and prefix are precomputed. */
+typedef struct cjlib_dict_iter cjlib_json_object_iter_t; /* A walk over the members of an object. */
 
 #if defined(__GNUC__) || defined(__clang__)
 
@@ -117,6 +123,44 @@ typedef struct cjlib_list cjlib_json_array; /* Represents a JSON array. */
  */
 #define CJLIB_ARR_FOR_EACH(ITEM, ARR_PTR, TYPE) (CJLIB_LIST_FOR_EACH(ITEM, ARR_PTR, TYPE))
 
+/**
+ * CJLIB_ITER_NAME makes the name of a variable of an iteration unique to the line it is on,
+ * thus the iterations can be nested (each one on its own line) without shadowing one another.
+ */
+#define CJLIB_ITER_CONCAT(NAME, LINE) NAME##LINE
+#define CJLIB_ITER_EXPAND(NAME, LINE) CJLIB_ITER_CONCAT(NAME, LINE)
+#define CJLIB_ITER_NAME(NAME)         CJLIB_ITER_EXPAND(cjlib_##NAME##_, __LINE__)
+
+/**
+ * CJLIB_OBJECT_FOR_EACH iterates on each member of the object OBJ_PTR, in the order of
+ * their keys when the object is kept in a tree (see cjlib_json_object_iter_begin). No
+ * memory is allocated. The object must not gain or lose members during the iteration.
+ *
+ * @param KEY A const char * variable, where the key of the current member is stored.
+ * @param VALUE_PTR A const struct cjlib_json_data * variable, which points to the value of the current member.
+ * @param OBJ_PTR Represents a pointer to the object of interest.
+ */
+#define CJLIB_OBJECT_FOR_EACH(KEY, VALUE_PTR, OBJ_PTR)                                                                   \
+    for (cjlib_json_object_iter_t CJLIB_ITER_NAME(iter),                                                                \
+         *CJLIB_ITER_NAME(iter_ptr) = (cjlib_json_object_iter_begin(&CJLIB_ITER_NAME(iter), (OBJ_PTR)),                  \
+                                       &CJLIB_ITER_NAME(iter));                                                         \
+         cjlib_json_object_iter_next(CJLIB_ITER_NAME(iter_ptr), &(KEY), &(VALUE_PTR));)
+
+/**
+ * The same as CJLIB_OBJECT_FOR_EACH, but the values may be changed in place (see
+ * cjlib_json_object_iter_begin_mut). A frozen/persistent object is not iterated at all.
+ *
+ * @param KEY A const char * variable, where the key of the current member is stored.
+ * @param VALUE_PTR A struct cjlib_json_data * variable, which points to the value of the current member.
+ * @param OBJ_PTR Represents a pointer to the object of interest.
+ */
+#define CJLIB_OBJECT_FOR_EACH_MUT(KEY, VALUE_PTR, OBJ_PTR)                                                               \
+    for (cjlib_json_object_iter_t CJLIB_ITER_NAME(iter),                                                                \
+         *CJLIB_ITER_NAME(iter_ptr) = (-1 == cjlib_json_object_iter_begin_mut(&CJLIB_ITER_NAME(iter), (OBJ_PTR)))        \
+                                       ? NULL : &CJLIB_ITER_NAME(iter);                                                 \
+         NULL != CJLIB_ITER_NAME(iter_ptr) &&                                                                           \
+         cjlib_json_object_iter_next_mut(CJLIB_ITER_NAME(iter_ptr), &(KEY), &(VALUE_PTR));)
+
 /**
  * CJLIB_GET_NUMBER retrieves a number data-type from the cjlib_data structure.
  * It could be used as a more readable version of its equivalent: CJLIB_DATA.c_value.c_num.
@@ -126,12 +170,12 @@ typedef struct cjlib_list cjlib_json_array; /* Represents a JSON array. */
 #define CJLIB_GET_NUMBER(CJLIB_DATA) (CJLIB_DATA.c_value.c_num)
 
 /**
- * CJLIB_GET_STRING retrieves a string data-type from the cjlib_data structure.
- * It could be used as a more readable version of its equivalent: CJLIB_DATA.c_value.c_str.
+ * CJLIB_GET_STRING retrieves a string data-type from the cjlib_data structure, whether
+ * it is kept on the heap or in the structure itself (see cjlib_json_data_string).
  *
  * @param CJLIB_DATA A variable declared as a type of cjlib_json_data structure.
  */
-#define CJLIB_GET_STRING(CJLIB_DATA) (CJLIB_DATA.c_value.c_str)
+#define CJLIB_GET_STRING(CJLIB_DATA) (cjlib_json_data_string(&(CJLIB_DATA)))
 
 /**
  * CJLIB_GET_BOOL retrieves a boolean data-type from the cjlib_data structure.
@@ -176,6 +220,9 @@ enum cjlib_json_datatypes
     CJLIB_NULL     /* Represents the NULL data-type. */
 };
 
+// The size of the strings (along with the '\0') that are kept in the data themselves (see c_inline).
+#define CJLIB_INLINE_STRING_SIZE (0x8)
+
 /**
  *  cjlib_json represents the JSON representation stored in memory.
 */
@@ -184,6 +231,33 @@ struct cjlib_json
     cjlib_json_fd c_fp;        /* Represents the file pointer of the JSON file. */
     cjlib_json_object *c_dict; /* Represents the root-object containing all the entries. */
     char *c_path;              /* Represents the path to the JSON file. */
+    bool c_cache;              /* Whether the serialization of the objects/arrays is cached between dumps. */
+    enum cjlib_dict_backend c_backend; /* The backend of the objects of the JSON (see cjlib_json_set_backend). */
+    struct cjlib_json_spare *c_spare;  /* The blocks kept for the next parsing (see cjlib_json_reset). */
+};
+
+/**
+ * cjlib_json_source describes an input of cjlib_json_parse_many, either a JSON
+ * file or a JSON stored in memory.
+*/
+struct cjlib_json_source
+{
+    const char *s_path; /* Represents the path to the JSON file (NULL if the JSON is in s_buf). */
+    const char *s_buf;  /* Represents the JSON, when there is no file. */
+    size_t s_buf_s;     /* Represents the size of s_buf. */
+};
+
+/**
+ * cjlib_json_handle holds the current version of a json. A version is replaced as a
+ * whole by cjlib_json_reload, while any number of threads keep reading (see
+ * cjlib_json_handle_enter); an old version is freed once its last reader has left.
+*/
+struct cjlib_json_handle
+{
+    _Atomic(struct cjlib_json *) h_current; /* Represents the current version (frozen). */
+    atomic_uint h_epoch;                    /* Changes on every reload, its parity selects the counter of the readers. */
+    atomic_size_t h_readers[2];             /* The number of readers that entered on each parity of h_epoch. */
+    mtx_t h_reload;                         /* Allows a single reload at a time. */
 };
 
 /**
@@ -197,21 +271,73 @@ union cjlib_json_data_disting
     cjlib_json_object *c_obj;  /* Represents an OBJECT data-type. */
     void *c_null;              /* Represents a NULL data-type. */
     cjlib_json_array *c_arr;   /* Represents an ARRAY data-type. */
+    char c_short[CJLIB_INLINE_STRING_SIZE]; /* Represents a short STRING data-type, with its '\0'. */
 };
 
 /**
- * cjlib_json_data represents an entry of the JSON file.
+ * cjlib_json_data represents an entry of the JSON file. The objects and arrays keep their
+ * values in this form, not packed in fewer bytes, since they hand out pointers to them
+ * (see cjlib_json_object_ref_mut, cjlib_json_array_ref_mut and the iterators).
  */
 struct cjlib_json_data
 {
     union cjlib_json_data_disting c_value; /* Represents the value of the entry. */
     enum cjlib_json_datatypes c_datatype;  /* Represents the data-type of the value. */
+    bool c_inline;                         /* Whether a STRING is kept in c_short rather than c_str. */
     /*
      * c_value constitute of a type specified in the cjlib_json_data_disting union, thus
-     * a second field, c_datatype, is required to know the selected data-type.
+     * a second field, c_datatype, is required to know the selected data-type. c_inline
+     * lives in the padding after it and is cleared by cjlib_json_data_init.
      */
 };
 
+/**
+ * cjlib_json_data_string retrieves the string of a value (see CJLIB_GET_STRING). A short
+ * string lives in the value itself, thus it is valid for as long as the value (e.g., the
+ * copy made by cjlib_json_object_get) is; read the strings through here, rather than c_str.
+ *
+ * @param src The value.
+ * @return The string, or NULL if the value is not a string.
+ */
+static inline char *cjlib_json_data_string(const struct cjlib_json_data *src)
+{
+    if (CJLIB_STRING != src->c_datatype) return NULL;
+    return (src->c_inline) ? (char *) src->c_value.c_short : src->c_value.c_str;
+}
+
+/**
+ * cjlib_json_data_set_string makes a value out of a copy of a string. A string shorter than
+ * CJLIB_INLINE_STRING_SIZE is kept in the value itself, without allocating any memory, a
+ * longer one on the heap.
+ *
+ * @param dst The value.
+ * @param src The string.
+ * @param src_s The length of the string.
+ * @return 0 on success, otherwise -1.
+ */
+static inline int cjlib_json_data_set_string(struct cjlib_json_data *restrict dst, const char *restrict src, size_t src_s)
+{
+    char *copy;
+
+    if (src_s < CJLIB_INLINE_STRING_SIZE) {
+        (void) memcpy(dst->c_value.c_short, src, src_s);
+        dst->c_value.c_short[src_s] = '\0';
+        dst->c_datatype             = CJLIB_STRING;
+        dst->c_inline               = true;
+        return 0;
+    }
+
+    copy = (char *) malloc(src_s + 1);
+    if (NULL == copy) return -1;
+    (void) memcpy(copy, src, src_s);
+    copy[src_s] = '\0';
+
+    dst->c_value.c_str = copy;
+    dst->c_datatype    = CJLIB_STRING;
+    dst->c_inline      = false;
+    return 0;
+}
+
 /**
  * cjlib_json_init Initializes a JSON structure.
  *
@@ -239,6 +365,8 @@ static inline void cjlib_json_destroy(struct cjlib_json *restrict src)
     src->c_dict = NULL;
     free(src->c_path);
     src->c_path = NULL;
+    cjlib_memory_spare_release(src->c_spare);
+    src->c_spare = NULL;
 }
 
 /**
@@ -249,6 +377,7 @@ static inline void cjlib_json_destroy(struct cjlib_json *restrict src)
 static inline cjlib_json_object *cjlib_json_make_object(void)
 {
     cjlib_json_object *obj = cjlib_make_dict();
+    if (NULL == obj) return NULL;
     cjlib_dict_init(obj);
     return obj;
 }
@@ -284,7 +413,7 @@ static inline void cjlib_json_data_destroy(struct cjlib_json_data *restrict src)
 
     switch (src->c_datatype) {
         case CJLIB_STRING:
-            free(src->c_value.c_str);
+            if (!src->c_inline) free(src->c_value.c_str);
             break;
         case CJLIB_OBJECT:
             cjlib_dict_destroy(src->c_value.c_obj);
@@ -322,11 +451,30 @@ static inline void cjlib_json_free_array(cjlib_json_array *src)
 static inline cjlib_json_array *cjlib_json_make_array(void)
 {
     cjlib_json_array *arr = make_list();
+    if (NULL == arr) return NULL;
     cjlib_list_init(arr);
 
     return arr;
 }
 
+/**
+ * cjlib_json_data_fragment retrieves the cached serialization of an object or an array.
+ *
+ * @param src A pointer to the memory area where the JSON entry is stored.
+ * @return A pointer to the fragment of the entry, or NULL if the entry is neither an object nor an array.
+ */
+static inline struct cjlib_fragment *cjlib_json_data_fragment(const struct cjlib_json_data *restrict src)
+{
+    switch (src->c_datatype) {
+        case CJLIB_OBJECT:
+            return (NULL == src->c_value.c_obj) ? NULL : &src->c_value.c_obj->d_fragment;
+        case CJLIB_ARRAY:
+            return (NULL == src->c_value.c_arr) ? NULL : &src->c_value.c_arr->l_fragment;
+        default:
+            return NULL;
+    }
+}
+
 /**
  * cjlib_json_array_append appends an ew element at the end of an array.
  *
@@ -337,7 +485,14 @@ static inline cjlib_json_array *cjlib_json_make_array(void)
  */
 static inline int cjlib_json_array_append(cjlib_json_array *restrict src, const struct cjlib_json_data *restrict value)
 {
-    return cjlib_list_append((const void *) value, sizeof(struct cjlib_json_data), src);
+    struct cjlib_fragment *value_fragment = cjlib_json_data_fragment(value);
+
+    if (src->l_frozen) return -1;
+    if (-1 == cjlib_list_append((const void *) value, sizeof(struct cjlib_json_data), src)) return -1;
+
+    if (NULL != value_fragment) value_fragment->f_parent = &src->l_fragment;
+    cjlib_fragment_invalidate(&src->l_fragment);
+    return 0;
 }
 
 /**
@@ -354,9 +509,49 @@ static inline int cjlib_json_array_get(struct cjlib_json_data *restrict dst, int
     return cjlib_list_get(dst, sizeof(struct cjlib_json_data), index, arr);
 }
 
+/**
+ * cjlib_json_array_ref retrieves an element from an array, without copying it.
+ *
+ * @param index An integer representing the index of the element.
+ * @param arr A pointer to the memory area where the array is stored.
+ * @return A pointer to the element kept by the array, or NULL if there is no such element.
+ */
+static inline const struct cjlib_json_data *cjlib_json_array_ref(int index, const cjlib_json_array *restrict arr)
+{
+    return (const struct cjlib_json_data *) cjlib_list_at(index, arr);
+}
+
+/**
+ * The same as cjlib_json_array_ref, but the element may be changed in place. The cached
+ * serialization of the array is invalidated when the element is handed out, thus a change
+ * made after the array is serialized again must be followed by cjlib_json_array_touch.
+ * A frozen array gives no such element.
+ */
+static inline struct cjlib_json_data *cjlib_json_array_ref_mut(int index, cjlib_json_array *restrict arr)
+{
+    if (arr->l_frozen) return NULL;
+
+    struct cjlib_json_data *data = (struct cjlib_json_data *) cjlib_list_at(index, arr);
+
+    if (NULL != data) cjlib_fragment_invalidate(&arr->l_fragment);
+    return data;
+}
+
+/**
+ * cjlib_json_array_touch marks an array as changed, after one of its elements was changed
+ * in place (see cjlib_json_array_ref_mut), thus its cached serialization is not used again.
+ *
+ * @param arr A pointer to the memory area where the array is stored.
+ */
+static inline void cjlib_json_array_touch(cjlib_json_array *restrict arr)
+{
+    cjlib_fragment_invalidate(&arr->l_fragment);
+}
+
 /**
  * This function associates a key (string) to a value and set this combination key - value
- * to a json object.
+ * to a json object. On a persistent object (see cjlib_json_object_persist), the object is left
+ * as it was and a new version of it is stored in @src instead.
  * 
  * @param src A pointer to the json object in which we should put the value.
  * @param key A string that associates the value with it.
@@ -382,7 +577,178 @@ extern int cjlib_json_object_get
  const char *restrict key);
 
 /**
- * cjlib_json_object_remove removes the data associated with the key.
+ * cjlib_json_object_ref gets the data associated with the key, without copying them.
+ * Nested objects and arrays can be reached by following the returned pointers.
+ *
+ * @param src A pointer to the json object.
+ * @param key A string that associates the value with it.
+ * @return A pointer to the value kept by the object, or NULL if there is no such key. The pointer
+ * is valid until the object is next changed (any key set or removed), since the entries of an
+ * object may be moved when it grows or shrinks (e.g., from the flat array to the hash table).
+*/
+extern const struct cjlib_json_data *cjlib_json_object_ref
+(const cjlib_json_object *restrict src, const char *restrict key);
+
+/**
+ * The same as cjlib_json_object_ref, but the value may be changed in place. The cached
+ * serialization of the object is invalidated when the value is handed out, thus a change
+ * made after the object is serialized again must be followed by cjlib_json_object_touch.
+ * Replacing a string, an object or an array this way does not release the previous one;
+ * cjlib_json_object_set does.
+ *
+ * @param src A pointer to the json object.
+ * @param key A string that associates the value with it.
+ * @return A pointer to the value kept by the object, or NULL if there is no such key or
+ * the object is frozen/persistent.
+*/
+extern struct cjlib_json_data *cjlib_json_object_ref_mut
+(cjlib_json_object *restrict src, const char *restrict key);
+
+/**
+ * cjlib_json_object_touch marks an object as changed, after one of its values was changed
+ * in place (see cjlib_json_object_ref_mut), thus its cached serialization is not used again.
+ *
+ * @param src A pointer to the json object.
+ */
+static inline void cjlib_json_object_touch(cjlib_json_object *restrict src)
+{
+    cjlib_fragment_invalidate(&src->d_fragment);
+}
+
+/**
+ * cjlib_json_object_get_many gets the data associated with several keys at once,
+ * which is faster than a cjlib_json_object_get per key.
+ *
+ * @param dst A pointer to an array of `keys_s` entries, where the data of each key should be
+ *            stored (the entry of a key that does not exist is left as it was).
+ * @param src A pointer to the json object.
+ * @param keys The keys.
+ * @param keys_s The number of keys.
+ * @return The number of keys that exist.
+*/
+extern size_t cjlib_json_object_get_many
+(struct cjlib_json_data *restrict dst, const cjlib_json_object *restrict src,
+ const char *const *restrict keys, size_t keys_s);
+
+/**
+ * cjlib_json_key_make precomputes the length, the hash and the prefix of a key,
+ * for the lookups that use the same key over and over (see cjlib_json_object_get_k).
+ *
+ * @param dst A pointer to the location where the key handle should be stored.
+ * @param key The key, it is not copied and it must outlive the handle.
+ */
+static inline void cjlib_json_key_make(cjlib_json_key_t *restrict dst, const char *key)
+{
+    cjlib_dict_key_make(dst, key);
+}
+
+/**
+ * cjlib_json_object_iter_begin starts a walk over the members of an object, without
+ * allocating any memory. When the object is kept in a tree, its members are visited in
+ * the order of their keys, otherwise in the order they are stored.
+ *
+ * @param dst A pointer to the iterator.
+ * @param src A pointer to the json object, it must not gain or lose members during the walk.
+ */
+static inline void cjlib_json_object_iter_begin(cjlib_json_object_iter_t *restrict dst, const cjlib_json_object *src)
+{
+    cjlib_dict_iter_begin(dst, src);
+}
+
+/**
+ * cjlib_json_object_iter_next moves to the next member of a walk.
+ *
+ * @param src A pointer to the iterator.
+ * @param key Where to store the key of the member.
+ * @param value Where to store a pointer to the value of the member.
+ * @return true if there was a next member, otherwise false.
+ */
+static inline bool cjlib_json_object_iter_next
+(cjlib_json_object_iter_t *restrict src, const char **restrict key, const struct cjlib_json_data **restrict value)
+{
+    struct cjlib_json_data *data;
+
+    if (!cjlib_dict_iter_next(src, key, &data)) return false;
+
+    *value = data;
+    return true;
+}
+
+/**
+ * The same as cjlib_json_object_iter_begin, but the values of the walk may be changed in
+ * place (see cjlib_json_object_iter_next_mut). The cached serialization of the object is
+ * invalidated when the walk starts, thus a change made after the object is serialized again
+ * must be followed by cjlib_json_object_touch.
+ *
+ * @param dst A pointer to the iterator.
+ * @param src A pointer to the json object, it must not gain or lose members during the walk.
+ * @return 0 on success, otherwise -1 (the object is frozen/persistent, the iterator is not started).
+ */
+static inline int cjlib_json_object_iter_begin_mut(cjlib_json_object_iter_t *restrict dst, cjlib_json_object *src)
+{
+    // The values of a frozen/persistent object are never changed in place.
+    if (CJLIB_DICT_FROZEN == src->d_backend || CJLIB_DICT_PERSISTENT == src->d_backend) return -1;
+
+    cjlib_fragment_invalidate(&src->d_fragment);
+    cjlib_dict_iter_begin(dst, src);
+    return 0;
+}
+
+/**
+ * The same as cjlib_json_object_iter_next, on a walk started by cjlib_json_object_iter_begin_mut.
+ *
+ * @param src A pointer to the iterator.
+ * @param key Where to store the key of the member.
+ * @param value Where to store a pointer to the value of the member, which can be changed in place.
+ * @return true if there was a next member, otherwise false.
+ */
+static inline bool cjlib_json_object_iter_next_mut
+(cjlib_json_object_iter_t *restrict src, const char **restrict key, struct cjlib_json_data **restrict value)
+{
+    return cjlib_dict_iter_next(src, key, value);
+}
+
+/**
+ * The same as cjlib_json_object_set, with a key handle (see cjlib_json_key_make).
+ *
+ * @param src A pointer to the json object in which we should put the value.
+ * @param key The handle of the key.
+ * @param value The value to associate with the key.
+ * @param datatype The json datatype of the value.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_object_set_k
+(cjlib_json_object **src, const cjlib_json_key_t *restrict key,
+ struct cjlib_json_data *restrict value, enum cjlib_json_datatypes datatype);
+
+/**
+ * The same as cjlib_json_object_get, with a key handle (see cjlib_json_key_make).
+ *
+ * @param dst A pointer that points to the location where the retrieved data should be stored.
+ * @param src A pointer to the json object.
+ * @param key The handle of the key.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_object_get_k
+(struct cjlib_json_data *restrict dst, const cjlib_json_object *restrict src,
+ const cjlib_json_key_t *restrict key);
+
+/**
+ * The same as cjlib_json_object_ref, with a key handle (see cjlib_json_key_make).
+*/
+extern const struct cjlib_json_data *cjlib_json_object_ref_k
+(const cjlib_json_object *restrict src, const cjlib_json_key_t *restrict key);
+
+/**
+ * The same as cjlib_json_object_ref_mut, with a key handle (see cjlib_json_key_make).
+*/
+extern struct cjlib_json_data *cjlib_json_object_ref_mut_k
+(cjlib_json_object *restrict src, const cjlib_json_key_t *restrict key);
+
+/**
+ * cjlib_json_object_remove removes the data associated with the key. On a persistent object
+ * (see cjlib_json_object_persist), the object is left as it was and a new version of it is
+ * stored in @src instead, then the data in @dst still belong to the previous version.
  *
  * @param dst A pointer that points to the location where the retrieved data should be stored. (can be NULL).
  * @param src A pointer to the json object in which we should put the value.
@@ -427,6 +793,54 @@ static CJLIB_ALWAYS_INLINE int cjlib_json_get
     return cjlib_json_object_get(dst, src->c_dict, key);
 }
 
+/**
+ * The same as cjlib_json_object_get_many, on the root object of a json.
+*/
+static CJLIB_ALWAYS_INLINE size_t cjlib_json_get_many
+(struct cjlib_json_data *restrict dst, const struct cjlib_json *restrict src,
+ const char *const *restrict keys, size_t keys_s)
+{
+    return cjlib_json_object_get_many(dst, src->c_dict, keys, keys_s);
+}
+
+/**
+ * The same as cjlib_json_object_ref, on the root object of a json.
+*/
+static CJLIB_ALWAYS_INLINE const struct cjlib_json_data *cjlib_json_ref
+(const struct cjlib_json *restrict src, const char *restrict key)
+{
+    return cjlib_json_object_ref(src->c_dict, key);
+}
+
+/**
+ * The same as cjlib_json_object_ref_mut, on the root object of a json.
+*/
+static CJLIB_ALWAYS_INLINE struct cjlib_json_data *cjlib_json_ref_mut
+(struct cjlib_json *restrict src, const char *restrict key)
+{
+    return cjlib_json_object_ref_mut(src->c_dict, key);
+}
+
+/**
+ * The same as cjlib_json_set, with a key handle (see cjlib_json_key_make).
+*/
+static CJLIB_ALWAYS_INLINE int cjlib_json_set_k
+(struct cjlib_json *restrict src, const cjlib_json_key_t *restrict key,
+ struct cjlib_json_data *restrict value, enum cjlib_json_datatypes datatype)
+{
+    return cjlib_json_object_set_k(&src->c_dict, key, value, datatype);
+}
+
+/**
+ * The same as cjlib_json_get, with a key handle (see cjlib_json_key_make).
+*/
+static CJLIB_ALWAYS_INLINE int cjlib_json_get_k
+(struct cjlib_json_data *restrict dst, const struct cjlib_json *restrict src,
+ const cjlib_json_key_t *restrict key)
+{
+    return cjlib_json_object_get_k(dst, src->c_dict, key);
+}
+
 /**
  * This function removes the data associated with the key.
  *
@@ -468,6 +882,51 @@ extern void cjlib_json_close(struct cjlib_json *restrict src);
 */
 extern int cjlib_json_read(struct cjlib_json *restrict dst);
 
+/**
+ * This function empties a json, to parse another one into it (e.g., one for each request),
+ * without returning its memory to the allocator. The blocks of the json, up to
+ * CJLIB_MEMORY_SPARE_MAX bytes, are kept and the next parsing into the json takes its
+ * blocks from them, before it asks the allocator. Thus a json of the same shape asks the
+ * allocator only for the blocks larger than CJLIB_MEMORY_SPARE_MAX (e.g., the table of a
+ * large object) and for the strings of the values that are not kept in the value (see
+ * CJLIB_STRING), which are always allocated by malloc. The blocks are freed by
+ * cjlib_json_destroy. The file of the json (if any) is rewound, thus cjlib_json_read
+ * reads it again, while the path, the backend and the cache of the json remain the same.
+ *
+ * @param src The json.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_reset(struct cjlib_json *restrict src);
+
+/**
+ * This function parses a json stored in memory. The parsing does not depend on any
+ * global state, thus any number of jsons can be parsed at the same time.
+ *
+ * @param dst Where to put all the information's about the json (initialized by cjlib_json_init).
+ * @param src The json.
+ * @param src_s The size of the json.
+ * @return 0 on success, otherwise -1 (the error is retrieved by cjlib_json_get_error).
+*/
+extern int cjlib_json_parse(struct cjlib_json *restrict dst, const char *restrict src, size_t src_s);
+
+/**
+ * This function parses a batch of jsons on a pool of threads. Every thread starts with an equal
+ * share of the inputs and, when it runs out of them, steals the half of the inputs left to another
+ * thread. The jsons that are read from a file keep their path (thus they can be dumped), but the
+ * file is not left open.
+ *
+ * @param dst An array of src_s jsons, one for each input. They are initialized by this function (even
+ * when it fails), and each one must be freed (cjlib_json_close) even if its parsing failed.
+ * @param errors An array of src_s errors, where the error of each input is stored (can be NULL).
+ * @param src The inputs.
+ * @param src_s The number of inputs.
+ * @param threads The number of threads to use (0 for one for each online processor).
+ * @return 0 if every input is parsed, otherwise -1.
+*/
+extern int cjlib_json_parse_many
+(struct cjlib_json *restrict dst, struct cjlib_json_error *restrict errors,
+ const struct cjlib_json_source *restrict src, size_t src_s, size_t threads);
+
 /**
  * This function make a json file to string.
  *
@@ -477,11 +936,484 @@ extern int cjlib_json_read(struct cjlib_json *restrict dst);
 */
 extern const char *cjlib_json_object_stringtify(const cjlib_json_object *src);
 
-static inline const char *cjlib_json_stringtify(struct cjlib_json *src)
+/**
+ * This function make a json file to string. When the cache is enabled (see cjlib_json_cache_fragments),
+ * only the objects/arrays that changed since the previous serialization are serialized again, and
+ * the ones that are serialized are stored in the cache. Thus, while the cache is enabled, the
+ * serialization changes @src (despite const) and must not run at the same time as any other use of
+ * the same json, including another serialization. The same holds for cjlib_json_serialized_size and
+ * cjlib_json_serialize. The cjlib_json_object_* serializations never use the cache.
+ *
+ * @param src The json.
+ * @return on success, a pointer at the start of a string that represent the string version
+ * of the given json file. Otherwise, null.
+*/
+extern const char *cjlib_json_stringtify(const struct cjlib_json *src);
+
+/**
+ * This function calculates the exact size of the compact serialization of a json
+ * object (as produced by cjlib_json_object_serialize), without producing it.
+ *
+ * @param src The json object.
+ * @return The size of the serialization in bytes (the '\0' is not included). On failure, 0.
+*/
+extern size_t cjlib_json_object_serialized_size(const cjlib_json_object *src);
+
+extern size_t cjlib_json_serialized_size(const struct cjlib_json *src);
+
+/**
+ * This function writes the compact serialization of a json object into a buffer
+ * provided by the caller, e.g., of the size returned by cjlib_json_object_serialized_size.
+ * No memory is allocated for the output and no '\0' is written at the end.
+ *
+ * @param dst The buffer in which the serialization is written.
+ * @param dst_s The size of the buffer.
+ * @param src The json object.
+ * @return The number of bytes written on success. Otherwise (e.g., the buffer is too small), 0.
+*/
+extern size_t cjlib_json_object_serialize(char *restrict dst, size_t dst_s, const cjlib_json_object *src);
+
+extern size_t cjlib_json_serialize(char *restrict dst, size_t dst_s, const struct cjlib_json *src);
+
+/**
+ * This function enables (or disables) the caching of the serialization of the objects/arrays
+ * of a json. While enabled, every serialization of the json (e.g., cjlib_json_dump) serializes
+ * again only the objects/arrays that changed (cjlib_json_object_set, cjlib_json_object_remove,
+ * cjlib_json_array_append) since the previous one, the rest are copied from the cache.
+ * Disabling the cache frees the memory it holds. While enabled, the serializations of the json
+ * are no longer read-only (see cjlib_json_stringtify), a frozen json is never cached.
+ *
+ * @param src The json.
+ * @param enable Whether to enable the cache.
+*/
+extern void cjlib_json_cache_fragments(struct cjlib_json *restrict src, bool enable);
+
+/**
+ * This function selects the data structure that holds the entries of an object. The
+ * hash table (CJLIB_DICT_HASH) gives faster lookups on objects with many keys, the AVL
+ * tree (CJLIB_DICT_AVL) uses less memory and the B-tree (CJLIB_DICT_BTREE) keeps the
+ * entries sorted by their key (e.g., for cjlib_json_object_stringtify). With
+ * CJLIB_DICT_AUTO, the default, the object starts as a flat array (CJLIB_DICT_FLAT),
+ * moves to the AVL tree once it has more than CJLIB_DICT_FLAT_SIZE keys and to the hash
+ * table once it has more than CJLIB_DICT_HASH_THRESHOLD keys. It does not move back when
+ * keys are removed.
+ *
+ * @param src The object.
+ * @param backend The backend.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_object_set_backend(cjlib_json_object *src, enum cjlib_dict_backend backend);
+
+/**
+ * This function selects the backend (see cjlib_json_object_set_backend) of every object
+ * of a json, including the objects that are parsed into it later on.
+ *
+ * @param src The json.
+ * @param backend The backend.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_set_backend(struct cjlib_json *restrict src, enum cjlib_dict_backend backend);
+
+/**
+ * This function calculates the memory that an object takes, along with every value in it, broken
+ * down by the kind of each block (see cjlib_json_memory). Every block is visited, thus the sizes
+ * are exact rather than estimated, but the call takes as long as a walk over the whole object.
+ * The blocks that the object shares with others (e.g., the versions of a persistent object) are
+ * counted in each one of them.
+ *
+ * @param dst Where to store the memory of the object.
+ * @param src The object.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_object_memory_usage(struct cjlib_json_memory *restrict dst, const cjlib_json_object *src);
+
+/**
+ * This function calculates the memory that a json takes (see cjlib_json_object_memory_usage).
+ *
+ * @param dst Where to store the memory of the json.
+ * @param src The json.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_memory_usage(struct cjlib_json_memory *restrict dst, const struct cjlib_json *restrict src);
+
+/**
+ * This function makes an object, and every object/array in it, read-only. The entries of
+ * each object are moved to a single block, laid out for searching (see cjlib_dict_freeze),
+ * and every function that would change a frozen object/array fails. Values reached through
+ * the iterators must not be changed either.
+ *
+ * @param src The object.
+ * @return 0 on success, otherwise -1 (some objects may be frozen already).
+*/
+extern int cjlib_json_object_freeze(cjlib_json_object *src);
+
+/**
+ * This function makes a json read-only (see cjlib_json_object_freeze). Its serializations are
+ * no longer cached, thus nothing is written on a read and any number of threads can read the
+ * json at the same time, without locking.
+ *
+ * @param src The json.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_freeze(struct cjlib_json *restrict src);
+
+/**
+ * cjlib_json_object_is_frozen checks whether an object is read-only (see cjlib_json_object_freeze).
+ */
+static inline bool cjlib_json_object_is_frozen(const cjlib_json_object *src)
+{
+    return CJLIB_DICT_FROZEN == src->d_backend;
+}
+
+/**
+ * This function makes an object, and every object/array in it, persistent. A persistent object is
+ * never changed in place: cjlib_json_object_set and cjlib_json_object_remove leave it as it was and
+ * give a new version of it, which shares every unchanged entry with the previous one (only the
+ * O(log n) nodes on the path to the changed key are copied, see cjlib_dict_persist). The values set
+ * on a persistent object are made persistent as well, while the arrays are frozen and shared as a
+ * whole. Each version is freed on its own (cjlib_dict_destroy), in any order, but the versions of
+ * an object must not be changed or freed by two threads at the same time.
+ *
+ * @param src The object.
+ * @return 0 on success, otherwise -1 (some objects may be persistent already, e.g., a frozen
+ * object in @src fails).
+*/
+extern int cjlib_json_object_persist(cjlib_json_object *src);
+
+/**
+ * This function makes a json persistent (see cjlib_json_object_persist), thus cjlib_json_set and
+ * cjlib_json_remove replace its root with a new version. The previous versions of the root belong
+ * to the caller, who keeps them (e.g., for a rollback) for as long as required.
+ *
+ * @param src The json.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_persist(struct cjlib_json *restrict src);
+
+/**
+ * cjlib_json_object_is_persistent checks whether an object is persistent (see cjlib_json_object_persist).
+ */
+static inline bool cjlib_json_object_is_persistent(const cjlib_json_object *src)
 {
-    return cjlib_json_object_stringtify(src->c_dict);
+    return CJLIB_DICT_PERSISTENT == src->d_backend;
 }
 
+/**
+ * This function initializes a handle, its first version is an empty json.
+ *
+ * @param dst The handle.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_handle_init(struct cjlib_json_handle *restrict dst);
+
+/**
+ * This function frees a handle and its current version. No thread may be reading it.
+ *
+ * @param src The handle.
+*/
+extern void cjlib_json_handle_destroy(struct cjlib_json_handle *restrict src);
+
+/**
+ * This function parses a new version of the json of a handle and makes it the current one.
+ * The readers are never blocked: the ones that entered before the swap keep reading the old
+ * version, which is freed once all of them have left (the calling thread waits for that).
+ * Each version is frozen (see cjlib_json_freeze), since the readers share it.
+ *
+ * @param src The handle.
+ * @param json The input of the new version (either a file or a json stored in memory).
+ * @return 0 on success, otherwise -1 (the error is retrieved by cjlib_json_get_error), then
+ * the current version remains.
+*/
+extern int cjlib_json_reload(struct cjlib_json_handle *restrict src, const struct cjlib_json_source *restrict json);
+
+/**
+ * cjlib_json_watch_routine receives a new version of a watched json (see cjlib_json_watch). The
+ * routine takes the json over: it frees it (cjlib_json_close) or moves it elsewhere (e.g.,
+ * cjlib_json_handle_publish) before it returns. The json is NULL when the watcher fails to
+ * wait for the changes of the file, then no other version is received (see cjlib_json_unwatch).
+ */
+typedef void (*cjlib_json_watch_routine)(struct cjlib_json *restrict json, void *arg);
+
+struct cjlib_json_watcher;
+
+/**
+ * This function watches the file of a json (see cjlib_json_open) for changes, using inotify. On a
+ * change, the file is read on a thread of the watcher and, if its contents differ from the ones
+ * read last, it is parsed and passed to @routine (on the same thread). Contents that are not a
+ * valid json are skipped.
+ *
+ * @param dst Where to store the watcher.
+ * @param src The json, it holds the path to the file.
+ * @param routine The routine that receives each new version.
+ * @param arg The argument to pass to @routine.
+ * @return 0 on success, otherwise -1.
+*/
+extern int cjlib_json_watch
+(struct cjlib_json_watcher **dst, const struct cjlib_json *restrict src,
+ cjlib_json_watch_routine routine, void *arg);
+
+/**
+ * This function stops and frees a watcher (it waits for a running @routine to return).
+ *
+ * @param src The watcher.
+ * @return 0 on success, otherwise -1 (the watcher had stopped on an error, see cjlib_json_watch_routine).
+*/
+extern int cjlib_json_unwatch(struct cjlib_json_watcher *src);
+
+/**
+ * This function makes a json, that is already parsed, the current version of a handle (see
+ * cjlib_json_reload).
+ *
+ * @param src The handle.
+ * @param json The new version, the handle takes it over (it is left empty) on success.
+ * @return 0 on success, otherwise -1 (the json still belongs to the caller, but it may be frozen).
+*/
+extern int cjlib_json_handle_publish(struct cjlib_json_handle *restrict src, struct cjlib_json *restrict json);
+
+/**
+ * cjlib_json_handle_enter starts reading the current version of a handle. The version
+ * is not freed before the matching cjlib_json_handle_leave. Neither call blocks.
+ *
+ * @param src The handle.
+ * @param epoch Where to store the ticket to pass to cjlib_json_handle_leave.
+ * @return The current version.
+ */
+static inline const struct cjlib_json *cjlib_json_handle_enter
+(struct cjlib_json_handle *restrict src, unsigned int *restrict epoch)
+{
+    unsigned int curr;
+
+    while (true) {
+        curr = atomic_load(&src->h_epoch);
+        atomic_fetch_add(&src->h_readers[curr & 1], 1);
+        if (curr == atomic_load(&src->h_epoch)) break;
+        // A reload started in between and it may not wait for this reader, try again.
+        atomic_fetch_sub(&src->h_readers[curr & 1], 1);
+    }
+
+    *epoch = curr;
+    return atomic_load(&src->h_current);
+}
+
+/**
+ * cjlib_json_handle_leave stops reading the version given by cjlib_json_handle_enter.
+ *
+ * @param src The handle.
+ * @param epoch The ticket of cjlib_json_handle_enter.
+ */
+static inline void cjlib_json_handle_leave(struct cjlib_json_handle *restrict src, unsigned int epoch)
+{
+    atomic_fetch_sub(&src->h_readers[epoch & 1], 1);
+}
+
+/**
+ * cjlib_json_tape is a json kept as a single array of 64-bit words, the tape, instead of objects
+ * and arrays. The values are written in the order they appear in the text, the root one at
+ * position 0, and each word has its tag (see cjlib_json_tape_tags) in its top 8 bits. A number
+ * takes a second word with the bits of its double. A string or key points in t_strings, where it
+ * is kept as its length (4 bytes), its bytes and a '\0'. The start of an object/array holds the
+ * position of its end and the number of its members, thus a whole value is skipped at once (see
+ * cjlib_json_tape_skip): the members of a container begin right after its start, each one
+ * following the previous, and each member of an object is its key followed by its value.
+ */
+struct cjlib_json_tape
+{
+    uint64_t *t_words;  /* Represents the words of the tape. */
+    size_t t_words_s;   /* Represents the number of words. */
+    char *t_strings;    /* Represents the strings and the keys. */
+    size_t t_strings_s; /* Represents the size of t_strings. */
+};
+
+/**
+ * cjlib_json_tape_tags enumeration lists the tags of the words of a tape.
+ */
+enum cjlib_json_tape_tags
+{
+    CJLIB_TAPE_OBJECT     = '{', /* The start of an object, see CJLIB_TAPE_END and CJLIB_TAPE_COUNT. */
+    CJLIB_TAPE_OBJECT_END = '}', /* The end of an object, the payload is the position of its start. */
+    CJLIB_TAPE_ARRAY      = '[', /* The start of an array, see CJLIB_TAPE_END and CJLIB_TAPE_COUNT. */
+    CJLIB_TAPE_ARRAY_END  = ']', /* The end of an array, the payload is the position of its start. */
+    CJLIB_TAPE_KEY        = ':', /* The key of a member, the payload is its offset in t_strings. */
+    CJLIB_TAPE_STRING     = '"', /* A string, the payload is its offset in t_strings. */
+    CJLIB_TAPE_NUMBER     = 'd', /* A number, the next word holds the bits of its double. */
+    CJLIB_TAPE_TRUE       = 't', /* The true boolean. */
+    CJLIB_TAPE_FALSE      = 'f', /* The false boolean. */
+    CJLIB_TAPE_NULL       = 'n'  /* The null. */
+};
+
+#define CJLIB_TAPE_TAG(WORD)     ((unsigned int) ((WORD) >> 56))
+#define CJLIB_TAPE_PAYLOAD(WORD) ((WORD) & 0x00FFFFFFFFFFFFFFULL)
+// The position of the end of an object/array, kept in the low 32 bits of its start.
+#define CJLIB_TAPE_END(WORD)     ((size_t) ((WORD) & 0xFFFFFFFFULL))
+// The number of members of an object/array, kept in the 24 bits of its start above CJLIB_TAPE_END.
+#define CJLIB_TAPE_COUNT(WORD)   ((size_t) (CJLIB_TAPE_PAYLOAD(WORD) >> 32))
+// The number of members past which CJLIB_TAPE_COUNT stays the same (they are counted one by one).
+#define CJLIB_TAPE_COUNT_MAX     (0xFFFFFF)
+
+/**
+ * cjlib_json_tape_type retrieves the datatype of the value at a position of a tape (a key is a string).
+ */
+static inline enum cjlib_json_datatypes cjlib_json_tape_type(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    switch (CJLIB_TAPE_TAG(src->t_words[at])) {
+        case CJLIB_TAPE_OBJECT:
+            return CJLIB_OBJECT;
+        case CJLIB_TAPE_ARRAY:
+            return CJLIB_ARRAY;
+        case CJLIB_TAPE_NUMBER:
+            return CJLIB_NUMBER;
+        case CJLIB_TAPE_TRUE:
+        case CJLIB_TAPE_FALSE:
+            return CJLIB_BOOLEAN;
+        case CJLIB_TAPE_NULL:
+            return CJLIB_NULL;
+        default:
+            return CJLIB_STRING;
+    }
+}
+
+/**
+ * cjlib_json_tape_skip finds the position right after the value (or key) at a position of a tape.
+ */
+static inline size_t cjlib_json_tape_skip(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    switch (CJLIB_TAPE_TAG(src->t_words[at])) {
+        case CJLIB_TAPE_OBJECT:
+        case CJLIB_TAPE_ARRAY:
+            return CJLIB_TAPE_END(src->t_words[at]) + 1;
+        case CJLIB_TAPE_NUMBER:
+            return at + 2;
+        default:
+            return at + 1;
+    }
+}
+
+/**
+ * cjlib_json_tape_size retrieves the number of members of the object/array at a position of a tape.
+ */
+static inline size_t cjlib_json_tape_size(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    size_t end  = CJLIB_TAPE_END(src->t_words[at]);
+    size_t size = CJLIB_TAPE_COUNT(src->t_words[at]);
+
+    if (CJLIB_BRANCH_LIKELY(size < CJLIB_TAPE_COUNT_MAX)) return size;
+
+    size = 0;
+    for (at = at + 1; at < end; at = cjlib_json_tape_skip(src, at)) {
+        if (CJLIB_TAPE_KEY == CJLIB_TAPE_TAG(src->t_words[at])) at++;
+        size++;
+    }
+    return size;
+}
+
+/**
+ * cjlib_json_tape_number retrieves the number at a position of a tape.
+ */
+static inline cjlib_json_num cjlib_json_tape_number(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    cjlib_json_num number;
+    (void) memcpy(&number, &src->t_words[at + 1], sizeof(cjlib_json_num));
+    return number;
+}
+
+/**
+ * cjlib_json_tape_bool retrieves the boolean at a position of a tape.
+ */
+static inline cjlib_json_bool cjlib_json_tape_bool(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    return CJLIB_TAPE_TRUE == CJLIB_TAPE_TAG(src->t_words[at]);
+}
+
+/**
+ * cjlib_json_tape_string retrieves the string (or key) at a position of a tape, which is kept by the tape.
+ */
+static inline const char *cjlib_json_tape_string(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    return src->t_strings + CJLIB_TAPE_PAYLOAD(src->t_words[at]) + sizeof(uint32_t);
+}
+
+/**
+ * cjlib_json_tape_string_size retrieves the length of the string (or key) at a position of a tape,
+ * which may have '\0' in it (decoded from \u0000).
+ */
+static inline size_t cjlib_json_tape_string_size(const struct cjlib_json_tape *restrict src, size_t at)
+{
+    uint32_t size;
+    (void) memcpy(&size, src->t_strings + CJLIB_TAPE_PAYLOAD(src->t_words[at]), sizeof(uint32_t));
+    return (size_t) size;
+}
+
+/**
+ * This function parses a json stored in memory into a tape. The tape is written front to back as
+ * the json is read, thus it takes a few allocations, instead of one for every value. Any value can
+ * be the root of the json. The parsing does not depend on any global state, thus any number of
+ * jsons can be parsed at the same time.
+ *
+ * @param dst Where to store the tape (freed by cjlib_json_tape_destroy, only on success).
+ * @param src The json.
+ * @param src_s The size of the json.
+ * @return 0 on success, otherwise -1 (the error is retrieved by cjlib_json_get_error).
+*/
+extern int cjlib_json_tape_parse(struct cjlib_json_tape *restrict dst, const char *restrict src, size_t src_s);
+
+/**
+ * This function frees the memory of a tape.
+ *
+ * @param src The tape.
+*/
+extern void cjlib_json_tape_destroy(struct cjlib_json_tape *restrict src);
+
+/**
+ * This function finds the value associated with a key, in the same manner as cjlib_json_object_get.
+ * The members are searched one after the other, each value being skipped at once.
+ *
+ * @param dst Where to store the position of the value.
+ * @param src The tape.
+ * @param object The position of the object.
+ * @param key The key (if the object has it more than once, its first member is found).
+ * @return 0 on success, otherwise -1 (there is no such key, or there is no object at @object).
+*/
+extern int cjlib_json_tape_object_get
+(size_t *restrict dst, const struct cjlib_json_tape *restrict src, size_t object, const char *restrict key);
+
+/**
+ * This function finds an element of an array, in the same manner as cjlib_json_array_get.
+ *
+ * @param dst Where to store the position of the element.
+ * @param src The tape.
+ * @param array The position of the array.
+ * @param index The index of the element.
+ * @return 0 on success, otherwise -1 (there is no such element, or there is no array at @array).
+*/
+extern int cjlib_json_tape_array_get(size_t *restrict dst, const struct cjlib_json_tape *restrict src, size_t array, int index);
+
+/**
+ * This function calculates the size of the serialization of a tape (see cjlib_json_tape_serialize).
+ *
+ * @param src The tape.
+ * @return The size of the serialization, or 0 on failure.
+*/
+extern size_t cjlib_json_tape_serialized_size(const struct cjlib_json_tape *restrict src);
+
+/**
+ * This function writes a tape as a json, in its compact form (no white spaces). The tape is
+ * read once, from the front to the back.
+ *
+ * @param dst The buffer in which the json is written.
+ * @param dst_s The size of the buffer.
+ * @param src The tape.
+ * @return The number of bytes written, or 0 on failure (e.g., the buffer is too small).
+*/
+extern size_t cjlib_json_tape_serialize(char *restrict dst, size_t dst_s, const struct cjlib_json_tape *restrict src);
+
+/**
+ * This function make a tape to string.
+ *
+ * @param src The tape.
+ * @return on success, a pointer at the start of a string that represent the tape. Otherwise, null.
+*/
+extern const char *cjlib_json_tape_stringtify(const struct cjlib_json_tape *restrict src);
+
 /**
  * This function write back the contents of the json.
  * @param src The json to write back.
@@ -24,6 +24,12 @@
 #include <memory.h>
 #include <malloc.h>
 
+/**
+ * CJLIB_ERROR_FIELD_SIZE determines the size of the buffers that hold the name
+ * and the value of the property that caused an error (longer ones are truncated).
+ */
+#define CJLIB_ERROR_FIELD_SIZE (0x80)
+
 /**
  * cjlib_json_error_types enumeration list all the possible errors that can be
  * produced during the parsing of in a transaction between a JSON file.
@@ -42,18 +48,23 @@ enum cjlib_json_error_types
     INCOMPLETE_SQUARE_BRACKETS,   /* An array in the JSON file have no matching square brackets */
     INCOMPLETE_DOUBLE_QUOTES,     /* An entry in the JSON file have no matching double quotes. */
     MISSING_COMMA,                /* Two entries have no comma between. */
-    INVALID_NUMBER                /* An entry have an invalid number, maybe an ASCII character is placed. */
+    INVALID_NUMBER,               /* An entry have an invalid number, maybe an ASCII character is placed. */
+    IO_ERROR                      /* The JSON file could not be read. */
 };
 
+/**
+ * cjlib_json_error describes the last error. Each thread has its own error, thus
+ * no locking is required to report or retrieve one.
+ */
 struct cjlib_json_error
 {
-    char *c_property_name;                    /* The name of the property in which the error occurred. */
-    char *c_property_value;                   /* The value of the property in which the error occurred. */
-    enum cjlib_json_error_types c_error_code; /* A error code indicating the error. */
+    char c_property_name[CJLIB_ERROR_FIELD_SIZE];  /* The name of the property in which the error occurred. */
+    char c_property_value[CJLIB_ERROR_FIELD_SIZE]; /* The value of the property in which the error occurred. */
+    enum cjlib_json_error_types c_error_code;      /* A error code indicating the error. */
 };
 
 /**
- * cjlib_json_error_init Initializes the internal error structure.
+ * cjlib_json_error_init Initializes (clears) the error of the calling thread.
  *
  * @return An integer indicating whether the initialization were successfully. On success 0 is returend,
  * otherwise -1.
@@ -61,12 +72,13 @@ struct cjlib_json_error
 extern int cjlib_json_error_init(void);
 
 /**
- * cjlib_json_error_destroy Free's the memory allocated by the internal error structure.
+ * cjlib_json_error_destroy Clears the error of the calling thread.
  */
 extern void cjlib_json_error_destroy(void);
 
 /**
- * cjilb_setup_error creates a new error.
+ * cjilb_setup_error creates a new error for the calling thread. Nothing is allocated,
+ * the name and value are copied (and truncated if needed) in the buffers of the error.
  *
  * @param property_name The name of the property that cause the error, if available.
  * @param property_value The value of the property, if available.
@@ -78,8 +90,21 @@ extern void cjlib_setup_error
  enum cjlib_json_error_types error_code);
 
 /**
- * cjlib_json_get_error Retrieves the error stored in the internal
- * error structure.
+ * cjlib_make_error fills an error structure (e.g., the error of a parser) in the same way
+ * as cjlib_setup_error, without changing the error of the calling thread.
+ *
+ * @param dst The error structure to fill.
+ * @param property_name The name of the property that cause the error, if available.
+ * @param property_value The value of the property, if available.
+ * @param error_code Specifies which of the error listed in cjlib_json_error_types struct can represent the error
+ * with more detail.
+ */
+extern void cjlib_make_error
+(struct cjlib_json_error *restrict dst, const char *property_name,
+ const char *property_value, enum cjlib_json_error_types error_code);
+
+/**
+ * cjlib_json_get_error Retrieves the last error of the calling thread.
  *
  * @param dst A pointer to the memory area to copy the internal error.
  */
@@ -0,0 +1,164 @@
+/* File: cjlib_memory.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_MEMORY_H
+#define CJLIB_MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <malloc.h>
+
+/**
+ * CJLIB_MEMORY_CHUNK_HEADER determines the bytes that the allocator keeps in front of
+ * each block it gives (the size of the block), which are part of the memory in use.
+ */
+#define CJLIB_MEMORY_CHUNK_HEADER (sizeof(size_t))
+
+/**
+ * The blocks up to CJLIB_MEMORY_SPARE_MAX bytes are kept for reuse (see cjlib_json_reset),
+ * grouped in classes of CJLIB_MEMORY_SPARE_STEP bytes.
+ */
+#define CJLIB_MEMORY_SPARE_MAX  (0x400)
+#define CJLIB_MEMORY_SPARE_STEP (0x10)
+
+/**
+ * cjlib_json_memory describes the memory that a json takes (see cjlib_json_memory_usage).
+ * Each block is counted under one kind, by the bytes that were asked for it; what the
+ * allocator gives on top of them is counted in m_overhead.
+ */
+struct cjlib_json_memory
+{
+    size_t m_nodes;       /* The entries of the objects and the items of the arrays, along with their values. */
+    size_t m_keys;        /* The keys of the entries. */
+    size_t m_strings;     /* The strings that are not kept in their value (see c_inline), and the path. */
+    size_t m_containers;  /* The objects and arrays themselves, along with the tables/trees that index their entries. */
+    size_t m_fragments;   /* The cached serializations of the objects/arrays (see cjlib_json_cache_fragments). */
+    size_t m_spare;       /* The blocks that are kept for the next parsing (see cjlib_json_reset). */
+    size_t m_overhead;    /* The bytes the allocator adds to each block (its header and the rounding of its size). */
+    size_t m_allocations; /* The number of blocks. */
+    size_t m_total;       /* The sum of all the above bytes. */
+};
+
+/**
+ * cjlib_json_memory_counters describes the memory that the library holds, across every json
+ * (see cjlib_json_memory_counters). The strings of the values (and the paths) are not
+ * included: they may be allocated by the caller and handed over (see CJLIB_STRING), thus
+ * they are freed by free().
+ */
+struct cjlib_json_memory_counters
+{
+    size_t c_live_bytes;       /* The bytes of the blocks that are not freed yet (with their overhead). */
+    size_t c_live_allocations; /* The number of blocks that are not freed yet. */
+    size_t c_allocations;      /* The number of blocks allocated so far. */
+};
+
+/**
+ * cjlib_json_spare holds the blocks that a json freed, to be reused by the next parsing into
+ * it, instead of returning them to the allocator (see cjlib_json_reset).
+ */
+struct cjlib_json_spare
+{
+    void *s_bins[CJLIB_MEMORY_SPARE_MAX / CJLIB_MEMORY_SPARE_STEP + 2]; /* The blocks of each class, linked through their first bytes. */
+};
+
+/**
+ * cjlib_json_memory_counters_enable turns the global counters of the memory on or off. They
+ * are off by default, since they cost the allocation routines a few atomic operations; the
+ * counters are exact only for the blocks allocated and freed while they are on, thus they
+ * are better enabled before the first json.
+ *
+ * @param enable Whether to count.
+ * @return Whether the counters were on before.
+ */
+extern bool cjlib_json_memory_counters_enable(bool enable);
+
+/**
+ * cjlib_json_memory_counters retrieves the global counters of the memory of the library
+ * (all zero, unless they are enabled, see cjlib_json_memory_counters_enable).
+ *
+ * @param dst Where to store the counters.
+ */
+extern void cjlib_json_memory_counters(struct cjlib_json_memory_counters *restrict dst);
+
+/**
+ * The allocation routines of the library, the same as the ones of the standard library,
+ * which also keep the global counters, when enabled (see cjlib_json_memory_counters_enable). A block is freed
+ * by cjlib_free, only when it is allocated by one of the others, and the other way around.
+ */
+extern void *cjlib_malloc(size_t size);
+
+extern void *cjlib_calloc(size_t count, size_t size);
+
+extern void *cjlib_realloc(void *src, size_t size);
+
+extern void cjlib_free(void *src);
+
+extern char *cjlib_strdup(const char *src);
+
+/**
+ * cjlib_memory_spare_use makes the allocation routines of the calling thread take their blocks
+ * from the spare blocks of a json, when there is one of the right class, and give the blocks up
+ * to CJLIB_MEMORY_SPARE_MAX bytes back to it, instead of to the allocator.
+ *
+ * @param src The spare blocks (NULL to stop reusing blocks).
+ * @return The spare blocks that were used before.
+ */
+extern struct cjlib_json_spare *cjlib_memory_spare_use(struct cjlib_json_spare *src);
+
+/**
+ * cjlib_memory_spare_release frees the spare blocks of a json, along with @src itself.
+ *
+ * @param src The spare blocks (NULL frees nothing).
+ */
+extern void cjlib_memory_spare_release(struct cjlib_json_spare *src);
+
+/**
+ * cjlib_memory_spare_usage counts the spare blocks of a json, along with @src itself.
+ *
+ * @param dst The memory of the json.
+ * @param src The spare blocks (NULL counts nothing).
+ */
+extern void cjlib_memory_spare_usage(struct cjlib_json_memory *restrict dst, const struct cjlib_json_spare *src);
+
+/**
+ * cjlib_memory_account counts a block in the memory of a json.
+ *
+ * @param dst The memory of the json.
+ * @param kind The kind of the block (one of the fields of @dst).
+ * @param src The block (NULL counts nothing).
+ * @param size The bytes that were asked for the block.
+ */
+static inline void cjlib_memory_account
+(struct cjlib_json_memory *dst, size_t *kind, const void *src, size_t size)
+{
+    size_t usable;
+
+    if (NULL == src) return;
+
+    usable = malloc_usable_size((void *) src);
+    if (size > usable) size = usable;
+
+    *kind            += size;
+    dst->m_overhead  += usable - size + CJLIB_MEMORY_CHUNK_HEADER;
+    dst->m_total     += usable + CJLIB_MEMORY_CHUNK_HEADER;
+    dst->m_allocations++;
+}
+
+#endif
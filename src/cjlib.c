@@ -23,6 +23,12 @@
 #include <limits.h>
 #include <ctype.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
 
 #include "cjlib.h"
 #include "cjlib_error.h"
@@ -30,6 +36,8 @@
 #include "cjlib_stack.h"
 #include "cjlib_list.h"
 #include "cjlib_queue.h"
+#include "cjlib_dtoa.h"
+#include "cjlib_escape.h"
 
 #define DOUBLE_QUOTES         (0x22) // ASCII representative of "
 #define CURLY_BRACKETS_OPEN   (0x7B) // ASCII representative of {
@@ -39,12 +47,23 @@
 #define COMMMA                (0x2C) // ASCII representative of ,
 #define WHITE_SPACE           (0x20) // ASCII representative of ' '
 #define SEPERATOR             (0x3A) // ASCII representative of :
+#define BACKSLASH             (0x5C) // ASCII representative of \ (backslash)
 
 #define NEW_LINE              (0x0A) // ASCII representative of \n
 
 #define MEMORY_INIT_CHUNK     (0x3C) // Hex representative of 60.
 #define EXP_DOUBLE_QUOTES     (0x02) // Expected double quotes.
 
+#define SERIALIZER_FRAMES_CHUNK (0x10) // How many frames the serialization stack grows by.
+#define READ_FILE_CHUNK         (0x1000) // The initial size of the buffer in which a JSON file is read.
+#define PARSE_MANY_CACHE_LINE   (0x40) // The workers of cjlib_json_parse_many are kept on separate cache lines.
+#define WATCH_EVENTS_SIZE       (0x1000) // The size of the buffer in which the events of a watcher are read.
+
+// The range of inputs of a worker of cjlib_json_parse_many is packed in a single word.
+#define RANGE_PACK(HEAD, TAIL) (((uint64_t) (TAIL) << 32) | (uint64_t) (uint32_t) (HEAD))
+#define RANGE_HEAD(RANGE)      ((uint32_t) (RANGE))
+#define RANGE_TAIL(RANGE)      ((uint32_t) ((RANGE) >> 32))
+
 #define ROOT_PROPERTY_NAME    ("") // A name used to represent the beginning of the JSON. !NO OTHER PROPERTY MUST OBTAIN THIS NAME EXCEPT ROOT~
 
 
@@ -67,72 +86,128 @@ struct incomplete_property
     } i_data;
 };
 
+static inline void incomplete_property_init(struct incomplete_property *src)
+{
+    (void) memset(src, 0x0, sizeof(struct incomplete_property));
+}
+
 /**
- * Used to describe an incomplete object or array in the process
- * of stringtifing the object/array stored in the RAM
+ * The state of a parsing. The parser works only on this context (the JSON is
+ * read from memory), thus any number of JSONs can be parsed at the same time.
  */
-struct incomplete_property_str
-{
-    char *i_key; // The key of the current incomplete element.
-    char *i_state; // How much of the JSON stringtifying process is done for the incomplete data.
-    bool set_comma; // Determines whether to set commad when completing an object/array.
-    enum cjlib_json_datatypes i_type; // The type of the incompelte object (object or array)
-    struct cjlib_queue *i_pending_data_q; // The data that must be stored in the incomplete object (but not expanded yet).
-    union {
-        cjlib_json_object *object; // The incomplete data is an object.
-        cjlib_json_array *array;   // The incompelte data is an array.
-    } i_data;
+struct cjlib_parser
+{
+    const char *p_src;               // The JSON to parse.
+    size_t p_src_s;                  // The size of the JSON.
+    size_t p_pos;                    // The position of the next byte to read.
+    bool p_eof;                      // Whether a byte past the end of the JSON is requested.
+    struct cjlib_json_error p_error; // The error that stopped the parsing (if any).
 };
 
-static inline void incomplete_property_init(struct incomplete_property *src)
+static inline void parser_init(struct cjlib_parser *restrict parser, const char *src, size_t src_s)
 {
-    (void) memset(src, 0x0, sizeof(struct incomplete_property));
+    (void) memset(parser, 0x0, sizeof(struct cjlib_parser));
+    parser->p_src                = src;
+    parser->p_src_s              = src_s;
+    parser->p_error.c_error_code = NO_ERROR;
+}
+
+/**
+ * Reads the next byte of the JSON, in the same manner as fgetc.
+ *
+ * @param parser The state of the parsing.
+ * @return The next byte, or EOF (and sets p_eof) if the JSON is over.
+ */
+static CJLIB_ALWAYS_INLINE int parser_next_byte(struct cjlib_parser *restrict parser)
+{
+    if (CJLIB_BRANCH_UNLIKELY(parser->p_pos >= parser->p_src_s)) {
+        parser->p_eof = true;
+        return EOF;
+    }
+    return (unsigned char) parser->p_src[parser->p_pos++];
+}
+
+static CJLIB_ALWAYS_INLINE void parser_seek(struct cjlib_parser *restrict parser, size_t pos)
+{
+    parser->p_pos = pos;
+    parser->p_eof = false;
 }
 
-static inline void incomplete_property_str_init(struct incomplete_property_str *src) 
+static inline void parser_error
+(struct cjlib_parser *restrict parser, const char *p_name, const char *p_value,
+ enum cjlib_json_error_types err_code)
 {
-    (void) memset(src, 0x0, sizeof(struct incomplete_property_str));
+    cjlib_make_error(&parser->p_error, p_name, p_value, err_code);
 }
 
+static int persist_value(struct cjlib_json_data *restrict src);
+
 /**
- * Recieve the current active state of an object and expanded using
- * by storing the @data on the end of the @state.
+ * (change/set) a record of a persistent object, by making a new version of it.
  *
- * @param state The state of the incomplete data untill now.
- * @param data The data to add to the state.
- * @return The new state on success, otherwise NULL.
+ * @param src      A pointer to the object, the new version is stored there.
+ * @param key      The handle of the key of the record.
+ * @param value    The new value of the record, it is made persistent as well.
+ * @return 0 on success, otherwise -1.
  */
-static inline char *incomplete_property_str_expand_state
-(const char *state, const char *data, const char *key)
-{
-    size_t key_size = (NULL == key)? 0 : strlen(key);
-    size_t colon_len = 1;
-    char *new_state = (char *) malloc(strlen(state) + strlen(data) + key_size + colon_len + 1);
-    if (NULL == new_state) return NULL;
-    
-    if (NULL == key) {
-        (void) sprintf(new_state, "%s%s", state, data);
-    } else {
-        (void) sprintf(new_state, "%s%s:%s", state, key, data);
+static int object_set_version
+(cjlib_json_object **src, const struct cjlib_dict_key *restrict key, struct cjlib_json_data *restrict value)
+{
+    struct cjlib_fragment *value_fragment = cjlib_json_data_fragment(value);
+    cjlib_json_object *version;
+
+    if (-1 == persist_value(value) || -1 == cjlib_dict_set_version(&version, *src, key, value)) return -1;
+
+    // The value may be shared by several versions, thus it is linked to none of them.
+    if (NULL != value_fragment) value_fragment->f_parent = NULL;
+    *src = version;
+    return 0;
+}
+
+/**
+ * Completes the (change/set) of a record, after the dictionary is updated.
+ *
+ * @param src      The object.
+ * @param previous The previous value of the record.
+ * @param value    The new value of the record.
+ * @param status   The result of the upsert (1 if the record existed, 0 if it was inserted, -1 on failure).
+ * @return 0 on success, otherwise -1.
+ */
+static int object_set_complete
+(cjlib_json_object *restrict src, struct cjlib_json_data *restrict previous,
+ const struct cjlib_json_data *restrict value, int status)
+{
+    struct cjlib_fragment *value_fragment;
+
+    if (-1 == status) return -1;
+
+    // The previous value is released, unless the same string/object/array is set again.
+    if (1 == status && (previous->c_datatype != value->c_datatype || previous->c_value.c_str != value->c_value.c_str)) {
+        cjlib_json_data_destroy(previous);
     }
 
-    return new_state;
+    // Link the new object/array to its parent and let the cache know about the change.
+    value_fragment = cjlib_json_data_fragment(value);
+    if (NULL != value_fragment) value_fragment->f_parent = &src->d_fragment;
+    cjlib_fragment_invalidate(&src->d_fragment);
+    return 0;
 }
 
 int cjlib_json_object_set
 (cjlib_json_object **src, const char *restrict key,
  struct cjlib_json_data *restrict value, enum cjlib_json_datatypes datatype)
 {
-    struct cjlib_json_data dummy;
-
-    // Remove the previous contents (if exists).
-    (void) cjlib_json_object_remove(&dummy, src, key);
-    cjlib_json_data_destroy(&dummy);
+    struct cjlib_json_data previous;
+    struct cjlib_dict_key handle;
 
-    // (change/set) the record.
     value->c_datatype = datatype;
-    if (-1 == cjlib_dict_insert(value, src, key)) return -1;
-    return 0;
+    if (cjlib_json_object_is_persistent(*src)) {
+        cjlib_dict_key_make(&handle, key);
+        return object_set_version(src, &handle, value);
+    }
+
+    // (change/set) the record, the previous contents (if exists) are replaced in place.
+    return object_set_complete(*src, &previous, value, cjlib_dict_upsert(&previous, value, *src, key));
 }
 
 int cjlib_json_object_get
@@ -140,27 +215,101 @@ int cjlib_json_object_get
  const char *restrict key)
 {
     if (NULL == dst) return -1;
+    return cjlib_dict_search(dst, src, key);
+}
 
-    struct cjlib_json_data tmp;
-    cjlib_json_data_init(&tmp);
+const struct cjlib_json_data *cjlib_json_object_ref(const cjlib_json_object *restrict src, const char *restrict key)
+{
+    return cjlib_dict_lookup(src, key);
+}
 
-    if (-1 == cjlib_dict_search(&tmp, src, key)) return -1;
+struct cjlib_json_data *cjlib_json_object_ref_mut(cjlib_json_object *restrict src, const char *restrict key)
+{
+    // The values of a frozen/persistent object are never changed in place.
+    if (cjlib_json_object_is_frozen(src) || cjlib_json_object_is_persistent(src)) return NULL;
 
-    (void) memcpy(dst, &tmp, sizeof(struct cjlib_json_data));
-    return 0;
+    struct cjlib_json_data *data = cjlib_dict_lookup(src, key);
+
+    // The caller is about to change the value, thus the cached serialization gets stale.
+    if (NULL != data) cjlib_fragment_invalidate(&src->d_fragment);
+    return data;
+}
+
+size_t cjlib_json_object_get_many
+(struct cjlib_json_data *restrict dst, const cjlib_json_object *restrict src,
+ const char *const *restrict keys, size_t keys_s)
+{
+    if (NULL == dst) return 0;
+    return cjlib_dict_search_many(dst, src, keys, keys_s);
+}
+
+int cjlib_json_object_set_k
+(cjlib_json_object **src, const cjlib_json_key_t *restrict key,
+ struct cjlib_json_data *restrict value, enum cjlib_json_datatypes datatype)
+{
+    struct cjlib_json_data previous;
+
+    value->c_datatype = datatype;
+    if (cjlib_json_object_is_persistent(*src)) return object_set_version(src, key, value);
+
+    // (change/set) the record, the previous contents (if exists) are replaced in place.
+    return object_set_complete(*src, &previous, value, cjlib_dict_upsert_k(&previous, value, *src, key));
+}
+
+int cjlib_json_object_get_k
+(struct cjlib_json_data *restrict dst, const cjlib_json_object *restrict src,
+ const cjlib_json_key_t *restrict key)
+{
+    if (NULL == dst) return -1;
+    return cjlib_dict_search_k(dst, src, key);
+}
+
+const struct cjlib_json_data *cjlib_json_object_ref_k
+(const cjlib_json_object *restrict src, const cjlib_json_key_t *restrict key)
+{
+    return cjlib_dict_lookup_k(src, key);
+}
+
+struct cjlib_json_data *cjlib_json_object_ref_mut_k
+(cjlib_json_object *restrict src, const cjlib_json_key_t *restrict key)
+{
+    // The values of a frozen/persistent object are never changed in place.
+    if (cjlib_json_object_is_frozen(src) || cjlib_json_object_is_persistent(src)) return NULL;
+
+    struct cjlib_json_data *data = cjlib_dict_lookup_k(src, key);
+
+    // The caller is about to change the value, thus the cached serialization gets stale.
+    if (NULL != data) cjlib_fragment_invalidate(&src->d_fragment);
+    return data;
 }
 
 int cjlib_json_object_remove
 (struct cjlib_json_data *restrict dst, cjlib_json_object **src,
  const char *restrict key)
 {
+    cjlib_json_object *version;
+    struct cjlib_dict_key handle;
+
     // dst == NULL, then you can skip the return value.
     if (NULL == dst) goto perform_deletion;
 
     if (-1 == cjlib_json_object_get(dst, *src, key)) return -1;
 
 perform_deletion:
-    if (-1 == cjlib_dict_remove(src, key)) return -1;
+    if (cjlib_json_object_is_persistent(*src)) {
+        cjlib_dict_key_make(&handle, key);
+        if (-1 == cjlib_dict_remove_version(&version, *src, &handle)) return -1;
+
+        // The value still belongs to the previous version.
+        *src = version;
+        return 0;
+    }
+
+    if (-1 == cjlib_dict_remove(*src, key)) return -1;
+
+    // The removed object/array (if any) no longer belongs to this object.
+    if (NULL != dst && NULL != cjlib_json_data_fragment(dst)) cjlib_json_data_fragment(dst)->f_parent = NULL;
+    cjlib_fragment_invalidate(&(*src)->d_fragment);
 
     return 0;
 }
@@ -183,36 +332,63 @@ int cjlib_json_open
 void cjlib_json_close(struct cjlib_json *restrict src)
 {
     cjlib_json_destroy(src);
-    fclose(src->c_fp);
+    // The jsons of cjlib_json_parse_many do not keep their file open.
+    if (NULL != src->c_fp) (void) fclose(src->c_fp);
     (void) memset(src, 0x0, sizeof(struct cjlib_json));
- 
-    cjlib_json_error_destroy();
+}
+
+static CJLIB_ALWAYS_INLINE bool skip_digits(const char *restrict *src)
+{
+    if (!isdigit((unsigned char) **src)) return false;
+    while (isdigit((unsigned char) **src)) (*src)++;
+    return true;
 }
 
 static CJLIB_ALWAYS_INLINE bool is_number(const char *restrict src)
 {
-    while (*src) {
-        if (isalpha(*src) || isblank(*src)) return false;
+    // Follows the JSON grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    if ('-' == *src) src++;
+
+    if ('0' == *src) src++;
+    else if (!skip_digits(&src)) return false;
+
+    if ('.' == *src) {
         src++;
+        if (!skip_digits(&src)) return false;
     }
-    return true;
+
+    if ('e' == *src || 'E' == *src) {
+        src++;
+        if ('+' == *src || '-' == *src) src++;
+        if (!skip_digits(&src)) return false;
+    }
+
+    while (isspace((unsigned char) *src)) src++;
+    return '\0' == *src;
 }
 
-static CJLIB_ALWAYS_INLINE char *trim_double_quotes(const char *src)
+/**
+ * Copies a string without its double quotes, decoding its escape sequences. The names of the
+ * properties are temporary, the values become part of the json (always by malloc, since the
+ * caller may hand over its own strings as well, see CJLIB_STRING).
+ */
+static CJLIB_ALWAYS_INLINE char *trim_double_quotes(const char *src, void *(*allocate)(size_t size))
 {
-    char *tmp    = strdup(src);
-    size_t tmp_s = strlen(tmp);
+    size_t src_s = strlen(src);
+    char *tmp    = (char *) allocate(sizeof(char) * (src_s - 1));
     if (NULL == tmp) return NULL;
 
-    (void) memmove(tmp, tmp + 1, tmp_s);
-    tmp[tmp_s - 2] = '\0';
+    // Drop the double quotes and decode the escape sequences in between.
+    (void) cjlib_unescape(tmp, src + 1, src_s - 2);
 
-    return (char *) realloc(tmp, sizeof(char) * (tmp_s - 1));
+    return tmp;
 }
 
-static inline int type_decoder(struct cjlib_json_data *restrict dst, const char *p_name, const char *p_value)
+static inline int type_decoder
+(struct cjlib_parser *restrict parser, struct cjlib_json_data *restrict dst,
+ const char *p_name, const char *p_value)
 {
-    char *property_value = strdup(p_value);
+    char *property_value = cjlib_strdup(p_value);
     if (NULL == property_value) return -1;
 
     size_t property_len = strlen(property_value);
@@ -222,6 +398,8 @@ static inline int type_decoder(struct cjlib_json_data *restrict dst, const char
     struct cjlib_json_data property;
     enum cjlib_json_error_types err_code;
 
+    cjlib_json_data_init(&property);
+
     // build the data that is going to be inserted in the json.
     // The following if is required to find the problem in which a commma or a close bracket appeared on the end of a string.
     if (CURLY_BRACKETS_CLOSE == property_value[property_len - 1] || COMMMA == property_value[property_len - 1]
@@ -232,8 +410,14 @@ static inline int type_decoder(struct cjlib_json_data *restrict dst, const char
 
     if (DOUBLE_QUOTES == property_value[0] && DOUBLE_QUOTES == property_value[property_len - 1]) {
         // Check for "
-        value_type  = CJLIB_STRING;
-        value.c_str = trim_double_quotes(property_value);
+        value_type = CJLIB_STRING;
+        if (property_len - 2 < CJLIB_INLINE_STRING_SIZE) {
+            // A short string is kept in the data themselves, without allocating (the decoded one is never longer).
+            (void) cjlib_unescape(value.c_short, property_value + 1, property_len - 2);
+            property.c_inline = true;
+        } else {
+            value.c_str = trim_double_quotes(property_value, &malloc);
+        }
     } else if (!strcmp(property_value, "true") || !strcmp(property_value, "false")) {
         value_type      = CJLIB_BOOLEAN;
         value.c_boolean = (!strcmp(property_value, "true")) ? true : false;
@@ -252,45 +436,47 @@ static inline int type_decoder(struct cjlib_json_data *restrict dst, const char
     if (value_type == CJLIB_NUMBER && (LONG_MAX == value.c_num || LONG_MIN == value.c_num)) {
         err_code = INVALID_NUMBER;
         goto type_decoder_err;
-        free(property_value);
+        cjlib_free(property_value);
         return -1;
     }
     property.c_datatype = value_type;
     property.c_value    = value;
 
     (void) memcpy(dst, &property, sizeof(struct cjlib_json_data));
-    free(property_value);
+    cjlib_free(property_value);
     return 0;
 
 type_decoder_err:
-    if (NULL == p_name) cjlib_setup_error("", p_value, err_code);
-    else cjlib_setup_error(p_name, p_value, err_code);
+    if (NULL == p_name) parser_error(parser, "", p_value, err_code);
+    else parser_error(parser, p_name, p_value, err_code);
 
+    cjlib_free(property_value);
     return -1;
 }
 
-static char *parse_property_name(const struct cjlib_json *restrict src)
+static char *parse_property_name(struct cjlib_parser *restrict parser)
 {
     unsigned char curr_byte;
     int double_quotes_c  = 0;
-    long retreat_pos = ftell(src->c_fp); // In case of retread, restore the file position.
+    size_t retreat_pos   = parser->p_pos; // In case of retread, restore the position.
     bool found_seperator = false;
+    bool escaped         = false;
 
     size_t p_name_init_s = MEMORY_INIT_CHUNK;
     size_t p_name_s      = 0;
 
-    char *p_name = (char *) malloc(sizeof(char) * p_name_init_s);
+    char *p_name = (char *) cjlib_malloc(sizeof(char) * p_name_init_s);
     if (NULL == p_name) {
-        cjlib_setup_error("", "", MEMORY_ERROR);
+        parser_error(parser, "", "", MEMORY_ERROR);
         return NULL;
     }
 
     do {
-        curr_byte = (unsigned char) fgetc(src->c_fp);
-        if (feof(src->c_fp)) {
+        curr_byte = (unsigned char) parser_next_byte(parser);
+        if (parser->p_eof) {
             p_name[p_name_s] = '\0';
-            cjlib_setup_error(p_name, "", INVALID_PROPERTY);
-            free(p_name);
+            parser_error(parser, p_name, "", INVALID_PROPERTY);
+            cjlib_free(p_name);
             return NULL;
         }
 
@@ -302,9 +488,9 @@ static char *parse_property_name(const struct cjlib_json *restrict src)
              SQUARE_BRACKETS_OPEN  == curr_byte ||
              SQUARE_BRACKETS_CLOSE == curr_byte) && 0 == double_quotes_c) {
             // Retreat!!, THIS is a name (not always an error)
-            fseek(src->c_fp, retreat_pos, SEEK_SET);
-            free(p_name);
-            return strdup("");
+            parser_seek(parser, retreat_pos);
+            cjlib_free(p_name);
+            return cjlib_strdup("");
         }
 
         // Check fof :
@@ -312,21 +498,22 @@ static char *parse_property_name(const struct cjlib_json *restrict src)
 
         if (EXP_DOUBLE_QUOTES == double_quotes_c && !found_seperator) {
             p_name[p_name_s] = '\0';
-            cjlib_setup_error(p_name, "", MISSING_SEPERATOR);
-            free(p_name);
+            parser_error(parser, p_name, "", MISSING_SEPERATOR);
+            cjlib_free(p_name);
             return NULL;
         }
 
-        // Check for "
-        if (DOUBLE_QUOTES == curr_byte) ++double_quotes_c;
+        // Check for " (an escaped one belongs to the name).
+        if (DOUBLE_QUOTES == curr_byte && !escaped) ++double_quotes_c;
+        escaped = (1 == double_quotes_c && BACKSLASH == curr_byte && !escaped);
 
         if (double_quotes_c > 0) {
             p_name[p_name_s++] = curr_byte;
             if ((p_name_s + 1) == p_name_init_s) {
                 p_name_init_s += MEMORY_INIT_CHUNK;
-                p_name = (char *) realloc(p_name, sizeof(char) * p_name_init_s);
+                p_name = (char *) cjlib_realloc(p_name, sizeof(char) * p_name_init_s);
                 if (NULL == p_name) {
-                    cjlib_setup_error("", "", MEMORY_ERROR);
+                    parser_error(parser, "", "", MEMORY_ERROR);
                     return NULL;
                 }
             }
@@ -335,37 +522,25 @@ static char *parse_property_name(const struct cjlib_json *restrict src)
         if (EXP_DOUBLE_QUOTES == double_quotes_c && found_seperator) break;
         if (found_seperator) {
             p_name[p_name_s] = '\0';
-            cjlib_setup_error(p_name, "", INCOMPLETE_DOUBLE_QUOTES);
-            free(p_name);
+            parser_error(parser, p_name, "", INCOMPLETE_DOUBLE_QUOTES);
+            cjlib_free(p_name);
             return NULL;
         }
     } while (1);
     p_name[p_name_s - 1] = '\0'; // -1, to not include the seperator.
 
-    p_name = (char *) realloc(p_name, sizeof(char) * p_name_s);
-    if (NULL == p_name) cjlib_setup_error("", "", MEMORY_ERROR);
+    p_name = (char *) cjlib_realloc(p_name, sizeof(char) * p_name_s);
+    if (NULL == p_name) parser_error(parser, "", "", MEMORY_ERROR);
 
     return p_name;
 }
 
-static inline int next_is_end_of_file(FILE *restrict file_ptr)
+static CJLIB_ALWAYS_INLINE bool next_is_end_of_file(const struct cjlib_parser *restrict parser)
 {
-    long restore_pos = ftell(file_ptr);
-    unsigned char curr_byte;
-
-    if (-1 == restore_pos) return -1;
-
-    curr_byte = fgetc(file_ptr);
-    (void) curr_byte;
-
-    if (-1 == fseek(file_ptr, restore_pos, SEEK_SET)) return -1; // Reset the file offset.
-
-    if (feof(file_ptr)) return true;
-
-    return false;
+    return parser->p_pos >= parser->p_src_s;
 }
 
-static char *parse_property_value(const struct cjlib_json *restrict src, const char *p_name)
+static char *parse_property_value(struct cjlib_parser *restrict parser, const char *p_name)
 {
     unsigned char curr_byte;
     int double_quotes_c = 0;
@@ -373,9 +548,9 @@ static char *parse_property_value(const struct cjlib_json *restrict src, const c
     size_t p_value_init_s = MEMORY_INIT_CHUNK;
     size_t p_value_s      = 0;
 
-    char *p_value = (char *) malloc(sizeof(char) * p_value_init_s);
+    char *p_value = (char *) cjlib_malloc(sizeof(char) * p_value_init_s);
     if (NULL == p_value) {
-        cjlib_setup_error(p_name, "", MEMORY_ERROR);
+        parser_error(parser, p_name, "", MEMORY_ERROR);
         return NULL;
     }
 
@@ -383,13 +558,14 @@ static char *parse_property_value(const struct cjlib_json *restrict src, const c
     bool is_object  = false;
     bool is_array   = false;
     bool type_found = false;
+    bool escaped    = false;
 
     do {
-        curr_byte = (unsigned char) fgetc(src->c_fp);
-        if (feof(src->c_fp)) {
+        curr_byte = (unsigned char) parser_next_byte(parser);
+        if (parser->p_eof) {
             p_value[p_value_s] = '\0';
-            cjlib_setup_error(p_name, p_value, INVALID_PROPERTY);
-            free(p_value);
+            parser_error(parser, p_name, p_value, INVALID_PROPERTY);
+            cjlib_free(p_value);
             return NULL;
         }
         if (WHITE_SPACE == curr_byte && !is_string) continue; // Check for ' '
@@ -401,31 +577,32 @@ static char *parse_property_value(const struct cjlib_json *restrict src, const c
         else if (CURLY_BRACKETS_OPEN == curr_byte && !type_found) is_object = type_found = true; // Check for {
         else if (SQUARE_BRACKETS_OPEN == curr_byte && !type_found) is_array = type_found = true; // Check for [
 
-        if (DOUBLE_QUOTES == curr_byte) ++double_quotes_c; // Check for "
+        if (DOUBLE_QUOTES == curr_byte && !escaped) ++double_quotes_c; // Check for " (skip the escaped ones)
+        escaped = (is_string && 1 == double_quotes_c && BACKSLASH == curr_byte && !escaped);
 
         if ((double_quotes_c > 0 && !is_string) || (double_quotes_c > EXP_DOUBLE_QUOTES && is_string)) {
             p_value[p_value_s] = '\0';
-            cjlib_setup_error(p_name, p_value, MISSING_COMMA);
-            free(p_value);
+            parser_error(parser, p_name, p_value, MISSING_COMMA);
+            cjlib_free(p_value);
             return NULL;
         }
 
         p_value[p_value_s++] = curr_byte;
         if (p_value_s == p_value_init_s) {
             p_value_init_s += MEMORY_INIT_CHUNK;
-            p_value = (char *) realloc(p_value, sizeof(char) * p_value_init_s);
+            p_value = (char *) cjlib_realloc(p_value, sizeof(char) * p_value_init_s);
             if (NULL == p_value) {
-                cjlib_setup_error(p_name, "", MEMORY_ERROR);
+                parser_error(parser, p_name, "", MEMORY_ERROR);
                 return NULL;
             }
         }
 
         if ((is_object || is_array) && (!is_string || double_quotes_c == EXP_DOUBLE_QUOTES)) break;
         if (double_quotes_c < EXP_DOUBLE_QUOTES && is_string && (COMMMA == curr_byte || CURLY_BRACKETS_CLOSE == curr_byte) 
-            && next_is_end_of_file(src->c_fp)) {
+            && next_is_end_of_file(parser)) {
             p_value[p_value_s] = '\0';
-            cjlib_setup_error(p_name, p_value, INCOMPLETE_DOUBLE_QUOTES);
-            free(p_value);
+            parser_error(parser, p_name, p_value, INCOMPLETE_DOUBLE_QUOTES);
+            cjlib_free(p_value);
             return NULL;
         }
 
@@ -435,17 +612,32 @@ static char *parse_property_value(const struct cjlib_json *restrict src, const c
 
     p_value[p_value_s] = '\0';
 
-    p_value = (char *) realloc(p_value, sizeof(char) * (p_value_s + 1));
-    if (NULL == p_value) cjlib_setup_error(p_name, "", MEMORY_ERROR);
+    p_value = (char *) cjlib_realloc(p_value, sizeof(char) * (p_value_s + 1));
+    if (NULL == p_value) parser_error(parser, p_name, "", MEMORY_ERROR);
 
     return p_value;
 }
 
+/**
+ * Frees an object/array that the parser did not complete.
+ *
+ * @param src The incomplete object/array.
+ * @param root The root object of the JSON (it is not freed).
+ */
+static void discard_incomplete(struct incomplete_property *restrict src, const cjlib_json_object *root)
+{
+    if (root == src->i_data.object) return;
+
+    cjlib_free(src->i_name);
+    if (CJLIB_OBJECT == src->i_type) (void) cjlib_dict_destroy(src->i_data.object);
+    else if (NULL != src->i_data.array) cjlib_json_free_array(src->i_data.array);
+}
+
 static int configure_common
 (struct incomplete_property *restrict src, const char *p_name,
  void **restrict data, enum cjlib_json_datatypes p_type)
 {
-    src->i_name = strdup(p_name);
+    src->i_name = cjlib_strdup(p_name);
     if (NULL == src->i_name) return -1;
 
     switch (p_type) {
@@ -463,10 +655,14 @@ static int configure_common
     return 0;
 }
 
-static CJLIB_ALWAYS_INLINE int configure_nested_object(struct incomplete_property *restrict src, const char *p_name)
+static CJLIB_ALWAYS_INLINE int configure_nested_object
+(struct incomplete_property *restrict src, const char *p_name, enum cjlib_dict_backend backend)
 {
     src->i_type = CJLIB_OBJECT;
-    return configure_common(src, p_name, (void *) &src->i_data.object, CJLIB_OBJECT);
+    if (-1 == configure_common(src, p_name, (void *) &src->i_data.object, CJLIB_OBJECT)) return -1;
+
+    // The object is still empty, there is nothing to move.
+    return cjlib_dict_set_backend(src->i_data.object, backend);
 }
 
 static CJLIB_ALWAYS_INLINE int configure_array(struct incomplete_property *restrict src, const char *p_name)
@@ -476,117 +672,124 @@ static CJLIB_ALWAYS_INLINE int configure_array(struct incomplete_property *restr
 }
 
 static void *restore_common
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
     void *parent_data = NULL;
     struct cjlib_json_data comp_data;
+    bool duplicate;
 
-    char *p_name_trimmed = (!strcmp(ROOT_PROPERTY_NAME, comp->i_name))? strdup(comp->i_name):trim_double_quotes(comp->i_name);
-    void *i_data         = NULL;
-    void **c_value       = NULL;
-    size_t i_data_s      = 0;
-
-    if (CJLIB_OBJECT == comp->i_type) {
-        i_data   = comp->i_data.object;
-        i_data_s = sizeof(cjlib_json_object);
-        c_value  = (void **) &comp_data.c_value.c_obj;
-    } else {
-        i_data   = comp->i_data.array;
-        i_data_s = sizeof(cjlib_json_array);
-        c_value  = (void **) &comp_data.c_value.c_arr;
-    }
+    char *p_name_trimmed = (!strcmp(ROOT_PROPERTY_NAME, comp->i_name))? cjlib_strdup(comp->i_name):trim_double_quotes(comp->i_name, &cjlib_malloc);
+    if (NULL == p_name_trimmed) return NULL;
 
+    // The complete object/array is handed to its parent as it is, thus its address remains the same.
     comp_data.c_datatype = comp->i_type;
-    *c_value = (CJLIB_OBJECT == comp->i_type) ? (void *) cjlib_json_make_object() : (void *) cjlib_json_make_array();
-    if (NULL == c_value) return NULL;
+    if (CJLIB_OBJECT == comp->i_type) comp_data.c_value.c_obj = comp->i_data.object;
+    else comp_data.c_value.c_arr = comp->i_data.array;
 
-    (void) memcpy(*c_value, i_data, i_data_s);
+    // The members of a complete object are collected, build it before it is handed over.
+    if (CJLIB_OBJECT == comp->i_type && -1 == cjlib_dict_build(comp->i_data.object, &duplicate)) {
+        if (duplicate) parser_error(parser, p_name_trimmed, "", DUPLICATE_NAME);
+        cjlib_free(p_name_trimmed);
+        return NULL;
+    }
 
     if (CJLIB_OBJECT == parent->i_type) {
         parent_data = parent->i_data.object;
-        if (-1 == cjlib_dict_insert(&comp_data, (cjlib_json_object **) &parent_data, p_name_trimmed)) return NULL;
+        if (-1 == cjlib_dict_stage(parent->i_data.object, p_name_trimmed, &comp_data)) parent_data = NULL;
+        else cjlib_json_data_fragment(&comp_data)->f_parent = &parent->i_data.object->d_fragment;
     } else {
         parent_data = parent->i_data.array;
-        if (-1 == cjlib_json_array_append((cjlib_json_array *) parent_data, &comp_data)) return NULL;
+        if (-1 == cjlib_json_array_append(parent->i_data.array, &comp_data)) parent_data = NULL;
     }
 
-    free(p_name_trimmed);
+    cjlib_free(p_name_trimmed);
     return parent_data;
 }
 
 static CJLIB_ALWAYS_INLINE cjlib_json_object *restore_obj_from_nested_obj
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
-    return (cjlib_json_object *) restore_common(comp, parent);
+    return (cjlib_json_object *) restore_common(parser, comp, parent);
 }
 
 static CJLIB_ALWAYS_INLINE cjlib_json_object *restore_obj_from_array
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
-    return (cjlib_json_object *) restore_common(comp, parent);
+    return (cjlib_json_object *) restore_common(parser, comp, parent);
 }
 
 static cjlib_json_object *actions_before_obj_restore
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
     switch (comp->i_type) {
         case CJLIB_OBJECT:
-            return restore_obj_from_nested_obj(comp, parent);
+            return restore_obj_from_nested_obj(parser, comp, parent);
         case CJLIB_ARRAY:
-            return restore_obj_from_array(comp, parent);
+            return restore_obj_from_array(parser, comp, parent);
         default:
             return NULL;
     }
 }
 
 static CJLIB_ALWAYS_INLINE int restore_arr_from_object
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
-    if (NULL == restore_common(comp, parent)) return -1;
+    if (NULL == restore_common(parser, comp, parent)) return -1;
     return 0;
 }
 
 static CJLIB_ALWAYS_INLINE int restore_arr_from_nested_arr
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
-    if (NULL == restore_common(comp, parent)) return -1;
+    if (NULL == restore_common(parser, comp, parent)) return -1;
     return 0;
 }
 
 static CJLIB_ALWAYS_INLINE int actions_before_array_restore
-(const struct incomplete_property *restrict comp, const struct incomplete_property *restrict parent)
+(struct cjlib_parser *restrict parser, const struct incomplete_property *restrict comp,
+ const struct incomplete_property *restrict parent)
 {
     switch (comp->i_type) {
         case CJLIB_OBJECT:
-            return restore_arr_from_object(comp, parent);
+            return restore_arr_from_object(parser, comp, parent);
         case CJLIB_ARRAY:
-            return restore_arr_from_nested_arr(comp, parent);
+            return restore_arr_from_nested_arr(parser, comp, parent);
         default:
             return -1;
     }
 }
 
-static CJLIB_ALWAYS_INLINE int reached_end_of_json(const struct cjlib_json *restrict src)
+static CJLIB_ALWAYS_INLINE int reached_end_of_json(struct cjlib_parser *restrict parser)
 {
-    // Get the current position in the file.
-    long restore_pos; // The position to return.
+    // Get the current position in the JSON.
+    size_t restore_pos = parser->p_pos; // The position to return.
     unsigned char curr_byte;
 
-    restore_pos = ftell(src->c_fp);
-    if (-1 == restore_pos) return -1;
-
     do {
-        curr_byte = fgetc(src->c_fp);
-    } while (WHITE_SPACE == curr_byte || NEW_LINE == curr_byte);
+        curr_byte = (unsigned char) parser_next_byte(parser);
+    } while ((WHITE_SPACE == curr_byte || NEW_LINE == curr_byte) && !parser->p_eof);
 
-    if (-1 == fseek(src->c_fp, restore_pos, SEEK_SET)) return -1; // Reset the file offset.
+    parser_seek(parser, restore_pos); // Reset the position.
 
-    if (CURLY_BRACKETS_CLOSE == curr_byte || feof(src->c_fp)) return true;
+    if (CURLY_BRACKETS_CLOSE == curr_byte) return true;
 
     return false;
 }
 
-int cjlib_json_read(struct cjlib_json *restrict dst)
+/**
+ * Parses a JSON and fills the root object of @dst with its contents.
+ *
+ * @param parser The state of the parsing.
+ * @param dst Where to put all the information's about the json.
+ * @return 0 on success, otherwise -1 (the error is in parser->p_error).
+ */
+static int parse(struct cjlib_parser *restrict parser, struct cjlib_json *restrict dst)
 {
     /**
      *  Algorithm description for objects:
@@ -613,19 +816,23 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
     char *p_name         = NULL;
     char *p_name_trimmed = NULL;
 
+    char *root_name      = NULL;
+
     int reach_end;
+    bool duplicate;
 
     cjlib_stack_init(&incomplate_data_stc);
     incomplete_property_init(&tmp_data);
     incomplete_property_init(&curr_incomplete_data);
 
     curr_incomplete_data = (struct incomplete_property) {
-        .i_name = strdup(ROOT_PROPERTY_NAME), // cause is the root object
+        .i_name = cjlib_strdup(ROOT_PROPERTY_NAME), // cause is the root object
         .i_type = CJLIB_OBJECT,
         .i_data.object = dst->c_dict
     };
 
     if (NULL == curr_incomplete_data.i_name) goto read_err;
+    root_name = curr_incomplete_data.i_name;
 
     // Push the first incomplete object into the stack.
     if (-1 == cjlib_stack_push((void *) &curr_incomplete_data, sizeof(struct incomplete_property),
@@ -635,10 +842,10 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
     while (!cjlib_stack_is_empty(&incomplate_data_stc)) {
         if (BUILDING_OBJECT(compl_indicator)) {
             // Building an object?
-            p_name = parse_property_name((const struct cjlib_json *) dst);
+            p_name = parse_property_name(parser);
             if (NULL == p_name) goto read_err;
         }
-        p_value = parse_property_value((const struct cjlib_json *) dst, p_name);
+        p_value = parse_property_value(parser, p_name);
         if (NULL == p_value) goto read_err;
 
         // If the current data is only a 'comma', nothing else, then ignore it.
@@ -653,9 +860,9 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
             if (-1 == cjlib_stack_push((void *) &curr_incomplete_data, sizeof(struct incomplete_property),
                                        &incomplate_data_stc))
                 goto read_err;
-            if (CJLIB_ARRAY == curr_incomplete_data.i_type) p_name = strdup(curr_incomplete_data.i_name);
+            if (CJLIB_ARRAY == curr_incomplete_data.i_type) p_name = cjlib_strdup(curr_incomplete_data.i_name);
             if (NULL == p_name) goto read_err;
-            if (-1 == configure_nested_object(&curr_incomplete_data, p_name)) goto read_err;
+            if (-1 == configure_nested_object(&curr_incomplete_data, p_name, dst->c_backend)) goto read_err;
 
             compl_indicator = CURLY_BRACKETS_CLOSE;
             goto read_cleanup;
@@ -663,18 +870,22 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
             if (-1 == cjlib_stack_push((void *) &curr_incomplete_data, sizeof(struct incomplete_property),
                                        &incomplate_data_stc))
                 goto read_err;
+            if (CJLIB_ARRAY == curr_incomplete_data.i_type) p_name = cjlib_strdup(curr_incomplete_data.i_name);
+            if (NULL == p_name) goto read_err;
 
             if (-1 == configure_array(&curr_incomplete_data, p_name)) goto read_err;
             compl_indicator = SQUARE_BRACKETS_CLOSE;
             goto read_cleanup;
         }
 
-        if (-1 == type_decoder(&complete_data, p_name, p_value)) goto read_err;
+        // A lone closing bracket completes the current object/array, it carries no value.
+        if (CURLY_BRACKETS_CLOSE != p_value[0] && SQUARE_BRACKETS_CLOSE != p_value[0] &&
+            -1 == type_decoder(parser, &complete_data, p_name, p_value)) goto read_err;
 
         if (BUILDING_OBJECT(compl_indicator) && CURLY_BRACKETS_CLOSE != p_value[0]) {
-            p_name_trimmed = trim_double_quotes(p_name);
-            if (-1 == cjlib_dict_insert(&complete_data, &curr_incomplete_data.i_data.object,
-                                        p_name_trimmed))
+            p_name_trimmed = trim_double_quotes(p_name, &cjlib_malloc);
+            // The members are collected and the object is built once it is complete.
+            if (-1 == cjlib_dict_stage(curr_incomplete_data.i_data.object, p_name_trimmed, &complete_data))
                 goto read_err;
         } else if (BUILDING_ARRAY(compl_indicator) && SQUARE_BRACKETS_CLOSE != p_value[0]) {
             if (-1 == cjlib_json_array_append(curr_incomplete_data.i_data.array, &complete_data)) goto read_err;
@@ -695,23 +906,17 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
                 switch (complete_data.c_datatype) {
                     case CJLIB_OBJECT:
                         // Update the root of the AVL tree.
-                        tmp_data.i_data.object = actions_before_obj_restore(&curr_incomplete_data, &tmp_data);
-                        free(curr_incomplete_data.i_name);
-                        (CJLIB_OBJECT == curr_incomplete_data.i_type) ?
-                            free(curr_incomplete_data.i_data.object) :
-                            free(curr_incomplete_data.i_data.array);
+                        if (NULL == actions_before_obj_restore(parser, &curr_incomplete_data, &tmp_data)) goto read_err;
+                        cjlib_free(curr_incomplete_data.i_name);
 
                         (void) memcpy(&curr_incomplete_data, &tmp_data, sizeof(struct incomplete_property));
                         compl_indicator = CURLY_BRACKETS_CLOSE;
                         break;
                     case CJLIB_ARRAY:
-                        if (-1 == actions_before_array_restore(&curr_incomplete_data,
+                        if (-1 == actions_before_array_restore(parser, &curr_incomplete_data,
                                                                &tmp_data))
                             goto read_err;
-                        free(curr_incomplete_data.i_name);
-                        (CJLIB_OBJECT == curr_incomplete_data.i_type) ?
-                            free(curr_incomplete_data.i_data.object) :
-                            free(curr_incomplete_data.i_data.array);
+                        cjlib_free(curr_incomplete_data.i_name);
                         (void) memcpy(&curr_incomplete_data, &tmp_data, sizeof(struct incomplete_property));
                         compl_indicator = SQUARE_BRACKETS_CLOSE;
                         break;
@@ -720,13 +925,14 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
                 }
             } else {
                 if (!strcmp(tmp_data.i_name, ROOT_PROPERTY_NAME)) {
-                    free(tmp_data.i_name);
+                    cjlib_free(tmp_data.i_name);
                     tmp_data.i_name = NULL;
+                    root_name       = NULL;
                     goto read_cleanup; // If this statement occur, then skip the end of file verification
                 }
             }
 
-            reach_end = reached_end_of_json(dst);
+            reach_end = reached_end_of_json(parser);
             if (-1 == reach_end) goto read_err;
 
             if (!strcmp(tmp_data.i_name, ROOT_PROPERTY_NAME) && reach_end) {
@@ -737,404 +943,1234 @@ int cjlib_json_read(struct cjlib_json *restrict dst)
         }
 
 read_cleanup:
-        free(p_name);
-        free(p_value);
-        free(p_name_trimmed);
+        cjlib_free(p_name);
+        cjlib_free(p_value);
+        cjlib_free(p_name_trimmed);
         p_name         = NULL;
         p_value        = NULL;
         p_name_trimmed = NULL;
     }
-    free(tmp_data.i_name);
+    cjlib_free(tmp_data.i_name);
 
     // Update the AVL tree.
     dst->c_dict = curr_incomplete_data.i_data.object; // Is no longer incomplete.
+    if (-1 == cjlib_dict_build(dst->c_dict, &duplicate)) {
+        parser_error(parser, "", "", (duplicate) ? DUPLICATE_NAME : MEMORY_ERROR);
+        return -1;
+    }
 
     return 0;
 
 read_err:
-    free(p_name);
-    free(p_value);
-    free(p_name_trimmed);
+    cjlib_free(p_name);
+    cjlib_free(p_value);
+    cjlib_free(p_name_trimmed);
+
+    if (NO_ERROR == parser->p_error.c_error_code) parser_error(parser, "", "", UNDEFINED);
+
+    // The incomplete objects/arrays are not linked to their parents, free them.
+    incomplete_property_init(&tmp_data);
+    if (!cjlib_stack_is_empty(&incomplate_data_stc)) {
+        (void) cjlib_stack_pop((void *) &tmp_data, sizeof(struct incomplete_property), &incomplate_data_stc);
+    }
+    // The current one may be pushed already (if the error occured while a new one was configured).
+    if (tmp_data.i_data.object != curr_incomplete_data.i_data.object) {
+        discard_incomplete(&curr_incomplete_data, dst->c_dict);
+    }
+    while (NULL != tmp_data.i_data.object) {
+        discard_incomplete(&tmp_data, dst->c_dict);
+        incomplete_property_init(&tmp_data);
+        if (cjlib_stack_is_empty(&incomplate_data_stc)) break;
+        (void) cjlib_stack_pop((void *) &tmp_data, sizeof(struct incomplete_property), &incomplate_data_stc);
+    }
+    cjlib_free(root_name);
+
+    // Keep the members of the root object that were read so far.
+    (void) cjlib_dict_build(dst->c_dict, NULL);
 
     return -1;
 }
 
-/**
- * Enclose a state which represent a complete JSON entry with its 
- * respective opening and closing symbol. For example is the 
- * completed state were an object, then the opening symbol is { (curly brackets open)
- * and the closing symbol is } (curly bracktes close)
- *
- * @param entry_state The state of the complete entry.
- * @param opening_symbol The opening symbol of the entry.
- * @param closing_symbol The closing symbol of the entry.
- * @returns A string representing the opening_symbol entry closing_symbol on success. 
- * Otherwise NULL.
- */
-static inline char *wrap_complete_entry(const char *entry_state, char opening_symbol, 
-                                        char closing_symbol, bool set_comma) 
+int cjlib_json_parse(struct cjlib_json *restrict dst, const char *restrict src, size_t src_s)
 {
-    size_t additional_size = 3; // The size of {} or [] + comma.
-    size_t wrapped_size = strlen(entry_state) + additional_size;
+    struct cjlib_parser parser;
+    struct cjlib_json_spare *previous;
+    int ret;
 
-    char *wrapped_state = (char *) malloc(wrapped_size + 1);
-    if (NULL == wrapped_state) return NULL;
+    parser_init(&parser, src, src_s);
 
-    if (set_comma) {
-        (void) sprintf(wrapped_state, "%c%s%c,", opening_symbol, entry_state, closing_symbol); 
-    } else {
-        (void) sprintf(wrapped_state, "%c%s%c", opening_symbol, entry_state, closing_symbol); 
+    // The blocks that the json kept on its last reset are reused first (see cjlib_json_reset).
+    previous = cjlib_memory_spare_use(dst->c_spare);
+    ret      = parse(&parser, dst);
+    (void) cjlib_memory_spare_use(previous);
+
+    if (-1 == ret) {
+        cjlib_setup_error(parser.p_error.c_property_name, parser.p_error.c_property_value,
+                          parser.p_error.c_error_code);
+        return -1;
     }
 
-    return wrapped_state;
+    return 0;
 }
 
 /**
- * Take the data of the current JSON field and its respective key as an argument 
- * and produce a string that is in format KEY : DATA, 
+ * Reads the rest of a file in memory.
  *
- * @param src The data of the field.
- * @param set_comma Determines whether to insert a comma or not.
- * @return A string representing an entry of the JSON file (Format KEY : DATA,) -> (KEY COLON DATA COMMA) in success, 
- * otherwise NULL is returned.
+ * @param dst_s Where to store the size of the contents.
+ * @param fp The file.
+ * @return A pointer to the contents of the file, otherwise NULL.
  */
-static char *simple_key_value_paired_stringtify
-(const struct cjlib_json_data *restrict src, bool set_comma)
-{
-    const size_t comma_len = 1;
-    const size_t colon_len = 1;
-    const size_t boolean_true_len  = 4;
-    const size_t boolean_false_len = 5;
-    const size_t null_len = 4;
-    const size_t double_quotes_len = 2;
-    size_t digit_num = 0;
+static char *read_file(size_t *restrict dst_s, FILE *restrict fp)
+{
+    size_t json_init_s = READ_FILE_CHUNK;
+    size_t json_s      = 0;
+    char *json         = (char *) malloc(sizeof(char) * json_init_s);
+    char *tmp;
 
-    char *result = NULL;
-    switch (src->c_datatype) {
-        case CJLIB_STRING:
-            // LEN(KEY) + LEN(:) + LEN(VALUE) + LEN(,) + LEN("\0")
-            result = (char *) malloc(strlen(src->c_value.c_str) + comma_len + colon_len + double_quotes_len + 1);
-            if (NULL == result) return NULL;
-            if (set_comma) {
-                (void) sprintf(result, "\"%s\",", src->c_value.c_str);
-            } else {
-                (void) sprintf(result, "\"%s\"", src->c_value.c_str);
-            }
-            break;
-        case CJLIB_NUMBER:
-            digit_num = snprintf(NULL, 0, "%f", src->c_value.c_num);
-            result = (char *) malloc(digit_num + comma_len + colon_len + 1);
-            if (NULL == result) return NULL;
+    if (NULL == json) return NULL;
 
-            if (set_comma) {
-                (void) sprintf(result, "%f,", src->c_value.c_num);
-            } else {
-                (void) sprintf(result, "%f", src->c_value.c_num);
-            }
-            break;
-        case CJLIB_BOOLEAN:
-            if (src->c_value.c_boolean) {
-                result = (char *) malloc(boolean_true_len + comma_len + colon_len + 1);
-                if (NULL == result) return NULL;
-
-                if (set_comma) {
-                    (void) sprintf(result, "%s,", "true");
-                } else {
-                    (void) sprintf(result, "%s", "true");
-                }
-            } else {
-                result = (char *) malloc(boolean_false_len + comma_len + colon_len + 1);
-                if (NULL == result) return NULL;
+    while (true) {
+        json_s += fread(json + json_s, sizeof(char), json_init_s - json_s, fp);
+        if (json_s < json_init_s) break;
 
-                if (set_comma) {
-                    (void) sprintf(result, "%s,", "false");
-                } else {
-                    (void) sprintf(result, "%s", "false");
-                }
-            }
-            break;
-        case CJLIB_NULL:
-            result = (char *) malloc(null_len + comma_len + colon_len + 1);
-            if (NULL == result) return NULL;
+        json_init_s *= 2;
+        tmp = (char *) realloc(json, sizeof(char) * json_init_s);
+        if (NULL == tmp) {
+            free(json);
+            return NULL;
+        }
+        json = tmp;
+    }
 
-            if (set_comma) {
-                (void) sprintf(result, "%s,", "null");
-            } else {
-                (void) sprintf(result, "%s", "null");
-            }
-            break;
-        default:
-            break;
+    if (ferror(fp)) {
+        free(json);
+        return NULL;
     }
 
-    return result;
+    *dst_s = json_s;
+    return json;
 }
 
-/**
- * Switches to another incomplete object,i.e., when a nested array or object is
- * detected.
- *
- * @param dst A pointer that points to the location to store the switched data.
- * @param type The type of the new data.
- * @param entry The incomplete object/array.
- * @param entry_key The key of the key:pair combination for the incomplete object/array.
- */
-static inline int switch_from_incomplete_obj_str_data
-(struct incomplete_property_str *restrict dst, enum cjlib_json_datatypes type, 
- cjlib_json_object *entry)
-{
-    char opening_symbol_str = DOUBLE_QUOTES;
-    char closing_symbol_str = DOUBLE_QUOTES;
-    size_t key_wrapped_size = strlen(CJLIB_DICT_NODE_KEY(entry)) + 2;
-    char *key_wrapped = (char *) malloc(key_wrapped_size + 1);
-    if (NULL == key_wrapped) return -1;
-
-    (void) sprintf(key_wrapped, "%c%s%c", opening_symbol_str, CJLIB_DICT_NODE_KEY(entry), 
-                   closing_symbol_str);
-
-    struct cjlib_json_data *examine_entry_data = CJLIB_DICT_NODE_DATA(entry);
-    *dst = (struct incomplete_property_str) {
-        .i_key            = key_wrapped,
-        .set_comma        = true,
-        .i_type           = type,
-        .i_state          = strdup(""),
-        .i_pending_data_q = (struct cjlib_queue *) malloc(sizeof(struct cjlib_queue))
-    };
-
-    if (NULL == dst->i_pending_data_q) return -1;
+int cjlib_json_read(struct cjlib_json *restrict dst)
+{
+    size_t json_s = 0;
+    char *json    = read_file(&json_s, dst->c_fp);
+    int ret;
 
-    cjlib_queue_init(dst->i_pending_data_q);
+    if (NULL == json) {
+        cjlib_setup_error(dst->c_path, "", IO_ERROR);
+        return -1;
+    }
 
-    if (CJLIB_OBJECT == type) dst->i_data.object = entry;
-    else dst->i_data.array = examine_entry_data->c_value.c_arr;
+    ret = cjlib_json_parse(dst, json, json_s);
+    free(json);
 
-    return 0;
+    return ret;
 }
 
-static inline int switch_from_incomplete_arr_str_data
-(struct incomplete_property_str *restrict dst, enum cjlib_json_datatypes type, 
-struct cjlib_json_data *entry_data, const char *key)
+int cjlib_json_reset(struct cjlib_json *restrict src)
 {
-    char opening_symbol_str = DOUBLE_QUOTES;
-    char closing_symbol_str = DOUBLE_QUOTES;
-    size_t key_wrapped_size = strlen(key) + 2;
-    char *key_wrapped = (char *) malloc(key_wrapped_size + 1);
-    if (NULL == key_wrapped) return -1;
+    struct cjlib_json_spare *previous;
+    int ret = -1;
 
-    (void) sprintf(key_wrapped, "%c%s%c", opening_symbol_str, key, 
-                   closing_symbol_str);
+    if (NULL == src->c_spare) {
+        src->c_spare = (struct cjlib_json_spare *) cjlib_calloc(1, sizeof(struct cjlib_json_spare));
+        if (NULL == src->c_spare) return -1;
+    }
 
-    struct cjlib_json_data *examine_entry_data = entry_data;
-    *dst = (struct incomplete_property_str) {
-        .i_key            = key_wrapped,
-        .set_comma        = true,
-        .i_type           = type,
-        .i_state          = strdup(""),
-        .i_pending_data_q = (struct cjlib_queue *) malloc(sizeof(struct cjlib_queue))
-    };
+    // Every block of the json, up to CJLIB_MEMORY_SPARE_MAX bytes, is kept instead of freed.
+    previous = cjlib_memory_spare_use(src->c_spare);
+    (void) cjlib_dict_destroy(src->c_dict);
+    src->c_dict = cjlib_json_make_object();
+    if (NULL != src->c_dict) ret = cjlib_dict_set_backend(src->c_dict, src->c_backend);
+    (void) cjlib_memory_spare_use(previous);
 
-    if (NULL == dst->i_pending_data_q) return -1;
+    if (NULL != src->c_fp) rewind(src->c_fp);
+    return ret;
+}
 
-    cjlib_queue_init(dst->i_pending_data_q);
+/**
+ * A thread of cjlib_json_parse_many. The inputs that are left to the worker are
+ * the ones in [head, tail), both packed in w_range. The owner takes inputs from the
+ * head, while the other workers steal from the tail.
+ */
+struct parse_many_worker
+{
+    _Alignas(PARSE_MANY_CACHE_LINE) _Atomic uint64_t w_range; // The head (low half) and the tail (high half).
+    struct parse_many_pool *w_pool;                           // The pool of the worker.
+    size_t w_id;                                              // The position of the worker in the pool.
+};
 
-    if (CJLIB_OBJECT == type) dst->i_data.object = examine_entry_data->c_value.c_obj;
-    else dst->i_data.array = examine_entry_data->c_value.c_arr;
+/**
+ * The state shared by the workers of cjlib_json_parse_many.
+ */
+struct parse_many_pool
+{
+    struct parse_many_worker *m_workers;     // The workers.
+    size_t m_workers_s;                      // The number of workers.
+    struct cjlib_json *m_dst;                // Where to put each parsed json.
+    struct cjlib_json_error *m_errors;       // Where to put the error of each input (can be NULL).
+    const struct cjlib_json_source *m_src;   // The inputs.
+    atomic_bool m_failed;                    // Whether the parsing of any input failed.
+};
 
-    return 0;
-}
 /**
- * Convert the provided @src list into a queue.
+ * Takes the input on the head of a range.
  *
- * The queue consists of pointers that point to the objects
- * in the list. (NO NEED FOR FREE FOR THOSE OBJECTS NEEDED).
- * This is done for optimization purposes (to allocate and free
- * two times the same data).
- *
- * @param dst A pointer to the queue in which the pointers are stored.
- * @param src A pointer to the list from which the paointers will be extracted.
- * @return 0 on success, otherwise -1.
+ * @return true if an input is taken, false if the range is empty.
  */
-static inline int convert_list_to_queue(struct cjlib_queue *restrict dst, const struct cjlib_list *restrict src)
+static bool range_pop_front(_Atomic uint64_t *range, uint32_t *restrict dst)
 {
-    struct cjlib_json_data *item; 
+    uint64_t curr = atomic_load(range);
+    uint32_t head;
+    uint32_t tail;
 
-    CJLIB_LIST_FOR_EACH_PTR(item, src, struct cjlib_json_data) {
-        // Store the pointers of each element in the list into the @dst
-        if (-1 == cjlib_queue_enqeue((void *) &item, sizeof(struct cjlib_json_data *), dst)) {
-            return -1;
-        }
-    }
+    do {
+        head = RANGE_HEAD(curr);
+        tail = RANGE_TAIL(curr);
+        if (head >= tail) return false;
+    } while (!atomic_compare_exchange_weak(range, &curr, RANGE_PACK(head + 1, tail)));
 
-    return 0;
+    *dst = head;
+    return true;
 }
 
-const char *cjlib_json_object_stringtify(const cjlib_json_object *src)
+/**
+ * Steals the half (rounded up) of the inputs on the tail of a range.
+ *
+ * @return true if inputs are stolen ([*head, *tail)), false if the range is empty.
+ */
+static bool range_steal_back(_Atomic uint64_t *range, uint32_t *restrict head, uint32_t *restrict tail)
 {
-    struct incomplete_property_str curr_incomp; // The currently expanding data.
-    struct cjlib_stack incomplete_st;           // The stack of incomplete data.
-    
-    cjlib_dict_node_t *examine_entry;           // The current key:paired entry from the JSON in memory. (contains both the key and data)
-    struct cjlib_json_data *examine_entry_data; // The data of the examined entry.
+    uint64_t curr = atomic_load(range);
+    uint32_t stolen;
 
-    char *tmp_state = NULL; // Used to control the memory (see default case in the switch below)
-    char *tmp_key   = NULL; // Used to temporary store the key of the complete JSON object/array.
-    char *value_str = NULL; // Used to temporary store the strintify data (see default case in the switch below)
-
-    bool set_comma_tmp = true; // Helper, to maintain the information about whether to put comma or not on completion (see incomplete_str & on switch below.)
+    do {
+        *head = RANGE_HEAD(curr);
+        *tail = RANGE_TAIL(curr);
+        if (*head >= *tail) return false;
+        stolen = (*tail - *head + 1) / 2;
+    } while (!atomic_compare_exchange_weak(range, &curr, RANGE_PACK(*head, *tail - stolen)));
 
-    char opening_symbol_obj = CURLY_BRACKETS_OPEN;
-    char opening_symbol_arr = SQUARE_BRACKETS_OPEN;
-    char closing_symbol_obj = CURLY_BRACKETS_CLOSE;
-    char closing_symbol_arr = SQUARE_BRACKETS_CLOSE;
+    *head = *tail - stolen;
+    return true;
+}
 
-    char opening_symbol_str = DOUBLE_QUOTES;
-    char closing_symbol_str = DOUBLE_QUOTES;
-    
-    char opening_symbol;
-    char closing_symbol;
+/**
+ * Parses an input of cjlib_json_parse_many.
+ *
+ * @param pool The state of cjlib_json_parse_many.
+ * @param index The position of the input.
+ */
+static void parse_source(struct parse_many_pool *restrict pool, size_t index)
+{
+    const struct cjlib_json_source *src = &pool->m_src[index];
+    struct cjlib_json *dst              = &pool->m_dst[index];
+    struct cjlib_parser parser;
+    FILE *fp    = NULL;
+    char *json  = NULL;
+    size_t json_s = 0;
+    int ret     = -1;
+
+    parser_init(&parser, src->s_buf, src->s_buf_s);
+    if (-1 == cjlib_json_init(dst)) {
+        parser_error(&parser, "", "", MEMORY_ERROR);
+        goto parse_source_done;
+    }
 
-    // Initiazize the incomplete data.
-    incomplete_property_str_init(&curr_incomp);
-    cjlib_stack_init(&incomplete_st);
+    if (NULL != src->s_path) {
+        fp   = fopen(src->s_path, "r");
+        json = (NULL == fp) ? NULL : read_file(&json_s, fp);
+        if (NULL != fp) (void) fclose(fp);
 
-    if (-1 == switch_from_incomplete_obj_str_data(&curr_incomp, CJLIB_OBJECT, (cjlib_json_object *) src)) return NULL;
+        dst->c_path = strdup(src->s_path);
+        if (NULL == json || NULL == dst->c_path) {
+            parser_error(&parser, src->s_path, "", IO_ERROR);
+            goto parse_source_done;
+        }
+        parser_init(&parser, json, json_s);
+    }
 
-    if (-1 == cjlib_dict_preorder(curr_incomp.i_pending_data_q, curr_incomp.i_data.object)) return NULL;
+    ret = parse(&parser, dst);
 
-    // Put a dummy entry in the stack to start the process.
-    if (-1 == cjlib_stack_push((void *) &curr_incomp, sizeof(struct incomplete_property_str), 
-                               &incomplete_st)) return NULL;
+parse_source_done:
+    free(json);
+    if (NULL != pool->m_errors) {
+        (void) memcpy(&pool->m_errors[index], &parser.p_error, sizeof(struct cjlib_json_error));
+    }
+    if (-1 == ret) atomic_store(&pool->m_failed, true);
+}
 
-    while (!cjlib_stack_is_empty(&incomplete_st)) {
-        if (-1 == cjlib_stack_pop((void *) &curr_incomp, sizeof(struct incomplete_property_str),
-                                  &incomplete_st)) return NULL;
+static int parse_many_worker_run(void *arg)
+{
+    struct parse_many_worker *self = (struct parse_many_worker *) arg;
+    struct parse_many_pool *pool   = self->w_pool;
+    struct parse_many_worker *victim;
+    uint32_t index;
+    uint32_t head;
+    uint32_t tail;
+    bool stolen;
 
-        // If the value_str is NULL, then, the nested while have not run yet.
-        if (NULL != value_str) {
-            tmp_state = curr_incomp.i_state;
-            if (CJLIB_OBJECT == curr_incomp.i_type) {
-                curr_incomp.i_state = incomplete_property_str_expand_state(curr_incomp.i_state, value_str, tmp_key);
-            } else {
-                curr_incomp.i_state = incomplete_property_str_expand_state(curr_incomp.i_state, value_str, NULL); 
-            }
+    do {
+        while (range_pop_front(&self->w_range, &index)) parse_source(pool, index);
 
-            free(tmp_key);
-            free(value_str);
-            free(tmp_state);
-            tmp_state = NULL;
-            value_str = NULL;
-            tmp_key   = NULL;
+        // Out of inputs, steal from the other workers.
+        stolen = false;
+        for (size_t i = 1; i < pool->m_workers_s && !stolen; i++) {
+            victim = &pool->m_workers[(self->w_id + i) % pool->m_workers_s];
+            stolen = range_steal_back(&victim->w_range, &head, &tail);
         }
+        if (stolen) atomic_store(&self->w_range, RANGE_PACK(head, tail));
+    } while (stolen);
 
-        while (!cjlib_queue_is_empty(curr_incomp.i_pending_data_q)) {
-            // Get the entry to strintify.
-            if (CJLIB_OBJECT == curr_incomp.i_type) {
-                // The queue of an incomplete object consists of NODES of avl binary tree.
-                cjlib_queue_deqeue((void *) &examine_entry, sizeof(cjlib_dict_node_t *), curr_incomp.i_pending_data_q);
-                examine_entry_data = CJLIB_DICT_NODE_DATA(examine_entry);
-            } else {
-                // The queue of an incomplete array consists of NODES of a linked list.
-                cjlib_queue_deqeue((void *) &examine_entry_data, sizeof(struct cjlib_json_data *), curr_incomp.i_pending_data_q);
-            }
+    return 0;
+}
 
-            switch (examine_entry_data->c_datatype) {
-                case CJLIB_OBJECT:
-                    if (cjlib_queue_is_empty(curr_incomp.i_pending_data_q)) set_comma_tmp = false;
-                
-                    cjlib_stack_push(&curr_incomp, sizeof(struct incomplete_property_str), 
-                                     &incomplete_st);
-
-                    if (CJLIB_ARRAY == curr_incomp.i_type) examine_entry = examine_entry_data->c_value.c_obj;
-                    if (-1 == switch_from_incomplete_obj_str_data(&curr_incomp, CJLIB_OBJECT, examine_entry)) return NULL;
-
-                    curr_incomp.set_comma = set_comma_tmp;
-                    
-                    if (-1 == cjlib_dict_preorder(curr_incomp.i_pending_data_q, curr_incomp.i_data.object)) return NULL;
-                    break;
-                case CJLIB_ARRAY:
-                    if (cjlib_queue_is_empty(curr_incomp.i_pending_data_q)) set_comma_tmp = false;
-                    cjlib_stack_push(&curr_incomp, sizeof(struct incomplete_property_str), &incomplete_st);
-
-                    if (-1 == switch_from_incomplete_arr_str_data(&curr_incomp, CJLIB_ARRAY, examine_entry_data, 
-                                                                  CJLIB_DICT_NODE_KEY(examine_entry))) return NULL;
-
-                    curr_incomp.set_comma = set_comma_tmp;
-                    convert_list_to_queue(curr_incomp.i_pending_data_q, curr_incomp.i_data.array);
-                    break;
-                default:
-                    tmp_state = curr_incomp.i_state;
-
-                    if (CJLIB_OBJECT == curr_incomp.i_type) {
-                        if (cjlib_queue_is_empty(curr_incomp.i_pending_data_q)) {
-                            value_str = simple_key_value_paired_stringtify(CJLIB_DICT_NODE_DATA(examine_entry), false);
-                        } else {
-                            value_str = simple_key_value_paired_stringtify(CJLIB_DICT_NODE_DATA(examine_entry), true);
-                        }
-
-                        tmp_key = wrap_complete_entry(CJLIB_DICT_NODE_KEY(examine_entry),opening_symbol_str, closing_symbol_str, false);
-                        curr_incomp.i_state = incomplete_property_str_expand_state(curr_incomp.i_state, value_str, 
-                                                                                   tmp_key);
-
-                        free(tmp_key);
-                        tmp_key = NULL;
-                    } else {
-                        if (cjlib_queue_is_empty(curr_incomp.i_pending_data_q)) {
-                            value_str = simple_key_value_paired_stringtify(examine_entry_data, false);
-                        } else {
-                            value_str = simple_key_value_paired_stringtify(examine_entry_data, true);
-                        }
-
-                        curr_incomp.i_state = incomplete_property_str_expand_state(curr_incomp.i_state, value_str, NULL);
-                    }
-                    free(tmp_state);
-                    free(value_str);
-                    tmp_state = NULL;
-                    value_str = NULL;
-                    break;
-            }
+/**
+ * Leaves the jsons and the errors of cjlib_json_parse_many as if each input failed, when
+ * it fails before any input is parsed (each json can still be freed by cjlib_json_close).
+ *
+ * @param dst The jsons.
+ * @param errors The errors (can be NULL).
+ * @param src_s The number of inputs.
+ * @param code The error of every input.
+ * @return -1.
+ */
+static int parse_many_fail
+(struct cjlib_json *restrict dst, struct cjlib_json_error *restrict errors,
+ size_t src_s, enum cjlib_json_error_types code)
+{
+    (void) memset(dst, 0x0, sizeof(struct cjlib_json) * src_s);
+    for (size_t i = 0; NULL != errors && i < src_s; i++) cjlib_make_error(&errors[i], "", "", code);
+    cjlib_setup_error("", "", code);
+    return -1;
+}
 
-            set_comma_tmp = true;
-        }
+int cjlib_json_parse_many
+(struct cjlib_json *restrict dst, struct cjlib_json_error *restrict errors,
+ const struct cjlib_json_source *restrict src, size_t src_s, size_t threads)
+{
+    struct parse_many_pool pool;
+    thrd_t *workers_thrd;
+    bool *workers_started;
+    size_t share;
+    long online;
 
-        opening_symbol = (CJLIB_OBJECT == curr_incomp.i_type)? opening_symbol_obj : opening_symbol_arr;
-        closing_symbol = (CJLIB_OBJECT == curr_incomp.i_type)? closing_symbol_obj : closing_symbol_arr;
+    if (0 == src_s) return 0;
+    if (NULL == dst) return -1;
+    if (NULL == src || src_s > UINT32_MAX) return parse_many_fail(dst, errors, src_s, UNDEFINED);
 
-        if (CJLIB_OBJECT == curr_incomp.i_type || CJLIB_ARRAY == curr_incomp.i_type) {
-            tmp_state = curr_incomp.i_state;
+    if (0 == threads) {
+        online  = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (size_t) online : 1;
+    }
+    if (threads > src_s) threads = src_s;
+
+    (void) memset(&pool, 0x0, sizeof(struct parse_many_pool));
+    pool.m_workers_s = threads;
+    pool.m_dst       = dst;
+    pool.m_errors    = errors;
+    pool.m_src       = src;
+    atomic_init(&pool.m_failed, false);
+
+    pool.m_workers  = (struct parse_many_worker *) aligned_alloc(PARSE_MANY_CACHE_LINE,
+                                                                 sizeof(struct parse_many_worker) * threads);
+    workers_thrd    = (thrd_t *) malloc(sizeof(thrd_t) * threads);
+    workers_started = (bool *) calloc(threads, sizeof(bool));
+    if (NULL == pool.m_workers || NULL == workers_thrd || NULL == workers_started) {
+        free(pool.m_workers);
+        free(workers_thrd);
+        free(workers_started);
+        return parse_many_fail(dst, errors, src_s, MEMORY_ERROR);
+    }
 
-            if (cjlib_stack_is_empty(&incomplete_st) || !curr_incomp.set_comma) {
-                curr_incomp.i_state = wrap_complete_entry(curr_incomp.i_state, opening_symbol, closing_symbol, false);
-            } else {
-                curr_incomp.i_state = wrap_complete_entry(curr_incomp.i_state, opening_symbol, closing_symbol, true);
-            }
+    // Every worker starts with an equal share of the inputs.
+    share = src_s / threads;
+    for (size_t i = 0; i < threads; i++) {
+        pool.m_workers[i].w_pool = &pool;
+        pool.m_workers[i].w_id   = i;
+        atomic_init(&pool.m_workers[i].w_range,
+                    RANGE_PACK(i * share, (i == threads - 1) ? src_s : (i + 1) * share));
+    }
 
-            free(tmp_state);
-            if (NULL == curr_incomp.i_state) return NULL;
-        }
+    // The calling thread is the first worker. If a thread fails to start, its share is stolen.
+    for (size_t i = 1; i < threads; i++) {
+        workers_started[i] = (thrd_success == thrd_create(&workers_thrd[i], &parse_many_worker_run,
+                                                          (void *) &pool.m_workers[i]));
+    }
+    (void) parse_many_worker_run((void *) &pool.m_workers[0]);
 
-        value_str = curr_incomp.i_state;
-       
-        tmp_key   = curr_incomp.i_key;
-        // Free the pending queue (there are no more incomplete data for the JSON object/array that were examined).
-        free(curr_incomp.i_pending_data_q);
-        curr_incomp.i_pending_data_q = NULL;
-    } 
+    for (size_t i = 1; i < threads; i++) {
+        if (workers_started[i]) (void) thrd_join(workers_thrd[i], NULL);
+    }
 
-    free(curr_incomp.i_key);
+    free(pool.m_workers);
+    free(workers_thrd);
+    free(workers_started);
 
-    (void) printf("%s\n", curr_incomp.i_state);
-    // Return the now completed JSON.
-    return curr_incomp.i_state;
+    return atomic_load(&pool.m_failed) ? -1 : 0;
 }
 
-int cjlib_json_dump(const struct cjlib_json *restrict src)
+/**
+ * Describes an object or array in the process of being serialized.
+ */
+struct serializer_frame
+{
+    enum cjlib_json_datatypes f_type;      // The type of the container (object or array).
+    bool f_first;                          // Whether no member of the container is written yet.
+    struct cjlib_dict_iter f_entries;      // The walk over the members of an object.
+    struct cjlib_list_node *f_next_item;   // The next item of an array to write.
+    struct cjlib_fragment *f_fragment;     // The cached serialization of the container.
+    size_t f_start;                        // Where the serialization of the container begins.
+};
+
+/**
+ * The state of a serialization. When s_dst is NULL, nothing is written and
+ * only the size of the serialization is calculated. When s_cache is set, the
+ * unchanged objects/arrays are copied from their fragments and the ones that
+ * are serialized again are stored in their fragments.
+ */
+struct serializer
 {
-    if (NULL == freopen(src->c_path, "w+", src->c_fp)) return -1;
+    char *s_dst;                       // Where to write the serialized JSON (can be NULL).
+    bool s_cache;                      // Whether the cached fragments are used.
+    size_t s_dst_s;                    // The size of s_dst.
+    size_t s_pos;                      // The number of bytes produced so far.
+    struct serializer_frame *s_frames; // The stack of the incomplete objects/arrays.
+    size_t s_depth;                    // The number of frames in the stack.
+    size_t s_frames_s;                 // The capacity of the stack.
+};
+
+static inline int serializer_emit(struct serializer *restrict s, const char *restrict src, size_t src_s)
+{
+    if (NULL != s->s_dst) {
+        if (CJLIB_BRANCH_UNLIKELY(src_s > s->s_dst_s - s->s_pos)) return -1;
+        (void) memcpy(s->s_dst + s->s_pos, src, src_s);
+    }
+    s->s_pos += src_s;
+    return 0;
+}
 
-    const char *json_content = cjlib_json_object_stringtify(src->c_dict);
-    if (NULL == json_content) return -1;
+static CJLIB_ALWAYS_INLINE int serializer_emit_byte(struct serializer *restrict s, char byte)
+{
+    return serializer_emit(s, &byte, 1);
+}
+
+static int serializer_emit_string(struct serializer *restrict s, const char *restrict src)
+{
+    size_t src_s     = strlen(src);
+    size_t escaped_s = cjlib_escaped_size(src, src_s);
+    const size_t double_quotes_len = 2;
+
+    if (NULL != s->s_dst) {
+        if (CJLIB_BRANCH_UNLIKELY(escaped_s + double_quotes_len > s->s_dst_s - s->s_pos)) return -1;
+
+        s->s_dst[s->s_pos] = DOUBLE_QUOTES;
+        (void) cjlib_escape(s->s_dst + s->s_pos + 1, src, src_s);
+        s->s_dst[s->s_pos + escaped_s + 1] = DOUBLE_QUOTES;
+    }
+    s->s_pos += escaped_s + double_quotes_len;
+    return 0;
+}
+
+/**
+ * Writes a value that is neither an object nor an array.
+ *
+ * @param s The state of the serialization.
+ * @param src The value to write.
+ * @return 0 on success, otherwise -1.
+ */
+static int serializer_emit_scalar(struct serializer *restrict s, const struct cjlib_json_data *restrict src)
+{
+    char number_str[CJLIB_DTOA_BUF_SIZE];
+
+    switch (src->c_datatype) {
+        case CJLIB_STRING:
+            return serializer_emit_string(s, cjlib_json_data_string(src));
+        case CJLIB_NUMBER:
+            return serializer_emit(s, number_str, cjlib_dtoa(number_str, src->c_value.c_num));
+        case CJLIB_BOOLEAN:
+            return (src->c_value.c_boolean) ? serializer_emit(s, "true", sizeof("true") - 1)
+                                            : serializer_emit(s, "false", sizeof("false") - 1);
+        case CJLIB_NULL:
+            return serializer_emit(s, "null", sizeof("null") - 1);
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Starts the serialization of an object or an array, by writing its opening
+ * symbol and pushing it in the stack of the incomplete data. If the cache is
+ * used and the object/array is unchanged, it is copied from the cache instead.
+ *
+ * @param s The state of the serialization.
+ * @param src The object or array to start.
+ * @param type The type of @src.
+ * @return 0 on success, otherwise -1.
+ */
+static int serializer_push
+(struct serializer *restrict s, const void *src, enum cjlib_json_datatypes type)
+{
+    struct serializer_frame *frames;
+    struct serializer_frame *frame;
+    // The cache is not part of the value, it is updated on a const object/array (see cjlib_json_stringtify).
+    struct cjlib_fragment *fragment = (CJLIB_OBJECT == type) ? &((cjlib_json_object *) src)->d_fragment
+                                                             : &((cjlib_json_array *) src)->l_fragment;
+
+    if (s->s_cache && fragment->f_clean && NULL != fragment->f_bytes) {
+        return serializer_emit(s, fragment->f_bytes, fragment->f_bytes_s);
+    }
+
+    if (s->s_depth == s->s_frames_s) {
+        frames = (struct serializer_frame *) realloc(s->s_frames, sizeof(struct serializer_frame) *
+                                                     (s->s_frames_s + SERIALIZER_FRAMES_CHUNK));
+        if (NULL == frames) return -1;
+        s->s_frames    = frames;
+        s->s_frames_s += SERIALIZER_FRAMES_CHUNK;
+    }
+
+    frame = &s->s_frames[s->s_depth];
+    frame->f_type      = type;
+    frame->f_first     = true;
+    frame->f_next_item = NULL;
+    frame->f_fragment  = fragment;
+    frame->f_start     = s->s_pos;
+
+    if (CJLIB_OBJECT == type) {
+        cjlib_dict_iter_begin(&frame->f_entries, (const cjlib_json_object *) src);
+        s->s_depth++;
+        return serializer_emit_byte(s, CURLY_BRACKETS_OPEN);
+    }
+
+    frame->f_next_item = ((const cjlib_json_array *) src)->l_head;
+    s->s_depth++;
+    return serializer_emit_byte(s, SQUARE_BRACKETS_OPEN);
+}
+
+/**
+ * Completes the serialization of the object or array on the top of the stack, by
+ * writing its closing symbol. If the cache is used, the serialization of the
+ * object/array is stored in its fragment (only when it is written and it is large
+ * enough to be worth it).
+ *
+ * @param s The state of the serialization.
+ * @return 0 on success, otherwise -1.
+ */
+static int serializer_pop(struct serializer *restrict s)
+{
+    struct serializer_frame *frame = &s->s_frames[--s->s_depth];
+    size_t bytes_s;
+
+    if (-1 == serializer_emit_byte(s, (CJLIB_OBJECT == frame->f_type) ? CURLY_BRACKETS_CLOSE
+                                                                      : SQUARE_BRACKETS_CLOSE)) return -1;
+
+    if (!s->s_cache || NULL == s->s_dst) return 0;
+
+    bytes_s = s->s_pos - frame->f_start;
+    if (bytes_s >= CJLIB_FRAGMENT_MIN_SIZE) {
+        cjlib_free(frame->f_fragment->f_bytes);
+        frame->f_fragment->f_bytes = (char *) cjlib_malloc(sizeof(char) * bytes_s);
+        // Failing to cache is not an error, the container is serialized again next time.
+        if (NULL == frame->f_fragment->f_bytes) return 0;
+
+        (void) memcpy(frame->f_fragment->f_bytes, s->s_dst + frame->f_start, bytes_s);
+        frame->f_fragment->f_bytes_s = bytes_s;
+    }
+    frame->f_fragment->f_clean = true;
+
+    return 0;
+}
+
+/**
+ * Frees the memory of the serialization stack (used when the serialization
+ * is interrupted).
+ */
+static void serializer_destroy(struct serializer *restrict s)
+{
+    s->s_depth = 0;
+    free(s->s_frames);
+    s->s_frames = NULL;
+}
+
+/**
+ * Serializes an object in its compact form (no white spaces). The objects and arrays
+ * are expanded using a stack, instead of recursion, thus the depth of the JSON is not
+ * limited by the size of the call stack.
+ *
+ * @param s The state of the serialization.
+ * @param src The object to serialize.
+ * @return 0 on success, otherwise -1.
+ */
+static int serialize_object(struct serializer *restrict s, const cjlib_json_object *src)
+{
+    struct serializer_frame *top;
+    struct cjlib_json_data *examine_entry;
+    const struct cjlib_json_data *examine_entry_data;
+    const char *examine_key;
+
+    if (-1 == serializer_push(s, src, CJLIB_OBJECT)) goto serialize_err;
+
+    while (s->s_depth > 0) {
+        top = &s->s_frames[s->s_depth - 1];
+
+        // Retrieve the next member of the incomplete object/array.
+        if (CJLIB_OBJECT == top->f_type) {
+            if (!cjlib_dict_iter_next(&top->f_entries, &examine_key, &examine_entry)) {
+                if (-1 == serializer_pop(s)) goto serialize_err;
+                continue;
+            }
+
+            examine_entry_data = examine_entry;
+            if (!top->f_first && -1 == serializer_emit_byte(s, COMMMA)) goto serialize_err;
+            if (-1 == serializer_emit_string(s, examine_key)) goto serialize_err;
+            if (-1 == serializer_emit_byte(s, SEPERATOR)) goto serialize_err;
+        } else {
+            if (NULL == top->f_next_item) {
+                if (-1 == serializer_pop(s)) goto serialize_err;
+                continue;
+            }
+            examine_entry_data = (const struct cjlib_json_data *) top->f_next_item->l_data;
+            top->f_next_item   = top->f_next_item->l_next;
+            if (!top->f_first && -1 == serializer_emit_byte(s, COMMMA)) goto serialize_err;
+        }
+        top->f_first = false;
+
+        switch (examine_entry_data->c_datatype) {
+            case CJLIB_OBJECT:
+                if (-1 == serializer_push(s, examine_entry_data->c_value.c_obj, CJLIB_OBJECT)) goto serialize_err;
+                break;
+            case CJLIB_ARRAY:
+                if (-1 == serializer_push(s, examine_entry_data->c_value.c_arr, CJLIB_ARRAY)) goto serialize_err;
+                break;
+            default:
+                if (-1 == serializer_emit_scalar(s, examine_entry_data)) goto serialize_err;
+                break;
+        }
+    }
+
+    serializer_destroy(s);
+    return 0;
+
+serialize_err:
+    serializer_destroy(s);
+    return -1;
+}
+
+/**
+ * Calculates the size of the serialization of an object.
+ *
+ * @param src The object to serialize.
+ * @param cache Whether to use the cached fragments.
+ * @return The size of the serialization, or 0 on failure.
+ */
+static size_t serialized_size(const cjlib_json_object *src, bool cache)
+{
+    struct serializer s;
+    (void) memset(&s, 0x0, sizeof(struct serializer));
+    s.s_cache = cache;
+
+    if (-1 == serialize_object(&s, src)) return 0;
+
+    return s.s_pos;
+}
+
+/**
+ * Writes the serialization of an object into a buffer.
+ *
+ * @param dst The buffer in which the serialization is written.
+ * @param dst_s The size of the buffer.
+ * @param src The object to serialize.
+ * @param cache Whether to use (and fill) the cached fragments.
+ * @return The number of bytes written, or 0 on failure.
+ */
+static size_t serialize(char *restrict dst, size_t dst_s, const cjlib_json_object *src, bool cache)
+{
+    struct serializer s;
+    (void) memset(&s, 0x0, sizeof(struct serializer));
+    s.s_dst   = dst;
+    s.s_dst_s = dst_s;
+    s.s_cache = cache;
+
+    if (NULL == dst || -1 == serialize_object(&s, src)) return 0;
+
+    return s.s_pos;
+}
+
+static const char *stringtify(const cjlib_json_object *src, bool cache)
+{
+    size_t json_s = serialized_size(src, cache);
+    if (0 == json_s) return NULL;
+
+    char *json = (char *) malloc(sizeof(char) * (json_s + 1));
+    if (NULL == json) return NULL;
+
+    if (json_s != serialize(json, json_s, src, cache)) {
+        free(json);
+        return NULL;
+    }
+    json[json_s] = '\0';
+
+    // Return the now completed JSON.
+    return json;
+}
+
+size_t cjlib_json_object_serialized_size(const cjlib_json_object *src)
+{
+    return serialized_size(src, false);
+}
+
+size_t cjlib_json_object_serialize(char *restrict dst, size_t dst_s, const cjlib_json_object *src)
+{
+    return serialize(dst, dst_s, src, false);
+}
+
+const char *cjlib_json_object_stringtify(const cjlib_json_object *src)
+{
+    return stringtify(src, false);
+}
+
+size_t cjlib_json_serialized_size(const struct cjlib_json *src)
+{
+    return serialized_size(src->c_dict, src->c_cache);
+}
+
+size_t cjlib_json_serialize(char *restrict dst, size_t dst_s, const struct cjlib_json *src)
+{
+    return serialize(dst, dst_s, src->c_dict, src->c_cache);
+}
+
+const char *cjlib_json_stringtify(const struct cjlib_json *src)
+{
+    return stringtify(src->c_dict, src->c_cache);
+}
+
+/**
+ * Visits an object/array and every object/array in it, each one before its contents.
+ *
+ * @param src The object/array.
+ * @param visit The routine to call on each object/array, it stops the walk by returning -1.
+ * @param arg The argument to pass to @visit.
+ * @return 0 on success, otherwise -1.
+ */
+static int walk_values
+(const struct cjlib_json_data *restrict src, int (*visit)(struct cjlib_json_data *restrict container, void *arg),
+ void *arg)
+{
+    struct cjlib_stack pending;
+    struct cjlib_dict_iter entries;
+    struct cjlib_json_data examine;
+    struct cjlib_json_data *item;
+    struct cjlib_json_data *entry;
+    const char *key;
+    int ret = 0;
+
+    cjlib_stack_init(&pending);
+    if (-1 == cjlib_stack_push(src, sizeof(struct cjlib_json_data), &pending)) return -1;
+
+    while (!cjlib_stack_is_empty(&pending)) {
+        if (-1 == cjlib_stack_pop(&examine, sizeof(struct cjlib_json_data), &pending)) {
+            ret = -1;
+            break;
+        }
+        ret = visit(&examine, arg);
+        if (-1 == ret) break;
+
+        if (CJLIB_OBJECT == examine.c_datatype) {
+            cjlib_dict_iter_begin(&entries, examine.c_value.c_obj);
+            while (0 == ret && cjlib_dict_iter_next(&entries, &key, &entry)) {
+                if (NULL != cjlib_json_data_fragment(entry))
+                    ret = cjlib_stack_push(entry, sizeof(struct cjlib_json_data), &pending);
+            }
+        } else {
+            CJLIB_LIST_FOR_EACH_PTR(item, examine.c_value.c_arr, struct cjlib_json_data) {
+                if (0 == ret && NULL != cjlib_json_data_fragment(item))
+                    ret = cjlib_stack_push(item, sizeof(struct cjlib_json_data), &pending);
+            }
+        }
+        if (-1 == ret) break;
+    }
+
+    while (!cjlib_stack_is_empty(&pending)) (void) cjlib_stack_pop(&examine, sizeof(struct cjlib_json_data), &pending);
+    return ret;
+}
+
+/**
+ * Visits an object and every object/array in it (see walk_values).
+ */
+static int walk_containers
+(cjlib_json_object *src, int (*visit)(struct cjlib_json_data *restrict container, void *arg), void *arg)
+{
+    struct cjlib_json_data examine;
+
+    examine.c_datatype    = CJLIB_OBJECT;
+    examine.c_value.c_obj = src;
+    return walk_values(&examine, visit, arg);
+}
+
+static int drop_fragment(struct cjlib_json_data *restrict container, void *arg)
+{
+    (void) arg;
+    // A dirty container may still hold clean ones, all of them are visited.
+    cjlib_fragment_drop(cjlib_json_data_fragment(container));
+    return 0;
+}
+
+void cjlib_json_cache_fragments(struct cjlib_json *restrict src, bool enable)
+{
+    // The cache would be written on the reads of a frozen json.
+    if (enable && cjlib_json_object_is_frozen(src->c_dict)) return;
+    if (!enable && src->c_cache) (void) walk_containers(src->c_dict, &drop_fragment, NULL);
+    src->c_cache = enable;
+}
+
+int cjlib_json_object_set_backend(cjlib_json_object *src, enum cjlib_dict_backend backend)
+{
+    if (-1 == cjlib_dict_set_backend(src, backend)) return -1;
+
+    // The entries may be visited in another order.
+    cjlib_fragment_invalidate(&src->d_fragment);
+    return 0;
+}
+
+static int set_object_backend(struct cjlib_json_data *restrict container, void *arg)
+{
+    if (CJLIB_OBJECT != container->c_datatype) return 0;
+    return cjlib_json_object_set_backend(container->c_value.c_obj, *((enum cjlib_dict_backend *) arg));
+}
+
+int cjlib_json_set_backend(struct cjlib_json *restrict src, enum cjlib_dict_backend backend)
+{
+    src->c_backend = backend;
+    return walk_containers(src->c_dict, &set_object_backend, &backend);
+}
+
+/**
+ * Counts a string that is not kept in its value.
+ */
+static CJLIB_ALWAYS_INLINE void account_string(struct cjlib_json_memory *restrict dst, const struct cjlib_json_data *src)
+{
+    if (CJLIB_STRING == src->c_datatype && !src->c_inline && NULL != src->c_value.c_str) {
+        cjlib_memory_account(dst, &dst->m_strings, src->c_value.c_str, strlen(src->c_value.c_str) + 1);
+    }
+}
+
+static int account_container(struct cjlib_json_data *restrict container, void *arg)
+{
+    struct cjlib_json_memory *dst = (struct cjlib_json_memory *) arg;
+    const cjlib_json_array *array = container->c_value.c_arr;
+    struct cjlib_dict_iter entries;
+    const struct cjlib_list_node *item;
+    struct cjlib_json_data *entry;
+    const char *key;
+
+    if (CJLIB_OBJECT == container->c_datatype) {
+        cjlib_dict_memory_usage(dst, container->c_value.c_obj);
+        cjlib_dict_iter_begin(&entries, container->c_value.c_obj);
+        while (cjlib_dict_iter_next(&entries, &key, &entry)) account_string(dst, entry);
+        return 0;
+    }
+
+    cjlib_memory_account(dst, &dst->m_containers, array, sizeof(cjlib_json_array));
+    cjlib_memory_account(dst, &dst->m_fragments, array->l_fragment.f_bytes, array->l_fragment.f_bytes_s);
+    for (item = array->l_head; NULL != item; item = item->l_next) {
+        cjlib_memory_account(dst, &dst->m_nodes, item, sizeof(struct cjlib_list_node));
+        cjlib_memory_account(dst, &dst->m_nodes, item->l_data, sizeof(struct cjlib_json_data));
+        account_string(dst, (const struct cjlib_json_data *) item->l_data);
+    }
+    return 0;
+}
+
+int cjlib_json_object_memory_usage(struct cjlib_json_memory *restrict dst, const cjlib_json_object *src)
+{
+    struct cjlib_json_data examine;
+
+    (void) memset(dst, 0x0, sizeof(struct cjlib_json_memory));
+    examine.c_datatype    = CJLIB_OBJECT;
+    examine.c_value.c_obj = (cjlib_json_object *) src;
+    return walk_values(&examine, &account_container, dst);
+}
+
+int cjlib_json_memory_usage(struct cjlib_json_memory *restrict dst, const struct cjlib_json *restrict src)
+{
+    if (-1 == cjlib_json_object_memory_usage(dst, src->c_dict)) return -1;
+
+    if (NULL != src->c_path) cjlib_memory_account(dst, &dst->m_strings, src->c_path, strlen(src->c_path) + 1);
+    cjlib_memory_spare_usage(dst, src->c_spare);
+    return 0;
+}
+
+static int freeze_container(struct cjlib_json_data *restrict container, void *arg)
+{
+    (void) arg;
+
+    if (CJLIB_ARRAY == container->c_datatype) {
+        container->c_value.c_arr->l_frozen = true;
+        return 0;
+    }
+
+    if (-1 == cjlib_dict_freeze(container->c_value.c_obj)) return -1;
+    // The entries are visited in the order of their keys from now on.
+    cjlib_fragment_invalidate(&container->c_value.c_obj->d_fragment);
+    return 0;
+}
+
+int cjlib_json_object_freeze(cjlib_json_object *src)
+{
+    return walk_containers(src, &freeze_container, NULL);
+}
+
+int cjlib_json_freeze(struct cjlib_json *restrict src)
+{
+    cjlib_json_cache_fragments(src, false);
+    return cjlib_json_object_freeze(src->c_dict);
+}
+
+static int persist_container(struct cjlib_json_data *restrict container, void *arg)
+{
+    const struct cjlib_json_data *root = (const struct cjlib_json_data *) arg;
+    struct cjlib_fragment *fragment    = cjlib_json_data_fragment(container);
+
+    // The arrays are shared as a whole by the versions, thus they never change.
+    if (CJLIB_ARRAY == container->c_datatype) {
+        container->c_value.c_arr->l_frozen = true;
+    } else if (!cjlib_json_object_is_persistent(container->c_value.c_obj)) {
+        if (-1 == cjlib_dict_persist(container->c_value.c_obj)) return -1;
+        // The entries are visited in the order of their keys from now on.
+        cjlib_fragment_invalidate(fragment);
+    }
+
+    // The contents may outlive the versions of their parent, that they are shared by.
+    if (root->c_value.c_obj != container->c_value.c_obj) {
+        fragment->f_parent = NULL;
+    }
+    return 0;
+}
+
+/**
+ * Makes an object/array, and every object/array in it, persistent (see cjlib_json_object_persist).
+ * An object that is persistent already (e.g., a version of a nested object) is left as it is,
+ * without visiting its contents.
+ *
+ * @param src The value (nothing is done to the values of the other types).
+ * @return 0 on success, otherwise -1.
+ */
+static int persist_value(struct cjlib_json_data *restrict src)
+{
+    if (NULL == cjlib_json_data_fragment(src)) return 0;
+    if (CJLIB_OBJECT == src->c_datatype && cjlib_json_object_is_persistent(src->c_value.c_obj)) return 0;
+    return walk_values(src, &persist_container, src);
+}
+
+int cjlib_json_object_persist(cjlib_json_object *src)
+{
+    struct cjlib_json_data root;
+
+    // The contents of an object that is persistent already, may be left over from a failure.
+    root.c_datatype    = CJLIB_OBJECT;
+    root.c_value.c_obj = src;
+    return walk_values(&root, &persist_container, &root);
+}
+
+int cjlib_json_persist(struct cjlib_json *restrict src)
+{
+    return cjlib_json_object_persist(src->c_dict);
+}
+
+int cjlib_json_handle_init(struct cjlib_json_handle *restrict dst)
+{
+    struct cjlib_json *first = (struct cjlib_json *) malloc(sizeof(struct cjlib_json));
+    if (NULL == first) return -1;
+
+    if (-1 == cjlib_json_init(first) || -1 == cjlib_json_freeze(first) ||
+        thrd_success != mtx_init(&dst->h_reload, mtx_plain)) {
+        cjlib_json_close(first);
+        free(first);
+        return -1;
+    }
+
+    atomic_init(&dst->h_current, first);
+    atomic_init(&dst->h_epoch, 0);
+    atomic_init(&dst->h_readers[0], 0);
+    atomic_init(&dst->h_readers[1], 0);
+    return 0;
+}
+
+void cjlib_json_handle_destroy(struct cjlib_json_handle *restrict src)
+{
+    struct cjlib_json *current = atomic_load(&src->h_current);
+
+    cjlib_json_close(current);
+    free(current);
+    mtx_destroy(&src->h_reload);
+}
+
+int cjlib_json_handle_publish(struct cjlib_json_handle *restrict src, struct cjlib_json *restrict json)
+{
+    struct cjlib_json *next = (struct cjlib_json *) malloc(sizeof(struct cjlib_json));
+    struct cjlib_json *prev;
+    unsigned int epoch;
+
+    if (NULL == next) {
+        cjlib_setup_error("", "", MEMORY_ERROR);
+        return -1;
+    }
+
+    if (-1 == cjlib_json_freeze(json) || thrd_success != mtx_lock(&src->h_reload)) {
+        cjlib_setup_error("", "", UNDEFINED);
+        free(next);
+        return -1;
+    }
+    (void) memcpy(next, json, sizeof(struct cjlib_json));
+    (void) memset(json, 0x0, sizeof(struct cjlib_json));
+
+    // The readers that enter from now on get the new version and are counted on the other parity.
+    prev  = atomic_exchange(&src->h_current, next);
+    epoch = atomic_fetch_add(&src->h_epoch, 1);
+
+    // Wait for the readers that may still hold the old version.
+    while (0 != atomic_load(&src->h_readers[epoch & 1])) (void) thrd_yield();
+    (void) mtx_unlock(&src->h_reload);
+
+    cjlib_json_close(prev);
+    free(prev);
+    return 0;
+}
+
+int cjlib_json_reload(struct cjlib_json_handle *restrict src, const struct cjlib_json_source *restrict json)
+{
+    struct cjlib_json_error error;
+    struct cjlib_json next;
+
+    (void) memset(&error, 0x0, sizeof(struct cjlib_json_error));
+    (void) memset(&next, 0x0, sizeof(struct cjlib_json));
+
+    // The new version is parsed (on the calling thread) before anything is locked.
+    if (-1 == cjlib_json_parse_many(&next, &error, json, 1, 1)) {
+        cjlib_setup_error(error.c_property_name, error.c_property_value, error.c_error_code);
+        cjlib_json_close(&next);
+        return -1;
+    }
+
+    if (-1 == cjlib_json_handle_publish(src, &next)) {
+        cjlib_json_close(&next);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * The state of a watcher (see cjlib_json_watch).
+ */
+struct cjlib_json_watcher
+{
+    char *w_path;                        // The path to the JSON file.
+    const char *w_name;                  // The name of the JSON file (in w_path).
+    int w_inotify;                       // The inotify instance, it watches the directory of the file.
+    int w_stop[2];                       // A pipe, the thread stops once it is written.
+    uint64_t w_hash;                     // The hash of the contents that were read last.
+    size_t w_size;                       // The size of the contents that were read last.
+    cjlib_json_watch_routine w_routine;  // The routine that receives each new version.
+    void *w_arg;                         // The argument to pass to w_routine.
+    thrd_t w_thread;                     // The thread that waits for the changes.
+};
+
+/**
+ * Reads the file of a watcher.
+ *
+ * @param src The watcher.
+ * @param dst_s Where to store the size of the contents.
+ * @return The contents, if they differ from the ones that were read last, otherwise NULL.
+ */
+static char *watcher_read(struct cjlib_json_watcher *restrict src, size_t *restrict dst_s)
+{
+    FILE *fp   = fopen(src->w_path, "r");
+    char *json = (NULL == fp) ? NULL : read_file(dst_s, fp);
+    uint64_t hash;
+
+    if (NULL != fp) (void) fclose(fp);
+    if (NULL == json) return NULL;
+
+    // Most rewrites of a configuration file leave it as it was.
+    hash = cjlib_dict_hash_key(json, *dst_s);
+    if (hash == src->w_hash && *dst_s == src->w_size) {
+        free(json);
+        return NULL;
+    }
+    src->w_hash = hash;
+    src->w_size = *dst_s;
+
+    return json;
+}
+
+/**
+ * Parses the file of a watcher and delivers it, if its contents changed.
+ */
+static void watcher_check(struct cjlib_json_watcher *restrict src)
+{
+    struct cjlib_json next;
+    size_t json_s = 0;
+    char *json    = watcher_read(src, &json_s);
+
+    if (NULL == json) return;
+
+    // A file that is not a valid json (e.g., it is written still) is not delivered.
+    if (-1 == cjlib_json_init(&next) || -1 == cjlib_json_parse(&next, json, json_s) ||
+        NULL == (next.c_path = strdup(src->w_path))) {
+        cjlib_json_close(&next);
+    } else {
+        src->w_routine(&next, src->w_arg);
+    }
+    free(json);
+}
+
+static int watcher_run(void *arg)
+{
+    struct cjlib_json_watcher *self = (struct cjlib_json_watcher *) arg;
+    _Alignas(struct inotify_event) char events[WATCH_EVENTS_SIZE];
+    const struct inotify_event *event;
+    struct pollfd fds[2];
+    ssize_t events_s;
+    bool changed;
+
+    fds[0].fd     = self->w_inotify;
+    fds[0].events = POLLIN;
+    fds[1].fd     = self->w_stop[0];
+    fds[1].events = POLLIN;
+
+    while (true) {
+        if (-1 == poll(fds, 2, -1)) {
+            if (EINTR == errno) continue;
+            break;
+        }
+        // The pipe is either written or closed (see cjlib_json_unwatch).
+        if (0 != fds[1].revents) return 0;
+
+        events_s = read(self->w_inotify, events, sizeof(events));
+        if (-1 == events_s && EINTR == errno) continue;
+        if (events_s <= 0) break;
+
+        // The events of a burst of writes are handled at once.
+        changed = false;
+        for (char *pos = events; pos < events + events_s; pos += sizeof(struct inotify_event) + event->len) {
+            event = (const struct inotify_event *) pos;
+            // On an overflow, the events of the file may be lost.
+            if (0 != (event->mask & IN_Q_OVERFLOW) || (0 != event->len && 0 == strcmp(event->name, self->w_name))) {
+                changed = true;
+            }
+        }
+        if (changed) watcher_check(self);
+    }
+
+    // The changes of the file can no longer be seen.
+    self->w_routine(NULL, self->w_arg);
+    return -1;
+}
+
+/**
+ * Frees a watcher, whose thread is not running.
+ */
+static void watcher_free(struct cjlib_json_watcher *restrict src)
+{
+    if (-1 != src->w_inotify) (void) close(src->w_inotify);
+    if (-1 != src->w_stop[0]) (void) close(src->w_stop[0]);
+    if (-1 != src->w_stop[1]) (void) close(src->w_stop[1]);
+    free(src->w_path);
+    free(src);
+}
+
+int cjlib_json_watch
+(struct cjlib_json_watcher **dst, const struct cjlib_json *restrict src,
+ cjlib_json_watch_routine routine, void *arg)
+{
+    struct cjlib_json_watcher *watcher;
+    char *directory;
+    char *slash;
+    size_t json_s = 0;
+    int ret;
+
+    if (NULL == src->c_path || NULL == routine) return -1;
+
+    watcher = (struct cjlib_json_watcher *) calloc(1, sizeof(struct cjlib_json_watcher));
+    if (NULL == watcher) return -1;
+    watcher->w_inotify = -1;
+    watcher->w_stop[0] = -1;
+    watcher->w_stop[1] = -1;
+    watcher->w_routine = routine;
+    watcher->w_arg     = arg;
+
+    watcher->w_path = strdup(src->c_path);
+    directory       = strdup(src->c_path);
+    if (NULL == watcher->w_path || NULL == directory) {
+        free(directory);
+        watcher_free(watcher);
+        return -1;
+    }
+
+    // The directory is watched, since a file is often replaced (renamed over) instead of written.
+    slash = strrchr(directory, '/');
+    watcher->w_name = (NULL == slash) ? watcher->w_path : watcher->w_path + (slash - directory) + 1;
+    if (NULL != slash) slash[(slash == directory) ? 1 : 0] = '\0';
+
+    watcher->w_inotify = inotify_init1(IN_CLOEXEC);
+    ret = (-1 == watcher->w_inotify ||
+           -1 == inotify_add_watch(watcher->w_inotify, (NULL == slash) ? "." : directory, IN_CLOSE_WRITE | IN_MOVED_TO) ||
+           -1 == pipe(watcher->w_stop)) ? -1 : 0;
+    free(directory);
+
+    // The current contents are the ones the caller has already.
+    if (0 == ret) free(watcher_read(watcher, &json_s));
+
+    if (-1 == ret || thrd_success != thrd_create(&watcher->w_thread, &watcher_run, (void *) watcher)) {
+        watcher_free(watcher);
+        return -1;
+    }
+
+    *dst = watcher;
+    return 0;
+}
+
+int cjlib_json_unwatch(struct cjlib_json_watcher *src)
+{
+    const char stop = 0;
+    ssize_t written;
+    int ret = 0;
+
+    if (NULL == src) return 0;
+
+    do {
+        written = write(src->w_stop[1], &stop, sizeof(stop));
+    } while (-1 == written && EINTR == errno);
+
+    // Closing the pipe wakes the thread up as well.
+    if (1 != written) {
+        (void) close(src->w_stop[1]);
+        src->w_stop[1] = -1;
+    }
+
+    // The thread uses the watcher until it returns.
+    if (thrd_success != thrd_join(src->w_thread, &ret)) ret = -1;
+    watcher_free(src);
+    return ret;
+}
+
+int cjlib_json_dump(const struct cjlib_json *restrict src)
+{
+    if (NULL == src->c_path) return -1;
+
+    // The jsons of cjlib_json_parse_many do not keep their file open.
+    FILE *fp = (NULL == src->c_fp) ? fopen(src->c_path, "w+") : freopen(src->c_path, "w+", src->c_fp);
+    if (NULL == fp) return -1;
+
+    const char *json_content = cjlib_json_stringtify(src);
+    if (NULL == json_content) {
+        if (NULL == src->c_fp) (void) fclose(fp);
+        return -1;
+    }
 
-    (void) fwrite((void *) json_content, strlen(json_content), 1, src->c_fp);
+    (void) fwrite((void *) json_content, strlen(json_content), 1, fp);
+    if (NULL == src->c_fp) (void) fclose(fp);
 
     free((void *) json_content);
     return 0;
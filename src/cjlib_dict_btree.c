@@ -0,0 +1,378 @@
+/* File: cjlib_dict_btree.c
+ *
+ * This file contains the B-tree backend of the dictionary. Each node holds
+ * up to CJLIB_DICT_BTREE_MAX_KEYS sorted entries, thus a lookup visits far
+ * fewer nodes than on the AVL tree, and the entries are kept in the order
+ * of their keys. The insertion splits the full nodes and the removal fills
+ * the minimal ones on the way down, so that both take a single pass.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <malloc.h>
+
+#include "cjlib.h"
+#include "cjlib_dictionary.h"
+#include "cjlib_dict_btree.h"
+
+// The minimum number of entries in a node (but the root).
+#define MIN_KEYS (CJLIB_DICT_BTREE_DEGREE - 1)
+
+typedef struct cjlib_dict_btree_node btree_node_t;
+
+/**
+ * Finds the first entry of a node whose key is not less than @key.
+ *
+ * @param found Where to store whether the key of that entry is @key.
+ * @return The index of the entry (the number of entries, if there is none).
+ */
+static size_t find_position
+(const btree_node_t *restrict node, uint64_t prefix, const char *restrict key, bool *restrict found)
+{
+    size_t i = 0;
+    int cmp  = 1;
+
+    for (; i < node->b_count; i++) {
+        cmp = cjlib_dict_key_compare(prefix, key, node->b_prefixes[i], node->b_entries[i]->avl_key);
+        if (cmp <= 0) break;
+    }
+
+    *found = (i < node->b_count && 0 == cmp);
+    return i;
+}
+
+static btree_node_t *make_node(bool leaf)
+{
+    btree_node_t *node = (btree_node_t *) cjlib_calloc(1, sizeof(btree_node_t));
+    if (NULL != node) node->b_leaf = leaf;
+    return node;
+}
+
+static CJLIB_ALWAYS_INLINE void set_entry
+(btree_node_t *restrict dst, size_t dst_i, const btree_node_t *restrict src, size_t src_i)
+{
+    dst->b_prefixes[dst_i] = src->b_prefixes[src_i];
+    dst->b_entries[dst_i]  = src->b_entries[src_i];
+}
+
+/**
+ * Moves the entries of a node, starting from @from, by one position to the right (@by = 1) or left (@by = -1).
+ */
+static CJLIB_ALWAYS_INLINE void shift_entries(btree_node_t *restrict node, size_t from, int by)
+{
+    size_t count = node->b_count - from;
+    (void) memmove(node->b_prefixes + from + by, node->b_prefixes + from, count * sizeof(uint64_t));
+    (void) memmove(node->b_entries + from + by, node->b_entries + from, count * sizeof(struct avl_bs_tree_node *));
+}
+
+/**
+ * Moves the children of a node, starting from @from, by one position to the right (@by = 1) or left (@by = -1).
+ */
+static CJLIB_ALWAYS_INLINE void shift_children(btree_node_t *restrict node, size_t from, int by)
+{
+    (void) memmove(node->b_children + from + by, node->b_children + from,
+                   (node->b_count + 1 - from) * sizeof(btree_node_t *));
+}
+
+struct avl_bs_tree_node *cjlib_dict_btree_search
+(const btree_node_t *root, uint64_t prefix, const char *restrict key)
+{
+    bool found;
+    size_t i;
+
+    while (NULL != root) {
+        i = find_position(root, prefix, key, &found);
+        if (found) return root->b_entries[i];
+        if (root->b_leaf) break;
+        root = root->b_children[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Splits the full child @i of @parent in two, its median entry moves to @parent.
+ *
+ * @return 0 on success, otherwise -1.
+ */
+static int split_child(btree_node_t *restrict parent, size_t i)
+{
+    btree_node_t *full  = parent->b_children[i];
+    btree_node_t *right = make_node(full->b_leaf);
+    if (NULL == right) return -1;
+
+    // The upper half goes to the new node.
+    right->b_count = MIN_KEYS;
+    (void) memcpy(right->b_prefixes, full->b_prefixes + CJLIB_DICT_BTREE_DEGREE, MIN_KEYS * sizeof(uint64_t));
+    (void) memcpy(right->b_entries, full->b_entries + CJLIB_DICT_BTREE_DEGREE,
+                  MIN_KEYS * sizeof(struct avl_bs_tree_node *));
+    if (!full->b_leaf) {
+        (void) memcpy(right->b_children, full->b_children + CJLIB_DICT_BTREE_DEGREE,
+                      CJLIB_DICT_BTREE_DEGREE * sizeof(btree_node_t *));
+    }
+    full->b_count = MIN_KEYS;
+
+    // The median goes to the parent, between the two halves.
+    shift_children(parent, i + 1, 1);
+    shift_entries(parent, i, 1);
+    set_entry(parent, i, full, MIN_KEYS);
+    parent->b_children[i + 1] = right;
+    parent->b_count          += 1;
+
+    return 0;
+}
+
+int cjlib_dict_btree_insert(btree_node_t **root, struct avl_bs_tree_node *entry)
+{
+    uint64_t prefix = entry->avl_prefix;
+    btree_node_t *node = *root;
+    btree_node_t *new_root;
+    bool found;
+    size_t i;
+
+    if (NULL == node) {
+        node = make_node(true);
+        if (NULL == node) return -1;
+        *root = node;
+    } else if (CJLIB_DICT_BTREE_MAX_KEYS == node->b_count) {
+        // The tree grows from the root.
+        new_root = make_node(false);
+        if (NULL == new_root) return -1;
+        new_root->b_children[0] = node;
+        if (-1 == split_child(new_root, 0)) {
+            cjlib_free(new_root);
+            return -1;
+        }
+        *root = node = new_root;
+    }
+
+    // Split every full node on the way down, so that the leaf has room for the entry.
+    while (!node->b_leaf) {
+        i = find_position(node, prefix, entry->avl_key, &found);
+        if (CJLIB_DICT_BTREE_MAX_KEYS == node->b_children[i]->b_count) {
+            if (-1 == split_child(node, i)) return -1;
+            if (cjlib_dict_key_compare(prefix, entry->avl_key, node->b_prefixes[i], node->b_entries[i]->avl_key) > 0) i += 1;
+        }
+        node = node->b_children[i];
+    }
+
+    i = find_position(node, prefix, entry->avl_key, &found);
+    shift_entries(node, i, 1);
+    node->b_prefixes[i] = prefix;
+    node->b_entries[i]  = entry;
+    node->b_count      += 1;
+
+    return 0;
+}
+
+/**
+ * Merges the child @i + 1 of a node, and the entry between them, into the child @i.
+ */
+static void merge_children(btree_node_t *restrict node, size_t i)
+{
+    btree_node_t *left  = node->b_children[i];
+    btree_node_t *right = node->b_children[i + 1];
+
+    set_entry(left, left->b_count, node, i);
+    (void) memcpy(left->b_prefixes + left->b_count + 1, right->b_prefixes, right->b_count * sizeof(uint64_t));
+    (void) memcpy(left->b_entries + left->b_count + 1, right->b_entries,
+                  right->b_count * sizeof(struct avl_bs_tree_node *));
+    if (!left->b_leaf) {
+        (void) memcpy(left->b_children + left->b_count + 1, right->b_children,
+                      (right->b_count + 1) * sizeof(btree_node_t *));
+    }
+    left->b_count += right->b_count + 1;
+
+    shift_entries(node, i + 1, -1);
+    shift_children(node, i + 2, -1);
+    node->b_count -= 1;
+    cjlib_free(right);
+}
+
+/**
+ * Moves an entry from the left sibling of the child @i, through the node, to the child @i.
+ */
+static void borrow_from_left(btree_node_t *restrict node, size_t i)
+{
+    btree_node_t *child   = node->b_children[i];
+    btree_node_t *sibling = node->b_children[i - 1];
+
+    shift_entries(child, 0, 1);
+    if (!child->b_leaf) shift_children(child, 0, 1);
+    set_entry(child, 0, node, i - 1);
+    if (!child->b_leaf) child->b_children[0] = sibling->b_children[sibling->b_count];
+    child->b_count += 1;
+
+    set_entry(node, i - 1, sibling, sibling->b_count - 1);
+    sibling->b_count -= 1;
+}
+
+/**
+ * Moves an entry from the right sibling of the child @i, through the node, to the child @i.
+ */
+static void borrow_from_right(btree_node_t *restrict node, size_t i)
+{
+    btree_node_t *child   = node->b_children[i];
+    btree_node_t *sibling = node->b_children[i + 1];
+
+    set_entry(child, child->b_count, node, i);
+    if (!child->b_leaf) child->b_children[child->b_count + 1] = sibling->b_children[0];
+    child->b_count += 1;
+
+    set_entry(node, i, sibling, 0);
+    shift_entries(sibling, 1, -1);
+    if (!sibling->b_leaf) shift_children(sibling, 1, -1);
+    sibling->b_count -= 1;
+}
+
+/**
+ * Makes sure that the child @i of a node has more than the minimum entries, so
+ * that an entry can be removed from its subtree.
+ *
+ * @return The index of the child that covers the same keys (it changes if the
+ *         child is merged into its left sibling).
+ */
+static size_t fill_child(btree_node_t *restrict node, size_t i)
+{
+    if (node->b_children[i]->b_count > MIN_KEYS) return i;
+
+    if (i > 0 && node->b_children[i - 1]->b_count > MIN_KEYS) {
+        borrow_from_left(node, i);
+    } else if (i < node->b_count && node->b_children[i + 1]->b_count > MIN_KEYS) {
+        borrow_from_right(node, i);
+    } else if (i < node->b_count) {
+        merge_children(node, i);
+    } else {
+        merge_children(node, i - 1);
+        return i - 1;
+    }
+
+    return i;
+}
+
+/**
+ * Removes a key, that exists, from the subtree of a node.
+ */
+static void remove_key(btree_node_t *node, uint64_t prefix, const char *key)
+{
+    btree_node_t *neighbour;
+    btree_node_t *next;
+    bool found;
+    size_t i;
+
+    while (true) {
+        i = find_position(node, prefix, key, &found);
+        if (node->b_leaf) {
+            shift_entries(node, i + 1, -1);
+            node->b_count -= 1;
+            return;
+        }
+
+        if (!found) {
+            node = node->b_children[fill_child(node, i)];
+            continue;
+        }
+
+        if (node->b_children[i]->b_count > MIN_KEYS) {
+            // Replace the entry by its predecessor, then remove the predecessor from the left subtree.
+            next = node->b_children[i];
+            for (neighbour = next; !neighbour->b_leaf;) neighbour = neighbour->b_children[neighbour->b_count];
+            set_entry(node, i, neighbour, neighbour->b_count - 1);
+        } else if (node->b_children[i + 1]->b_count > MIN_KEYS) {
+            // Replace the entry by its successor, then remove the successor from the right subtree.
+            next = node->b_children[i + 1];
+            for (neighbour = next; !neighbour->b_leaf;) neighbour = neighbour->b_children[0];
+            set_entry(node, i, neighbour, 0);
+        } else {
+            // Both children are minimal, the entry moves down to their merge.
+            merge_children(node, i);
+            node = node->b_children[i];
+            continue;
+        }
+
+        key    = node->b_entries[i]->avl_key;
+        prefix = node->b_prefixes[i];
+        node   = next;
+    }
+}
+
+struct avl_bs_tree_node *cjlib_dict_btree_remove(btree_node_t **root, uint64_t prefix, const char *restrict key)
+{
+    struct avl_bs_tree_node *removed = cjlib_dict_btree_search(*root, prefix, key);
+    btree_node_t *old_root;
+    if (NULL == removed) return NULL;
+
+    remove_key(*root, prefix, key);
+
+    // The tree shrinks from the root.
+    if (0 == (*root)->b_count) {
+        old_root = *root;
+        *root    = (old_root->b_leaf) ? NULL : old_root->b_children[0];
+        cjlib_free(old_root);
+    }
+
+    return removed;
+}
+
+static int inorder(struct cjlib_queue *restrict dst, const btree_node_t *node)
+{
+    for (size_t i = 0; i < node->b_count; i++) {
+        if (!node->b_leaf && -1 == inorder(dst, node->b_children[i])) return -1;
+        if (-1 == cjlib_queue_enqeue(&node->b_entries[i], sizeof(struct avl_bs_tree_node *), dst)) return -1;
+    }
+
+    return (node->b_leaf) ? 0 : inorder(dst, node->b_children[node->b_count]);
+}
+
+int cjlib_dict_btree_inorder(struct cjlib_queue *restrict dst, const btree_node_t *root)
+{
+    struct cjlib_queue nodes;
+    cjlib_queue_init(&nodes);
+
+    if (NULL != root && -1 == inorder(&nodes, root)) return -1;
+
+    (void) memcpy(dst, &nodes, sizeof(struct cjlib_queue));
+    return 0;
+}
+
+void cjlib_dict_btree_destroy
+(btree_node_t *root, void (*entry_disposal_routine)(struct avl_bs_tree_node *entry))
+{
+    if (NULL == root) return;
+
+    for (size_t i = 0; i < root->b_count; i++) {
+        if (!root->b_leaf) cjlib_dict_btree_destroy(root->b_children[i], entry_disposal_routine);
+        if (NULL != entry_disposal_routine) entry_disposal_routine(root->b_entries[i]);
+    }
+    if (!root->b_leaf) cjlib_dict_btree_destroy(root->b_children[root->b_count], entry_disposal_routine);
+
+    cjlib_free(root);
+}
+
+void cjlib_dict_btree_memory_usage(struct cjlib_json_memory *restrict dst, const btree_node_t *root)
+{
+    if (NULL == root) return;
+
+    cjlib_memory_account(dst, &dst->m_containers, root, sizeof(btree_node_t));
+    if (root->b_leaf) return;
+
+    for (size_t i = 0; i <= root->b_count; i++) cjlib_dict_btree_memory_usage(dst, root->b_children[i]);
+}
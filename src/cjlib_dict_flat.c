@@ -0,0 +1,166 @@
+/* File: cjlib_dict_flat.c
+ *
+ * This file contains the flat backend of the dictionary, used for the
+ * objects with a few keys. The entries are kept in a single block, sized
+ * to their number, and are searched linearly; the lengths of the keys
+ * are compared using SIMD instructions (when available) and the first
+ * 8 bytes of the keys as integers, so that the keys themselves are
+ * rarely read.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "cjlib.h"
+#include "cjlib_dict_flat.h"
+
+static CJLIB_ALWAYS_INLINE uint32_t key_length(size_t key_s)
+{
+    return (key_s < UINT32_MAX) ? (uint32_t) key_s : UINT32_MAX;
+}
+
+/**
+ * Finds the entries whose key has a specific length.
+ *
+ * @return A mask with a bit set for each matching entry.
+ */
+static CJLIB_ALWAYS_INLINE uint32_t match_lengths(const struct cjlib_dict_flat *restrict src, uint32_t length)
+{
+    uint32_t mask;
+
+    // The lengths of CJLIB_DICT_FLAT_SIZE slots are loaded even from a smaller block, the
+    // arrays after them (at least 40 bytes) keep the loads within the block.
+#if defined(__AVX2__) && 8 == CJLIB_DICT_FLAT_SIZE
+    __m256i lengths = _mm256_loadu_si256((const __m256i *) src->f_lengths);
+    __m256i found   = _mm256_cmpeq_epi32(lengths, _mm256_set1_epi32((int) length));
+    mask = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(found));
+#elif defined(__SSE2__) && 8 == CJLIB_DICT_FLAT_SIZE
+    const __m128i needle = _mm_set1_epi32((int) length);
+    __m128i low          = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) src->f_lengths), needle);
+    __m128i high         = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) (src->f_lengths + 4)), needle);
+    mask = (uint32_t) _mm_movemask_ps(_mm_castsi128_ps(low))
+           | ((uint32_t) _mm_movemask_ps(_mm_castsi128_ps(high)) << 4);
+#else
+    mask = 0;
+    for (size_t i = 0; i < src->f_size; i++) mask |= (uint32_t) (length == src->f_lengths[i]) << i;
+#endif
+
+    // Ignore the slots past the last entry.
+    return mask & (uint32_t) ((1ULL << src->f_size) - 1);
+}
+
+struct cjlib_dict_flat *cjlib_dict_flat_make(size_t capacity)
+{
+    struct cjlib_dict_flat *flat = (struct cjlib_dict_flat *) cjlib_malloc(cjlib_dict_flat_size(capacity));
+    if (NULL == flat) return NULL;
+
+    flat->f_size     = 0;
+    flat->f_capacity = (uint32_t) capacity;
+    return flat;
+}
+
+int cjlib_dict_flat_search
+(const struct cjlib_dict_flat *restrict src, uint64_t prefix, const char *restrict key, size_t key_s)
+{
+    if (NULL == src) return -1;
+
+    const uint64_t *prefixes = cjlib_dict_flat_prefixes(src);
+    char *const *keys        = cjlib_dict_flat_keys(src);
+    uint32_t match           = match_lengths(src, key_length(key_s));
+    int slot;
+
+    while (0 != match) {
+        slot = __builtin_ctz(match);
+        if (0 == cjlib_dict_key_compare(prefix, key, prefixes[slot], keys[slot])) return slot;
+        match &= match - 1;
+    }
+
+    return -1;
+}
+
+/**
+ * Gives a full block more slots. The arrays are moved from the last one, since each
+ * one starts further in the grown block.
+ *
+ * @param dst Where the block is stored.
+ * @return 0 on success, otherwise -1 (the block is left as it was).
+ */
+static int grow(struct cjlib_dict_flat **dst)
+{
+    struct cjlib_dict_flat *flat = *dst;
+    size_t capacity = (0 == flat->f_capacity) ? 1 : (size_t) flat->f_capacity * 2;
+    size_t size     = flat->f_size;
+    uint64_t *prefixes;
+    char **keys;
+    struct cjlib_json_data *values;
+
+    if (capacity > CJLIB_DICT_FLAT_SIZE) capacity = CJLIB_DICT_FLAT_SIZE;
+
+    flat = (struct cjlib_dict_flat *) cjlib_realloc(flat, cjlib_dict_flat_size(capacity));
+    if (NULL == flat) return -1;
+
+    prefixes = cjlib_dict_flat_prefixes(flat);
+    keys     = cjlib_dict_flat_keys(flat);
+    values   = cjlib_dict_flat_values(flat);
+
+    flat->f_capacity = (uint32_t) capacity;
+    (void) memmove(cjlib_dict_flat_values(flat), values, size * sizeof(struct cjlib_json_data));
+    (void) memmove(cjlib_dict_flat_keys(flat), keys, size * sizeof(char *));
+    (void) memmove(cjlib_dict_flat_prefixes(flat), prefixes, size * sizeof(uint64_t));
+
+    *dst = flat;
+    return 0;
+}
+
+int cjlib_dict_flat_append
+(struct cjlib_dict_flat **dst, char *key, size_t key_s, const struct cjlib_json_data *restrict value)
+{
+    size_t slot;
+
+    if (NULL == *dst && NULL == (*dst = cjlib_dict_flat_make(1))) return -1;
+    if ((*dst)->f_size == (*dst)->f_capacity && -1 == grow(dst)) return -1;
+
+    slot = (*dst)->f_size;
+    (*dst)->f_lengths[slot]                 = key_length(key_s);
+    cjlib_dict_flat_prefixes(*dst)[slot]    = cjlib_dict_key_prefix(key);
+    cjlib_dict_flat_keys(*dst)[slot]        = key;
+    (void) memcpy(&cjlib_dict_flat_values(*dst)[slot], value, sizeof(struct cjlib_json_data));
+    (*dst)->f_size += 1;
+
+    return 0;
+}
+
+void cjlib_dict_flat_remove(struct cjlib_dict_flat *restrict src, size_t slot)
+{
+    size_t last = src->f_size - 1;
+
+    if (slot != last) {
+        src->f_lengths[slot]                = src->f_lengths[last];
+        cjlib_dict_flat_prefixes(src)[slot] = cjlib_dict_flat_prefixes(src)[last];
+        cjlib_dict_flat_keys(src)[slot]     = cjlib_dict_flat_keys(src)[last];
+        (void) memcpy(&cjlib_dict_flat_values(src)[slot], &cjlib_dict_flat_values(src)[last],
+                      sizeof(struct cjlib_json_data));
+    }
+    src->f_size = (uint32_t) last;
+}
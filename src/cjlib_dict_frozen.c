@@ -0,0 +1,112 @@
+/* File: cjlib_dict_frozen.c
+ *
+ * This file contains the frozen backend of the dictionary, used for the
+ * objects that are only read once they are built (see cjlib_json_freeze).
+ * The entries, their keys and their values are kept in a single block, in
+ * the Eytzinger layout, thus a search moves from an entry to its children
+ * by their index and nothing is ever written on a search.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <malloc.h>
+
+#include "cjlib.h"
+#include "cjlib_dictionary.h"
+#include "cjlib_dict_frozen.h"
+
+// The prefixes of the entries 3 levels below an entry share a cache line.
+#define PREFETCH_DISTANCE (0x8)
+
+struct cjlib_dict_frozen *cjlib_dict_frozen_make(struct avl_bs_tree_node *const *nodes, size_t nodes_s)
+{
+    struct cjlib_dict_frozen *frozen;
+    struct cjlib_json_data *values;
+    struct avl_bs_tree_node *entry;
+    char *keys;
+    size_t keys_s = 0;
+    size_t index;
+
+    for (size_t i = 0; i < nodes_s; i++) keys_s += nodes[i]->avl_key_s + 1;
+
+    // The index 0 of the arrays is not used, the root of the implicit tree is at 1.
+    frozen = (struct cjlib_dict_frozen *) cjlib_malloc(sizeof(struct cjlib_dict_frozen) +
+                                                 (nodes_s + 1) * (sizeof(uint64_t) +
+                                                                  sizeof(struct avl_bs_tree_node) +
+                                                                  sizeof(struct cjlib_json_data)) + keys_s);
+    if (NULL == frozen) return NULL;
+
+    frozen->z_size     = nodes_s;
+    frozen->z_prefixes = (uint64_t *) (frozen + 1);
+    frozen->z_nodes    = (struct avl_bs_tree_node *) (frozen->z_prefixes + nodes_s + 1);
+    values             = (struct cjlib_json_data *) (frozen->z_nodes + nodes_s + 1);
+    keys               = (char *) (values + nodes_s + 1);
+
+    // Visiting the implicit tree in order gives the position of each entry, from the least key.
+    index = cjlib_dict_frozen_first(nodes_s);
+    for (size_t i = 0; i < nodes_s; i++) {
+        entry = &frozen->z_nodes[index];
+        (void) memcpy(keys, nodes[i]->avl_key, nodes[i]->avl_key_s + 1);
+        (void) memcpy(&values[index], nodes[i]->avl_data, sizeof(struct cjlib_json_data));
+
+        entry->avl_data   = &values[index];
+        entry->avl_key    = keys;
+        entry->avl_left   = NULL;
+        entry->avl_right  = NULL;
+        entry->avl_prefix = nodes[i]->avl_prefix;
+        entry->avl_key_s  = nodes[i]->avl_key_s;
+        entry->avl_height = 0;
+        frozen->z_prefixes[index] = nodes[i]->avl_prefix;
+
+        keys += nodes[i]->avl_key_s + 1;
+        index = cjlib_dict_frozen_next(nodes_s, index);
+    }
+
+    return frozen;
+}
+
+struct avl_bs_tree_node *cjlib_dict_frozen_search
+(const struct cjlib_dict_frozen *src, uint64_t prefix, const char *restrict key)
+{
+    size_t index = 1;
+    int cmp;
+
+    if (NULL == src) return NULL;
+
+    while (index <= src->z_size) {
+        if (PREFETCH_DISTANCE * index <= src->z_size) {
+            __builtin_prefetch(&src->z_prefixes[PREFETCH_DISTANCE * index]);
+        }
+
+        cmp = cjlib_dict_key_compare(prefix, key, src->z_prefixes[index], src->z_nodes[index].avl_key);
+        if (0 == cmp) return &src->z_nodes[index];
+        index = 2 * index + (size_t) (cmp > 0);
+    }
+
+    return NULL;
+}
+
+void cjlib_dict_frozen_destroy(struct cjlib_dict_frozen *src)
+{
+    if (NULL == src) return;
+
+    for (size_t i = 1; i <= src->z_size; i++) cjlib_json_data_destroy(src->z_nodes[i].avl_data);
+    cjlib_free(src);
+}
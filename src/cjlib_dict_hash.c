@@ -0,0 +1,295 @@
+/* File: cjlib_dict_hash.c
+ *
+ * This file contains the hash table backend of the dictionary. It is an
+ * open-addressing table in the manner of the Swiss tables: the slots are
+ * probed in groups of 16, whose control bytes are matched against the
+ * hash of the key using SIMD instructions (when available).
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <malloc.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "cjlib.h"
+#include "cjlib_dictionary.h"
+#include "cjlib_dict_hash.h"
+
+// The table grows once more than MAX_LOAD_NUM/MAX_LOAD_DEN of its slots are used.
+#define MAX_LOAD_NUM (0x7)
+#define MAX_LOAD_DEN (0x8)
+
+#define HASH_SEED  (0x9E3779B97F4A7C15ULL)
+#define HASH_MUL_1 (0xFF51AFD7ED558CCDULL)
+#define HASH_MUL_2 (0xC4CEB9FE1A85EC53ULL)
+
+#define ROTL64(WORD, BITS) (((WORD) << (BITS)) | ((WORD) >> (64 - (BITS))))
+
+// The low bits of the hash select the first group to probe.
+#define HASH_H1(HASH) ((size_t) (HASH))
+// The top 7 bits of the hash are kept in the control byte.
+#define HASH_H2(HASH) ((uint8_t) ((HASH) >> 57))
+
+static CJLIB_ALWAYS_INLINE uint64_t hash_finalize(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= HASH_MUL_1;
+    hash ^= hash >> 33;
+    hash *= HASH_MUL_2;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static CJLIB_ALWAYS_INLINE uint64_t hash_round(uint64_t hash, uint64_t word)
+{
+    hash ^= word * HASH_MUL_1;
+    return ROTL64(hash, 31) * HASH_MUL_2;
+}
+
+uint64_t cjlib_dict_hash_key(const char *restrict key, size_t key_s)
+{
+    uint64_t hash = HASH_SEED ^ ((uint64_t) key_s * HASH_MUL_2);
+    uint64_t word;
+
+    for (; key_s >= sizeof(uint64_t); key_s -= sizeof(uint64_t), key += sizeof(uint64_t)) {
+        (void) memcpy(&word, key, sizeof(uint64_t));
+        hash = hash_round(hash, word);
+    }
+
+    if (key_s > 0) {
+        word = 0;
+        (void) memcpy(&word, key, key_s);
+        hash = hash_round(hash, word);
+    }
+
+    return hash_finalize(hash);
+}
+
+/**
+ * Finds the slots of a group whose control byte is @byte.
+ *
+ * @param ctrl The control bytes of the group.
+ * @param byte The control byte to look for.
+ * @return A mask with a bit set for each matching slot.
+ */
+static CJLIB_ALWAYS_INLINE uint32_t group_match(const uint8_t *restrict ctrl, uint8_t byte)
+{
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char) byte)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < CJLIB_DICT_HASH_GROUP; i++) mask |= (uint32_t) (byte == ctrl[i]) << i;
+    return mask;
+#endif
+}
+
+/**
+ * Finds the slots of a group that hold no entry (either empty or deleted).
+ *
+ * @param ctrl The control bytes of the group.
+ * @return A mask with a bit set for each free slot.
+ */
+static CJLIB_ALWAYS_INLINE uint32_t group_match_free(const uint8_t *restrict ctrl)
+{
+#if defined(__SSE2__)
+    // Only the control bytes of the free slots have their top bit set.
+    return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) ctrl));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < CJLIB_DICT_HASH_GROUP; i++) mask |= (uint32_t) !CJLIB_DICT_HASH_IS_FULL(ctrl[i]) << i;
+    return mask;
+#endif
+}
+
+/**
+ * The smallest capacity that holds @size entries without exceeding the maximum load.
+ */
+static size_t capacity_for(size_t size)
+{
+    size_t capacity = CJLIB_DICT_HASH_GROUP;
+    while (capacity * MAX_LOAD_NUM < size * MAX_LOAD_DEN) capacity <<= 1;
+    return capacity;
+}
+
+/**
+ * Allocates the slots of a table. The control bytes, the hashes and the
+ * entries are kept in one block, one array after the other.
+ */
+static int table_alloc(struct cjlib_dict_hash *restrict dst, size_t capacity)
+{
+    uint8_t *block = (uint8_t *) cjlib_malloc(capacity * (sizeof(uint8_t) + sizeof(uint64_t)
+                                                    + sizeof(struct avl_bs_tree_node *)));
+    if (NULL == block) return -1;
+
+    (void) memset(block, CJLIB_DICT_HASH_EMPTY, capacity);
+    dst->h_ctrl     = block;
+    dst->h_hashes   = (uint64_t *) (block + capacity);
+    dst->h_slots    = (struct avl_bs_tree_node **) (dst->h_hashes + capacity);
+    dst->h_capacity = capacity;
+    dst->h_size     = 0;
+    dst->h_deleted  = 0;
+    return 0;
+}
+
+/**
+ * Puts an entry in the first free slot of its probe sequence.
+ */
+static void place_entry(struct cjlib_dict_hash *restrict dst, struct avl_bs_tree_node *entry, uint64_t hash)
+{
+    size_t groups_mask = dst->h_capacity / CJLIB_DICT_HASH_GROUP - 1;
+    size_t group       = HASH_H1(hash) & groups_mask;
+    size_t slot;
+    uint32_t match;
+
+    // The maximum load guarantees a free slot, the probing visits every group.
+    for (size_t step = 1; ; step++) {
+        match = group_match_free(dst->h_ctrl + group * CJLIB_DICT_HASH_GROUP);
+        if (0 != match) break;
+        group = (group + step) & groups_mask;
+    }
+
+    slot = group * CJLIB_DICT_HASH_GROUP + (size_t) __builtin_ctz(match);
+    if (CJLIB_DICT_HASH_DELETED == dst->h_ctrl[slot]) dst->h_deleted -= 1;
+
+    dst->h_ctrl[slot]   = HASH_H2(hash);
+    dst->h_hashes[slot] = hash;
+    dst->h_slots[slot]  = entry;
+    dst->h_size        += 1;
+}
+
+/**
+ * Moves the entries of a table into a new set of slots, which drops the deleted ones too.
+ */
+static int rehash(struct cjlib_dict_hash *restrict src, size_t capacity)
+{
+    struct cjlib_dict_hash table;
+    if (-1 == table_alloc(&table, capacity)) return -1;
+
+    for (size_t slot = 0; slot < src->h_capacity; slot++) {
+        if (CJLIB_DICT_HASH_IS_FULL(src->h_ctrl[slot])) {
+            place_entry(&table, src->h_slots[slot], src->h_hashes[slot]);
+        }
+    }
+
+    cjlib_free(src->h_ctrl);
+    (void) memcpy(src, &table, sizeof(struct cjlib_dict_hash));
+    return 0;
+}
+
+/**
+ * Finds the slot of a key.
+ *
+ * @return The slot, or the capacity of the table if the key does not exist.
+ */
+static size_t find_slot(const struct cjlib_dict_hash *restrict src, const char *restrict key, uint64_t hash)
+{
+    if (0 == src->h_capacity) return 0;
+
+    size_t groups_mask = src->h_capacity / CJLIB_DICT_HASH_GROUP - 1;
+    size_t group       = HASH_H1(hash) & groups_mask;
+    const uint8_t *ctrl;
+    size_t slot;
+    uint32_t match;
+
+    for (size_t step = 1; ; step++) {
+        ctrl  = src->h_ctrl + group * CJLIB_DICT_HASH_GROUP;
+        match = group_match(ctrl, HASH_H2(hash));
+        while (0 != match) {
+            slot = group * CJLIB_DICT_HASH_GROUP + (size_t) __builtin_ctz(match);
+            if (hash == src->h_hashes[slot] && 0 == strcmp(key, src->h_slots[slot]->avl_key)) return slot;
+            match &= match - 1;
+        }
+
+        // The key would have been put in the empty slot, if it existed.
+        if (0 != group_match(ctrl, CJLIB_DICT_HASH_EMPTY)) return src->h_capacity;
+        group = (group + step) & groups_mask;
+    }
+}
+
+int cjlib_dict_hash_init(struct cjlib_dict_hash *restrict dst, size_t size)
+{
+    (void) memset(dst, 0x0, sizeof(struct cjlib_dict_hash));
+    if (0 == size) return 0;
+
+    return table_alloc(dst, capacity_for(size));
+}
+
+struct avl_bs_tree_node *cjlib_dict_hash_search
+(const struct cjlib_dict_hash *restrict src, const char *restrict key, uint64_t hash)
+{
+    size_t slot = find_slot(src, key, hash);
+    return (slot == src->h_capacity) ? NULL : src->h_slots[slot];
+}
+
+void cjlib_dict_hash_prefetch(const struct cjlib_dict_hash *restrict src, uint64_t hash)
+{
+    if (0 == src->h_capacity) return;
+
+    size_t slot = (HASH_H1(hash) & (src->h_capacity / CJLIB_DICT_HASH_GROUP - 1)) * CJLIB_DICT_HASH_GROUP;
+
+    __builtin_prefetch(src->h_ctrl + slot);
+    __builtin_prefetch(src->h_hashes + slot);
+}
+
+int cjlib_dict_hash_insert
+(struct cjlib_dict_hash *restrict dst, struct avl_bs_tree_node *entry, uint64_t hash)
+{
+    size_t used = dst->h_size + dst->h_deleted + 1;
+
+    if (used * MAX_LOAD_DEN > dst->h_capacity * MAX_LOAD_NUM) {
+        // Either grow, or just reclaim the deleted slots when most of the used ones are deleted.
+        if (-1 == rehash(dst, capacity_for(dst->h_size + 1))) return -1;
+    }
+
+    place_entry(dst, entry, hash);
+    return 0;
+}
+
+struct avl_bs_tree_node *cjlib_dict_hash_remove
+(struct cjlib_dict_hash *restrict src, const char *restrict key, uint64_t hash)
+{
+    size_t slot = find_slot(src, key, hash);
+    if (slot == src->h_capacity) return NULL;
+
+    struct avl_bs_tree_node *entry = src->h_slots[slot];
+    const uint8_t *group           = src->h_ctrl + (slot & ~((size_t) CJLIB_DICT_HASH_GROUP - 1));
+
+    // A probe never passes a group with an empty slot, so the slot can become empty as well.
+    if (0 != group_match(group, CJLIB_DICT_HASH_EMPTY)) {
+        src->h_ctrl[slot] = CJLIB_DICT_HASH_EMPTY;
+    } else {
+        src->h_ctrl[slot] = CJLIB_DICT_HASH_DELETED;
+        src->h_deleted   += 1;
+    }
+    src->h_size -= 1;
+
+    return entry;
+}
+
+void cjlib_dict_hash_destroy(struct cjlib_dict_hash *restrict src)
+{
+    cjlib_free(src->h_ctrl);
+    (void) memset(src, 0x0, sizeof(struct cjlib_dict_hash));
+}
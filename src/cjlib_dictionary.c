@@ -2,7 +2,10 @@
  *
  * This file contains an implementation of a dictionary data structure.
  * The implementation is using the Binary search tree's representation
- * in order to achieve the best performance of O(log n).
+ * in order to achieve the best performance of O(log n). Large dictionaries
+ * can use a hash table (see cjlib_dict_hash.c) or a B-tree (see
+ * cjlib_dict_btree.c) instead and small ones a flat array (see
+ * cjlib_dict_flat.c).
  * File: cjlib_dictionary.c
  *
  ************************************************************************
@@ -24,20 +27,21 @@
  */
 
 #include <malloc.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <stdio.h>
 
 #include "cjlib_dictionary.h"
+#include "cjlib_dict_hash.h"
+#include "cjlib_dict_flat.h"
+#include "cjlib_dict_btree.h"
+#include "cjlib_dict_frozen.h"
 #include "cjlib.h"
 #include "cjlib_queue.h"
 #include "cjlib_stack.h"
 
-// Those constants are used in the search/insert/delete functions.
-#define S_RETRIEVE_KEY_NODE        (0x0)
-#define S_RETRIEVE_KEY_NODE_PARENT (0x1)
-
 // Those constants are used in the lvl_order_traversal function, for the delete_nodes flag.
 #define T_DONT_DELETE_NODES (0x0)
 #define T_DELETE_NODES      (0x1)
@@ -45,62 +49,27 @@
 // Those macros are used to determine if the AVL is balanced.
 #define T_TREE_HEIGHT_LEFT  (0x1)
 #define T_TREE_HEIGHT_RIGHT (-0x1)
-#define T_TREE_IS_BALANCED(B_FACTOR) (B_FACTOR <= T_TREE_HEIGHT_LEFT && B_FACTOR >= T_TREE_HEIGHT_RIGHT)
 
 // Determine the direction of a node.
 #define T_NODE_IS_LEFT(COMP)  (COMP < 0)
-#define T_NODE_IS_RIGHT(COMP) (COMP > 0)
-
-// Check whether the key comparison determines that the current node is root.
-#define T_NODE_IS_ROOT(COMP) (COMP == 0)
 
 // Determine if the imbalance of the tree is on the right or left subtree.
 #define T_IMBALANCE_ON_LEFT(B_FACTOR) (B_FACTOR > T_TREE_HEIGHT_LEFT)
 #define T_IMBALANCE_ON_RIGHT(B_FACTOR) (B_FACTOR < T_TREE_HEIGHT_RIGHT)
 
-// Determine if the node that deleted and caused the imbalance, was in the right or left of the tree.
-#define T_INCREASED_B_FACTOR_AFTER_DELETE (0x2)
-#define T_DECREASED_B_FACTOR_AFTER_DELETE (-0x2)
-
-#define T_DELETION_ON_LEFT_CHILD(B_FACTOR) (B_FACTOR == T_DECREASED_B_FACTOR_AFTER_DELETE)
-#define T_DELETION_ON_RIGHT_CHILD(B_FACTOR) (B_FACTOR == T_INCREASED_B_FACTOR_AFTER_DELETE)
-
-/**
- * Which type of rotation must be executed
- * on the imbalanced tree.
-*/
-enum rotation_type
-{
-    LL_ROTATION,
-    RR_ROTATION
-};
+#define T_MAX_PATH CJLIB_DICT_MAX_DEPTH
 
-/**
- * Which type of rotation must be executed
- * on the imbalanced tree, after right delete.
-*/
-enum rotation_after_right_deletion_type
-{
-    R0        = 0x0,
-    R1        = 0x1,
-    R_MINUS_1 = -0x1
-};
+// Whether the entries of a backend are kept in an AVL tree.
+#define T_BACKEND_IS_AVL(BACKEND) (CJLIB_DICT_AVL == (BACKEND) || CJLIB_DICT_PERSISTENT == (BACKEND))
 
-/**
- * Which type of rotation must be executed
- * on the imbalanced tree, after left delete.
-*/
-enum rotation_after_left_deletion_type
-{
-    L0        = 0x0,
-    L1        = 0x1,
-    L_MINUS_1 = -0x1
-};
+// Whether a dictionary is never changed in place (see cjlib_dict_freeze and cjlib_dict_persist).
+#define T_DICT_IS_READ_ONLY(DICT_PTR) \
+    (CJLIB_DICT_FROZEN == (DICT_PTR)->d_backend || CJLIB_DICT_PERSISTENT == (DICT_PTR)->d_backend)
 
 /**
  * Set every node of a AVL tree into a QEUEUE
  */
-int cjlib_dict_preorder(struct cjlib_queue *restrict dst, const struct avl_bs_tree_node *src)
+static int avl_preorder(struct cjlib_queue *restrict dst, const struct avl_bs_tree_node *src)
 {
     struct cjlib_stack pre_order_traversal_st; // The stack used for the preorder traversal.
     struct cjlib_queue pre_order_data_q; 
@@ -187,9 +156,8 @@ static size_t lvl_order_traversal(const struct avl_bs_tree_node *src, bool delet
 
             if (CJLIB_BRANCH_UNLIKELY(delete_nodes)) {
                 cjlib_json_data_destroy(tmp->avl_data); // TODO - IF the data are a dictionary, then put it to queue, in order to prevent stack overflow.
-                free(tmp->avl_data);
-                free(tmp->avl_key);
-                free(tmp);
+                cjlib_free(tmp->avl_key);
+                cjlib_free(tmp);
                 tmp = NULL;
             }
         }
@@ -202,12 +170,25 @@ static size_t lvl_order_traversal(const struct avl_bs_tree_node *src, bool delet
 /**
  * This function returns the height of a subtree.
  *
- * @param src A pointer that points to the root of the subtree.
+ * @param src A pointer that points to the root of the subtree (NULL for an empty subtree).
  * @returns The height of this subtree.
 */
-static inline size_t get_node_height(const struct avl_bs_tree_node *restrict src)
+static CJLIB_ALWAYS_INLINE int get_node_height(const struct avl_bs_tree_node *restrict src)
 {
-    return lvl_order_traversal(src, T_DONT_DELETE_NODES);
+    return (NULL == src) ? 0 : src->avl_height;
+}
+
+/**
+ * Updates the height of a node, using the heights of its children.
+ *
+ * @param src A pointer to the node.
+*/
+static CJLIB_ALWAYS_INLINE void update_node_height(struct avl_bs_tree_node *restrict src)
+{
+    int left_subtree_h  = get_node_height(src->avl_left);
+    int right_subtree_h = get_node_height(src->avl_right);
+
+    src->avl_height = 1 + ((left_subtree_h > right_subtree_h) ? left_subtree_h : right_subtree_h);
 }
 
 /**
@@ -219,159 +200,311 @@ static inline size_t get_node_height(const struct avl_bs_tree_node *restrict src
  *         - Negative value: The right subtree is taller.
  *         - 0: The subtrees have the same height.
 */
-static inline int calc_balance_factor(const struct avl_bs_tree_node *restrict src)
+static CJLIB_ALWAYS_INLINE int calc_balance_factor(const struct avl_bs_tree_node *restrict src)
 {
-    // Get the height of both children
-    int left_subtree_h  = get_node_height(src->avl_left) + 1;
-    int right_subtree_h = get_node_height(src->avl_right) + 1;
+    return get_node_height(src->avl_left) - get_node_height(src->avl_right);
+}
 
-    // Calculate the balance factor.
-    return (int) left_subtree_h - right_subtree_h;
+/**
+ * Compares a key with the key of a node (see cjlib_dict_key_compare).
+ *
+ * @param prefix The prefix of the key (see cjlib_dict_key_prefix).
+ * @param key A pointer to a constant character string representing the key.
+ * @param node A pointer to the node.
+ * @return Less than, equal or greater than zero if the key is less than, equal or greater than the key of the node.
+*/
+static CJLIB_ALWAYS_INLINE int compare_key
+(uint64_t prefix, const char *restrict key, const struct avl_bs_tree_node *restrict node)
+{
+    return cjlib_dict_key_compare(prefix, key, node->avl_prefix, node->avl_key);
 }
 
 /**
- * Retrieves a node with a specific key or its parent from an AVL tree.
+ * Fills the handle of a key for the operations on a dictionary, its hash is computed
+ * only when the backend requires it.
  *
- * This function searches the AVL tree pointed to by `dict` for a node whose key
- * matches the provided `key`. Depending on the value of `get_parent`, it
- * returns either the node itself or its parent.
+ * @param dst Where to store the handle.
+ * @param key A pointer to a constant character string representing the key.
+ * @param backend The backend of the dictionary.
+*/
+static CJLIB_ALWAYS_INLINE void make_key
+(struct cjlib_dict_key *restrict dst, const char *key, enum cjlib_dict_backend backend)
+{
+    dst->k_key    = key;
+    dst->k_key_s  = strlen(key);
+    dst->k_prefix = cjlib_dict_key_prefix(key);
+    dst->k_hash   = (CJLIB_DICT_HASH == backend) ? cjlib_dict_hash_key(key, dst->k_key_s) : 0;
+}
+
+/**
+ * Retrieves the node with a specific key from an AVL tree.
  *
  * @param dict A pointer to the root node of the AVL tree to search.
- * @param key A pointer to a constant character string representing the key.
- * @param get_parent A boolean flag indicating whether to retrieve the parent or the node itself.
- * @returns A pointer to either:
- *          - The node that holds the key, if `get_parent` is false and a match is found.
- *          - The parent of the node that holds the key, if `get_parent` is true and a match is found.
- *          - The last encountered parent during the search, if `get_parent` is true
- *            and no node with the specified key exists.
+ * @param key The handle of the key.
+ * @returns A pointer to the node that holds the key, or NULL if there is no such node.
 */
 static struct avl_bs_tree_node *search_node
-(const struct avl_bs_tree_node *dict, const char *restrict key,
- bool get_parent)
-{
-    struct avl_bs_tree_node *curr_node   = (struct avl_bs_tree_node *) dict;
-    struct avl_bs_tree_node *curr_parent = (struct avl_bs_tree_node *) dict;
-    int compare_key                      = 0;
-    while (curr_node) {
-        compare_key = strcmp(key, curr_node->avl_key);
-
-        if (compare_key == 0) break;
-        if (compare_key > 0 || compare_key < 0) curr_parent = curr_node;
-
-        if (compare_key > 0) {
-            curr_node = curr_node->avl_right;
-        } else if (compare_key < 0) {
-            curr_node = curr_node->avl_left;
-        } else {
-            break;
-        }
+(const struct avl_bs_tree_node *dict, const struct cjlib_dict_key *restrict key)
+{
+    int compare_keys;
+
+    while (NULL != dict) {
+        compare_keys = compare_key(key->k_prefix, key->k_key, dict);
+        if (0 == compare_keys) break;
+
+        dict = (T_NODE_IS_LEFT(compare_keys)) ? dict->avl_left : dict->avl_right;
     }
-    return (get_parent == S_RETRIEVE_KEY_NODE) ? curr_node : curr_parent;
+    return (struct avl_bs_tree_node *) dict;
 }
 
 /**
- * Searches for a node with a specific key in an AVL tree.
+ * Searches for the data of the entry with a specific key, in any backend.
  *
- * @param dst A pointer to the memory location where the data of the found node will be copied.
- * @param dict The root of the AVL tree.
- * @param key A pointer to a constant character string representing the key.
- * @return 0 on success, otherwise -1.
+ * @param dict A pointer to the dictionary.
+ * @param key The handle of the key.
+ * @return A pointer to the data, or NULL if there is no entry with such a key.
 */
+static struct cjlib_json_data *find_data(const cjlib_dict_t *restrict dict, const struct cjlib_dict_key *restrict key)
+{
+    const struct avl_bs_tree_node *node;
+    int slot;
+
+    switch (dict->d_backend) {
+        case CJLIB_DICT_HASH:
+            node = cjlib_dict_hash_search(&dict->d_hash, key->k_key, key->k_hash);
+            break;
+        case CJLIB_DICT_FLAT:
+            // The entries of a flat array are not kept in nodes.
+            slot = cjlib_dict_flat_search(dict->d_flat, key->k_prefix, key->k_key, key->k_key_s);
+            return (-1 == slot) ? NULL : &cjlib_dict_flat_values(dict->d_flat)[slot];
+        case CJLIB_DICT_BTREE:
+            node = cjlib_dict_btree_search(dict->d_btree, key->k_prefix, key->k_key);
+            break;
+        case CJLIB_DICT_FROZEN:
+            node = cjlib_dict_frozen_search(dict->d_frozen, key->k_prefix, key->k_key);
+            break;
+        default:
+            node = search_node(dict->d_root, key);
+            break;
+    }
+    return (NULL == node) ? NULL : node->avl_data;
+}
+
 int cjlib_dict_search
-(struct cjlib_json_data *restrict dst, const struct avl_bs_tree_node *restrict dict,
+(struct cjlib_json_data *restrict dst, const cjlib_dict_t *restrict dict,
  const char *restrict key)
 {
-    struct avl_bs_tree_node *tmp = search_node(dict, key, S_RETRIEVE_KEY_NODE);
+    struct cjlib_dict_key handle;
+    make_key(&handle, key, dict->d_backend);
+
+    return cjlib_dict_search_k(dst, dict, &handle);
+}
+
+int cjlib_dict_search_k
+(struct cjlib_json_data *restrict dst, const cjlib_dict_t *restrict dict,
+ const struct cjlib_dict_key *restrict key)
+{
+    struct cjlib_json_data *tmp = find_data(dict, key);
     if (NULL == tmp) {
         // There is no node with such a key.
         return -1;
     } else {
-        (void) memcpy(dst, tmp->avl_data, sizeof(struct cjlib_json_data));
+        (void) memcpy(dst, tmp, sizeof(struct cjlib_json_data));
     }
 
     return 0;
 }
 
+struct cjlib_json_data *cjlib_dict_lookup(const cjlib_dict_t *restrict dict, const char *restrict key)
+{
+    struct cjlib_dict_key handle;
+    make_key(&handle, key, dict->d_backend);
+
+    return cjlib_dict_lookup_k(dict, &handle);
+}
+
+struct cjlib_json_data *cjlib_dict_lookup_k
+(const cjlib_dict_t *restrict dict, const struct cjlib_dict_key *restrict key)
+{
+    return find_data(dict, key);
+}
+
 /**
- * Assigns a value to a specified key within an AVL tree node.
+ * Searches for several keys of an AVL tree at once. The keys are visited in the
+ * order of their key, thus the paths to them are walked together and each node
+ * is visited once at most.
  *
- * This function associates a given `value` with the provided `key` and stores them
- * together within the `dst` node.
- *
- * @param dst A pointer to the node where the key-value pair will be stored.
- * @param key A pointer to a constant character string representing the key.
- * @param value A pointer to a structure containing the data to be associated with the `key`.
- * @return 0 on success, otherwise -1.
+ * @param dst Where to store the data of each key (untouched if there is no such node).
+ * @param root A pointer to the root node of the AVL tree.
+ * @param keys The handles of the keys.
+ * @param order The positions of the keys in `keys` (and `dst`), sorted by key.
+ * @param order_s The number of positions.
 */
-static inline int assign_key_value_to_node
-(struct avl_bs_tree_node *restrict dst, const char *restrict key,
- const struct cjlib_json_data *restrict value)
+static void search_nodes
+(struct cjlib_json_data **dst, const struct avl_bs_tree_node *root,
+ const struct cjlib_dict_key *restrict keys, const size_t *order, size_t order_s)
 {
-    dst->avl_key  = (char *) strdup(key);
-    dst->avl_data = (struct cjlib_json_data *) malloc(sizeof(struct cjlib_json_data));
-    if (NULL == dst->avl_data) return -1;
+    const struct cjlib_dict_key *key;
+    int compare_keys = 0;
+    size_t less;
+
+    while (NULL != root && 0 != order_s) {
+        // The keys before the key of the root are in the left subtree.
+        for (less = 0; less < order_s; less++) {
+            key          = &keys[order[less]];
+            compare_keys = compare_key(key->k_prefix, key->k_key, root);
+            if (!T_NODE_IS_LEFT(compare_keys)) break;
+        }
+        search_nodes(dst, root->avl_left, keys, order, less);
+
+        // The same key may be requested more than once.
+        while (less < order_s && 0 == compare_keys) {
+            dst[order[less++]] = root->avl_data;
+            if (less < order_s) {
+                key          = &keys[order[less]];
+                compare_keys = compare_key(key->k_prefix, key->k_key, root);
+            }
+        }
 
-    (void) memcpy(dst->avl_data, value, sizeof(struct cjlib_json_data));
-    return 0;
+        // The rest are in the right subtree.
+        order   += less;
+        order_s -= less;
+        root     = root->avl_right;
+    }
 }
 
 /**
- * Finds the nearest ancestor of a given node in an AVL tree.
+ * Searches for a batch of keys (up to CJLIB_DICT_BATCH_SIZE), in any backend.
  *
- * @param node A pointer to the node for which to find the ancestor.
- * @param dict A pointer to the root node of the AVL tree.
- * @return A pointer to the ancestor node of `node`, or it's self (if there is not ancestor).
+ * @param dst Where to store the data of each key (NULL if there is no such node).
+ * @param dict A pointer to the dictionary.
+ * @param keys The keys.
+ * @param keys_s The number of keys.
 */
-static inline struct avl_bs_tree_node *get_ancestor_node
-(const struct avl_bs_tree_node *restrict node,
- const struct avl_bs_tree_node *restrict dict)
+static void find_all
+(struct cjlib_json_data **dst, const cjlib_dict_t *restrict dict,
+ const char *const *restrict keys, size_t keys_s)
+{
+    struct cjlib_dict_key handles[CJLIB_DICT_BATCH_SIZE];
+    size_t order[CJLIB_DICT_BATCH_SIZE];
+    size_t position;
+    size_t j;
+
+    for (size_t i = 0; i < keys_s; i++) {
+        make_key(&handles[i], keys[i], dict->d_backend);
+        dst[i] = NULL;
+    }
+
+    switch (dict->d_backend) {
+        case CJLIB_DICT_AVL:
+        case CJLIB_DICT_PERSISTENT:
+            // Sort the keys (insertion sort, most batches are small or sorted already).
+            for (size_t i = 0; i < keys_s; i++) {
+                position = i;
+                for (j = i; j > 0 && strcmp(keys[order[j - 1]], keys[position]) > 0; j--) order[j] = order[j - 1];
+                order[j] = position;
+            }
+            search_nodes(dst, dict->d_root, handles, order, keys_s);
+            break;
+        case CJLIB_DICT_HASH:
+            // Start loading the slots of every key, before waiting for any of them.
+            for (size_t i = 0; i < keys_s; i++) cjlib_dict_hash_prefetch(&dict->d_hash, handles[i].k_hash);
+            for (size_t i = 0; i < keys_s; i++) dst[i] = find_data(dict, &handles[i]);
+            break;
+        default:
+            for (size_t i = 0; i < keys_s; i++) dst[i] = find_data(dict, &handles[i]);
+            break;
+    }
+}
+
+size_t cjlib_dict_search_many
+(struct cjlib_json_data *restrict dst, const cjlib_dict_t *restrict dict,
+ const char *const *restrict keys, size_t keys_s)
 {
-    return search_node(dict, node->avl_key, S_RETRIEVE_KEY_NODE_PARENT);
+    struct cjlib_json_data *data[CJLIB_DICT_BATCH_SIZE];
+    size_t batch_s;
+    size_t found = 0;
+
+    for (size_t done = 0; done < keys_s; done += batch_s) {
+        batch_s = (keys_s - done < CJLIB_DICT_BATCH_SIZE) ? keys_s - done : CJLIB_DICT_BATCH_SIZE;
+        find_all(data, dict, keys + done, batch_s);
+
+        for (size_t i = 0; i < batch_s; i++) {
+            if (NULL == data[i]) continue;
+            (void) memcpy(&dst[done + i], data[i], sizeof(struct cjlib_json_data));
+            found += 1;
+        }
+    }
+
+    return found;
 }
 
 /**
- * Performs either a left-left (LL) or right-right (RR) rotation in an AVL tree.
+ * A node along with its data, allocated at once: the data of a node are never
+ * freed apart from it.
+ */
+struct node_block
+{
+    struct avl_bs_tree_node b_node; // The node, its data point to b_data.
+    struct cjlib_json_data b_data;  // The data of the node.
+};
+
+/**
+ * Allocates a node (zeroed), along with the space of its data.
  *
- * This function is used to maintain balance within an AVL tree. It takes a node
- * (`src`) as input, along with the current root of the tree (`dict`). Based on the
- * specified rotation type (`rotation`), it performs either a left-left (LL) rotation
- * or a right-right (RR) rotation around `src`. The function may update the root
- * pointer (`dict`) to reflect the new root after the rotation.
+ * @return A pointer to the new node, otherwise NULL.
+ */
+static struct avl_bs_tree_node *alloc_node(void)
+{
+    struct node_block *block = (struct node_block *) cjlib_calloc(1, sizeof(struct node_block));
+    if (NULL == block) return NULL;
+
+    block->b_node.avl_data = &block->b_data;
+    return &block->b_node;
+}
+
+/**
+ * Makes a new node, that holds a key-value pair.
  *
- * @param src A pointer to the node to be rotated around.
- * @param dict A pointer to a pointer to the root node of the AVL tree. This value
- *              may be updated by the function.
- * @param rotation The type of rotation to perform:
- *                 - `LL_ROTATION`: Perform a left-left (LL) rotation.
- *                 - `RR_ROTATION`: Perform a right-right (RR) rotation.
- */
-static void balance_rotation
-(struct avl_bs_tree_node *src, struct avl_bs_tree_node **restrict dict,
- enum rotation_type rotation)
-{
-    struct avl_bs_tree_node *node_A   = src;
-    struct avl_bs_tree_node *node_B   = (rotation == LL_ROTATION) ? node_A->avl_left : node_A->avl_right;
-    struct avl_bs_tree_node *parent_A = get_ancestor_node(node_A, *dict);
-
-    int compare_keys = strcmp(node_A->avl_key, parent_A->avl_key);
-
-    // (1), (2). Replace A with B and update the linkage.
-    if (T_NODE_IS_LEFT(compare_keys)) {
-        parent_A->avl_left = node_B;
-    } else if (T_NODE_IS_RIGHT(compare_keys)) {
-        parent_A->avl_right = node_B;
-    } else {
-        *dict = node_B;
-    }
+ * @param key The handle of the key (the key is copied).
+ * @param value A pointer to a structure containing the data to be associated with the `key`.
+ * @return A pointer to the new node, otherwise NULL.
+*/
+static struct avl_bs_tree_node *make_node
+(const struct cjlib_dict_key *restrict key, const struct cjlib_json_data *restrict value)
+{
+    struct avl_bs_tree_node *dst = alloc_node();
+    if (NULL == dst) return NULL;
 
-    // Link the node A to the right place from B.
-    if (LL_ROTATION == rotation) {
-        node_A->avl_left  = node_B->avl_right;
-        node_B->avl_right = node_A;
-    } else {
-        node_A->avl_right = node_B->avl_left;
-        node_B->avl_left  = node_A;
+    dst->avl_key = (char *) cjlib_malloc(key->k_key_s + 1);
+    if (NULL == dst->avl_key) {
+        cjlib_free(dst);
+        return NULL;
     }
+
+    (void) memcpy(dst->avl_key, key->k_key, key->k_key_s + 1);
+    dst->avl_key_s  = key->k_key_s;
+    dst->avl_prefix = key->k_prefix;
+    (void) memcpy(dst->avl_data, value, sizeof(struct cjlib_json_data));
+    return dst;
+}
+
+/**
+ * Frees a node that is no longer part of the dictionary (but not its data).
+ */
+static inline void free_node(struct avl_bs_tree_node *restrict src)
+{
+    cjlib_free(src->avl_key);
+    cjlib_free(src);
+}
+
+/**
+ * Frees a node and its data.
+ */
+static void destroy_node(struct avl_bs_tree_node *src)
+{
+    cjlib_json_data_destroy(src->avl_data);
+    free_node(src);
 }
 
 /**
@@ -380,10 +513,10 @@ static void balance_rotation
  * This function adjusts the tree structure around the provided node (`src`)
  * to maintain the AVL tree's balance property.
  *
- * @param src  A pointer to the node to be rotated around.
- * @param dict A pointer to a pointer to the root node of the AVL tree.
+ * @param src A pointer to the node to be rotated around.
+ * @return The new root of the subtree, to be linked in the place of `src`.
  */
-static inline void ll_rotation(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+static CJLIB_ALWAYS_INLINE struct avl_bs_tree_node *ll_rotation(struct avl_bs_tree_node *src)
 {
     /**    |            |
      *     A            B
@@ -395,10 +528,19 @@ static inline void ll_rotation(struct avl_bs_tree_node *restrict src, struct avl
      * 1. Replace A with B (root of the left subtree).
      * 2. Put A on the right of B (by changing the linkage).
      * 3. Put the right subtree of B on the left of A.
-     * 4. Change, if exists, the link to the ancestors, which before the rotation was linked to A.
+     * 4. The caller links B to the ancestor, which before the rotation was linked to A.
      * (This comments help me visualize the tree)
     */
-    balance_rotation(src, dict, LL_ROTATION);
+    struct avl_bs_tree_node *node_A = src;
+    struct avl_bs_tree_node *node_B = node_A->avl_left;
+
+    node_A->avl_left  = node_B->avl_right;
+    node_B->avl_right = node_A;
+
+    // A is now below B, so its height comes first.
+    update_node_height(node_A);
+    update_node_height(node_B);
+    return node_B;
 }
 
 /**
@@ -407,10 +549,10 @@ static inline void ll_rotation(struct avl_bs_tree_node *restrict src, struct avl
  * This function adjusts the tree structure around the provided node (`src`)
  * to maintain the AVL tree's balance property.
  *
- * @param src  A pointer to the node to be rotated around.
- * @param dict A pointer to a pointer to the root node of the AVL tree.
+ * @param src A pointer to the node to be rotated around.
+ * @return The new root of the subtree, to be linked in the place of `src`.
  */
-static inline void rr_rotation(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+static CJLIB_ALWAYS_INLINE struct avl_bs_tree_node *rr_rotation(struct avl_bs_tree_node *src)
 {
     /**
      *  |               |
@@ -424,336 +566,1469 @@ static inline void rr_rotation(struct avl_bs_tree_node *restrict src, struct avl
      * 1. Replace A with B (root of the right subtree).
      * 2. Put A on the left of B.
      * 3. Put the left subtree of B on the right of A.
-     * 4. Change, if exists, the link to the ancestors, which before the rotation was linked to A.
+     * 4. The caller links B to the ancestor, which before the rotation was linked to A.
      * (This comments help me visualize the tree)
     */
-    balance_rotation(src, dict, RR_ROTATION);
+    struct avl_bs_tree_node *node_A = src;
+    struct avl_bs_tree_node *node_B = node_A->avl_right;
+
+    node_A->avl_right = node_B->avl_left;
+    node_B->avl_left  = node_A;
+
+    update_node_height(node_A);
+    update_node_height(node_B);
+    return node_B;
 }
 
 /**
- * Performs a right-left (RL) rotation in an AVL tree.
- *
- * This function adjusts the tree structure around the provided node (`src`)
- * to maintain the AVL tree's balance property.
+ * Performs a left-right (LR) rotation in an AVL tree, i.e., an RR rotation on
+ * the left child of `src` followed by an LL rotation on `src`.
  *
- * @param src  A pointer to the node to be rotated around.
- * @param dict A pointer to a pointer to the root node of the AVL tree.
+ * @param src A pointer to the node to be rotated around.
+ * @return The new root of the subtree, to be linked in the place of `src`.
  */
-static inline void rl_rotation(struct avl_bs_tree_node *src, struct avl_bs_tree_node **restrict dict)
+static CJLIB_ALWAYS_INLINE struct avl_bs_tree_node *lr_rotation(struct avl_bs_tree_node *src)
 {
-    struct avl_bs_tree_node *node_A = src;
-    struct avl_bs_tree_node *node_B = node_A->avl_left;
-    rr_rotation(node_B, dict);
-    ll_rotation(node_A, dict);
+    src->avl_left = rr_rotation(src->avl_left);
+    return ll_rotation(src);
 }
 
 /**
- * Performs a left-right (LR) rotation in an AVL tree.
- *
- * This function adjusts the tree structure around the provided node (`src`)
- * to maintain the AVL tree's balance property.
+ * Performs a right-left (RL) rotation in an AVL tree, i.e., an LL rotation on
+ * the right child of `src` followed by an RR rotation on `src`.
  *
- * @param src  A pointer to the node to be rotated around.
- * @param dict A pointer to a pointer to the root node of the AVL tree.
+ * @param src A pointer to the node to be rotated around.
+ * @return The new root of the subtree, to be linked in the place of `src`.
  */
-static inline void lr_rotation(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+static CJLIB_ALWAYS_INLINE struct avl_bs_tree_node *rl_rotation(struct avl_bs_tree_node *src)
 {
-    struct avl_bs_tree_node *node_A = src;
-    struct avl_bs_tree_node *node_B = node_A->avl_right;
-    ll_rotation(node_B, dict);
-    rr_rotation(node_A, dict);
+    src->avl_right = ll_rotation(src->avl_right);
+    return rr_rotation(src);
 }
 
 /**
- * Find the node A and store it in dst.
- * @param dst Where to store the balance factor.
- * @param parent The parent of the node that had inserted/deleted.
- * @param dict The dictionary.
- * @return A pointer to the Node A
-*/
-static inline struct avl_bs_tree_node *find_node_A
-(int *dst, const struct avl_bs_tree_node *parent,
- const struct avl_bs_tree_node **dict)
+ * Restores the balance of a node, whose subtrees differ in height by at most two.
+ *
+ * @param src A pointer to the node.
+ * @return The root of the balanced subtree, to be linked in the place of `src`.
+ */
+static struct avl_bs_tree_node *balance_rotation(struct avl_bs_tree_node *src)
 {
-    struct avl_bs_tree_node *node_A = (struct avl_bs_tree_node *) parent;
     int balance_factor;
-    int is_it_root = 0;
 
-    do {
-        node_A         = get_ancestor_node(node_A, *dict);
-        is_it_root     = strcmp(node_A->avl_key, (*dict)->avl_key);
-        balance_factor = calc_balance_factor(node_A);
-        //} while (is_it_root != 0 && T_TREE_IS_BALANCED(balance_factor));
-    } while (!T_NODE_IS_ROOT(is_it_root) && T_TREE_IS_BALANCED(balance_factor));
+    update_node_height(src);
+    balance_factor = calc_balance_factor(src);
 
-    *dst = balance_factor;
-    return node_A;
+    if (T_IMBALANCE_ON_LEFT(balance_factor)) {
+        // The left child is balanced only after a deletion, then a single rotation is enough.
+        return (calc_balance_factor(src->avl_left) >= 0) ? ll_rotation(src) : lr_rotation(src);
+    }
+    if (T_IMBALANCE_ON_RIGHT(balance_factor)) {
+        return (calc_balance_factor(src->avl_right) <= 0) ? rr_rotation(src) : rl_rotation(src);
+    }
+    return src;
 }
 
 /**
- * Restores the balance of an AVL tree after a node insertion.
+ * Restores the balance of an AVL tree after a node insertion/deletion, from the
+ * bottom of the path up to the root.
  *
- * @param new_node_parent A pointer to the parent of the newly inserted node.
- * @param dict A pointer to the root node of the AVL tree.
- * @param compared_keys An indicator specifying the relative position of the new node to its parent.
-*/
-static inline void perform_rotation_after_insert
-(const struct avl_bs_tree_node *new_node_parent,
- struct avl_bs_tree_node **dict, int comopared_keys)
+ * @param path The links to the nodes above the inserted/deleted node, the first is the link to the root.
+ * @param path_s The number of links.
+ */
+static void balance_path(struct avl_bs_tree_node **path[], size_t path_s)
 {
-    struct avl_bs_tree_node *node_A = (struct avl_bs_tree_node *) new_node_parent;
-    int balance_factor;
+    struct avl_bs_tree_node **link;
+    int height;
 
-    node_A = find_node_A(&balance_factor, new_node_parent, (const struct avl_bs_tree_node **) dict);
+    while (path_s > 0) {
+        link   = path[--path_s];
+        height = (*link)->avl_height;
+        *link  = balance_rotation(*link);
 
-    // If every node above are balanced, then no rotation has to be done.
-    if (T_TREE_IS_BALANCED(balance_factor)) return;
-
-    if (T_NODE_IS_LEFT(comopared_keys) && T_IMBALANCE_ON_LEFT(balance_factor)) {
-        // LL rotation.
-        ll_rotation(node_A, dict);
-    } else if (T_NODE_IS_RIGHT(comopared_keys) && T_IMBALANCE_ON_RIGHT(balance_factor)) {
-        // RR rotation.
-        rr_rotation(node_A, dict);
-    } else if (T_NODE_IS_RIGHT(comopared_keys) && T_IMBALANCE_ON_LEFT(balance_factor)) {
-        // RL (two rotations).
-        rl_rotation(node_A, dict);
-    } else {
-        // LR (two rotations).
-        lr_rotation(node_A, dict);
+        // The nodes above are not affected, if the height of this subtree is the same.
+        if (height == (*link)->avl_height) break;
     }
 }
 
-int cjlib_dict_insert
-(const struct cjlib_json_data *restrict src, struct avl_bs_tree_node **dict,
- const char *restrict key)
+/**
+ * Links a new node into an AVL tree, that has no node with the same key.
+ *
+ * @param root A pointer to the root of the AVL tree.
+ * @param new_node The node, with its key set (see make_node).
+*/
+static void avl_insert_node(struct avl_bs_tree_node **root, struct avl_bs_tree_node *new_node)
 {
-    // No root currently exists.
-    if (NULL == (*dict)->avl_key) {
-        (*dict)->avl_left = (*dict)->avl_right = NULL;
-        if (-1 == assign_key_value_to_node(*dict, key, src)) return -1;
-
-        return 0;
-    }
-
-    struct cjlib_json_data tmp;
-    struct avl_bs_tree_node *parent;
-    struct avl_bs_tree_node *new_node;
+    struct avl_bs_tree_node **path[T_MAX_PATH];
+    struct avl_bs_tree_node **link = root;
+    size_t path_s                  = 0;
     int compare_keys;
-    // A node with this key, already exists.
-    if (0 == cjlib_dict_search(&tmp, *dict, key)) return -1;
-    // Retrieve the node that will be the parent of node that holds the key.
-    parent = search_node(*dict, key, S_RETRIEVE_KEY_NODE_PARENT);
-
-    // Make the new node.
-    new_node = (struct avl_bs_tree_node *) malloc(sizeof(struct avl_bs_tree_node));
-    if (NULL == new_node) return -1;
-    cjlib_dict_init(new_node);
-
-    if (-1 == assign_key_value_to_node(new_node, key, src)) return -1;
 
-    // Decide where to put the new node.
-    compare_keys = strcmp(key, parent->avl_key);
-
-    if (T_NODE_IS_RIGHT(compare_keys)) {
-        parent->avl_right = new_node;
-    } else {
-        parent->avl_left = new_node;
+    // Retrieve the place of the new node, along with the path to it.
+    while (NULL != *link) {
+        path[path_s++] = link;
+        compare_keys   = compare_key(new_node->avl_prefix, new_node->avl_key, *link);
+        link           = (T_NODE_IS_LEFT(compare_keys)) ? &(*link)->avl_left : &(*link)->avl_right;
     }
-    perform_rotation_after_insert(parent, dict, compare_keys);
 
-    return 0;
-}
+    new_node->avl_left   = NULL;
+    new_node->avl_right  = NULL;
+    new_node->avl_height = 1;
+    *link                = new_node;
 
-static CJLIB_ALWAYS_INLINE void r0_rotation
-(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
-{
-    // LL
-    ll_rotation(src, dict);
+    balance_path(path, path_s);
 }
 
-static CJLIB_ALWAYS_INLINE void r1_rotation
-(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+/**
+ * The backend that a policy selects for a dictionary of a specific size.
+ */
+static CJLIB_ALWAYS_INLINE enum cjlib_dict_backend resolve_backend(enum cjlib_dict_backend policy, size_t size)
 {
-    // same os R0
-    r0_rotation(src, dict);
+    switch (policy) {
+        case CJLIB_DICT_AUTO:
+            if (size <= CJLIB_DICT_FLAT_SIZE) return CJLIB_DICT_FLAT;
+            return (size > CJLIB_DICT_HASH_THRESHOLD) ? CJLIB_DICT_HASH : CJLIB_DICT_AVL;
+        case CJLIB_DICT_FLAT:
+            return (size <= CJLIB_DICT_FLAT_SIZE) ? CJLIB_DICT_FLAT : CJLIB_DICT_AVL;
+        default:
+            return policy;
+    }
 }
 
-static CJLIB_ALWAYS_INLINE void r_minus_1_rotation
-(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+/**
+ * The backend that the policy of a dictionary selects for one more entry. A dictionary only
+ * moves up (flat, AVL, hash) on an insertion, thus one that shrank by its removals does not
+ * move back and forth around a threshold.
+ */
+static CJLIB_ALWAYS_INLINE enum cjlib_dict_backend grow_backend(const cjlib_dict_t *dict)
 {
-    // LR
-    lr_rotation(src, dict);
-}
+    enum cjlib_dict_backend target = resolve_backend(dict->d_policy, dict->d_size + 1);
 
-static CJLIB_ALWAYS_INLINE void l0_rotation
-(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
-{
-    // RR
-    rr_rotation(src, dict);
+    if (CJLIB_DICT_HASH == dict->d_backend || (CJLIB_DICT_AVL == dict->d_backend && CJLIB_DICT_FLAT == target)) {
+        return dict->d_backend;
+    }
+    return target;
 }
 
-static CJLIB_ALWAYS_INLINE void l1_rotation
-(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+static int move_entries(cjlib_dict_t *dict, enum cjlib_dict_backend target);
+
+/**
+ * Moves the entries of a dictionary to the backend that its policy selects for
+ * one more entry (see grow_backend).
+ *
+ * @param dict A pointer to the dictionary.
+ * @return 0 if there is room for the entry, otherwise -1 (always, on a frozen/persistent dictionary).
+ */
+static int make_room(cjlib_dict_t *dict)
 {
-    // RL
-    rl_rotation(src, dict);
+    enum cjlib_dict_backend target = grow_backend(dict);
+
+    // A frozen/persistent dictionary is never changed.
+    if (T_DICT_IS_READ_ONLY(dict)) return -1;
+
+    // If the move fails, the entries stay where they are.
+    if (target != dict->d_backend && -1 == move_entries(dict, target) &&
+        CJLIB_DICT_FLAT == dict->d_backend && CJLIB_DICT_FLAT_SIZE == dict->d_size) return -1;
+
+    return 0;
 }
 
-static CJLIB_ALWAYS_INLINE void l_minus_1_rotation
-(struct avl_bs_tree_node *restrict src, struct avl_bs_tree_node **restrict dict)
+int cjlib_dict_insert
+(const struct cjlib_json_data *restrict src, cjlib_dict_t *dict,
+ const char *restrict key)
 {
-    // Same as L0
-    l0_rotation(src, dict);
+    struct cjlib_dict_key handle;
+
+    if (-1 == make_room(dict)) return -1;
+    make_key(&handle, key, dict->d_backend);
+
+    return cjlib_dict_insert_k(src, dict, &handle);
 }
 
-static inline int perform_actions_after_right_deletion(struct avl_bs_tree_node *node_A, struct avl_bs_tree_node **dict)
+/**
+ * Inserts a new element, whose key does not exist, into a dictionary that has room for it (see make_room).
+ *
+ * @param src  A pointer to the `cjlib_json_data` structure containing the data to be inserted.
+ * @param dict A pointer to the dictionary.
+ * @param key  The handle of the key (with its hash, if the backend is the hash table).
+ * @return 0 on success, -1 otherwise.
+ */
+static int insert_absent
+(const struct cjlib_json_data *restrict src, cjlib_dict_t *dict,
+ const struct cjlib_dict_key *restrict key)
 {
-    // Get the balance factor of the left child.
-    int balance_factor_of_lchild = calc_balance_factor(node_A->avl_left);
+    struct avl_bs_tree_node *new_node;
+    char *new_key;
+
+    if (CJLIB_DICT_FLAT == dict->d_backend) {
+        new_key = (char *) cjlib_malloc(key->k_key_s + 1);
+        if (NULL == new_key) return -1;
+        (void) memcpy(new_key, key->k_key, key->k_key_s + 1);
+        if (-1 == cjlib_dict_flat_append(&dict->d_flat, new_key, key->k_key_s, src)) {
+            cjlib_free(new_key);
+            return -1;
+        }
 
-    // Distinguish the posible senarios
-    switch (balance_factor_of_lchild) {
-        case R0:
-            r0_rotation(node_A, dict);
-            break;
-        case R1:
-            r1_rotation(node_A, dict);
+        dict->d_size += 1;
+        return 0;
+    }
+
+    new_node = make_node(key, src);
+    if (NULL == new_node) return -1;
+
+    switch (dict->d_backend) {
+        case CJLIB_DICT_HASH:
+            if (-1 == cjlib_dict_hash_insert(&dict->d_hash, new_node, key->k_hash)) {
+                free_node(new_node);
+                return -1;
+            }
             break;
-        case R_MINUS_1:
-            r_minus_1_rotation(node_A, dict);
+        case CJLIB_DICT_BTREE:
+            if (-1 == cjlib_dict_btree_insert(&dict->d_btree, new_node)) {
+                free_node(new_node);
+                return -1;
+            }
             break;
         default:
+            avl_insert_node(&dict->d_root, new_node);
             break;
     }
+    dict->d_size += 1;
 
-    return balance_factor_of_lchild;
+    return 0;
 }
 
-static inline int perform_actions_after_left_deletion(struct avl_bs_tree_node *node_A, struct avl_bs_tree_node **dict)
+int cjlib_dict_insert_k
+(const struct cjlib_json_data *restrict src, cjlib_dict_t *dict,
+ const struct cjlib_dict_key *restrict key)
 {
-    // Get the balance factor of the left child.
-    int balance_factor_of_rchild = calc_balance_factor(node_A->avl_right);
+    // Make room for the new entry (a no-op, if cjlib_dict_insert did so).
+    if (-1 == make_room(dict)) return -1;
 
-    // Distinguish the posible senarios
-    switch (balance_factor_of_rchild) {
-        case L0:
-            l0_rotation(node_A, dict);
-            break;
-        case L1:
-            l1_rotation(node_A, dict);
-            break;
-        case L_MINUS_1:
-            l_minus_1_rotation(node_A, dict);
-            break;
-        default:
-            break;
-    }
+    // A node with this key, already exists.
+    if (NULL != find_data(dict, key)) return -1;
 
-    return balance_factor_of_rchild;
+    return insert_absent(src, dict, key);
 }
 
-static void perform_rotation_after_delete
-(struct avl_bs_tree_node *deleted_node_place,
- struct avl_bs_tree_node **dict)
+int cjlib_dict_upsert
+(struct cjlib_json_data *restrict old, const struct cjlib_json_data *restrict src,
+ cjlib_dict_t *dict, const char *restrict key)
 {
-    struct avl_bs_tree_node *node_A      = (struct avl_bs_tree_node *) deleted_node_place;
-    struct avl_bs_tree_node *prev_node_A = (struct avl_bs_tree_node *) deleted_node_place;
-
-    int balance_factor_of_A = 0;
-    int balance_factor_of_B = 0; // B is the sibling of the child where the deletion take place.
+    struct cjlib_dict_key handle;
+    enum cjlib_dict_backend target = grow_backend(dict);
 
-    balance_factor_of_A = calc_balance_factor(deleted_node_place);
-    do {
-        if (T_DELETION_ON_LEFT_CHILD(balance_factor_of_A)) {
-            balance_factor_of_B = perform_actions_after_left_deletion(node_A, dict);
-        } else if (T_DELETION_ON_RIGHT_CHILD(balance_factor_of_A)) {
-            balance_factor_of_B = perform_actions_after_right_deletion(node_A, dict);
-        }
-        if (R0 == balance_factor_of_B || L0 == balance_factor_of_B) break;
+    // The hash is needed if the dictionary is, or becomes on the insertion, a hash table.
+    make_key(&handle, key, (CJLIB_DICT_HASH == target) ? target : dict->d_backend);
 
-        prev_node_A = node_A;
-        node_A      = find_node_A(&balance_factor_of_A, deleted_node_place, (const struct avl_bs_tree_node **) dict);
-    } while (strcmp(prev_node_A->avl_key, node_A->avl_key) != 0);
-    // When the two keys are equal, then we had reached root.
+    return cjlib_dict_upsert_k(old, src, dict, &handle);
 }
 
-int cjlib_dict_remove(struct avl_bs_tree_node **dict, const char *restrict key)
+int cjlib_dict_upsert_k
+(struct cjlib_json_data *restrict old, const struct cjlib_json_data *restrict src,
+ cjlib_dict_t *dict, const struct cjlib_dict_key *restrict key)
 {
-    if (NULL == (*dict)->avl_key) return 0;
+    struct cjlib_json_data *data;
 
-    struct cjlib_json_data tmp_d;
-    struct avl_bs_tree_node *parent;
-    struct avl_bs_tree_node *removed;
+    if (T_DICT_IS_READ_ONLY(dict)) return -1;
+
+    // The key exists, replace its data in place.
+    data = find_data(dict, key);
+    if (NULL != data) {
+        (void) memcpy(old, data, sizeof(struct cjlib_json_data));
+        (void) memcpy(data, src, sizeof(struct cjlib_json_data));
+        return 1;
+    }
+
+    if (-1 == make_room(dict)) return -1;
+    return insert_absent(src, dict, key);
+}
+
+/**
+ * Unlinks the node with a specific key from an AVL tree.
+ *
+ * @param root A pointer to the root of the AVL tree.
+ * @param key The handle of the key.
+ * @return The node (it is not freed), or NULL if there is no node with such a key.
+*/
+static struct avl_bs_tree_node *avl_remove(struct avl_bs_tree_node **root, const struct cjlib_dict_key *restrict key)
+{
+    struct avl_bs_tree_node **path[T_MAX_PATH];
+    struct avl_bs_tree_node **link = root;
+    struct avl_bs_tree_node **largest_key_of_left_subtree_link;
     struct avl_bs_tree_node *largest_key_of_left_subtree;
-    struct avl_bs_tree_node *largest_key_of_left_subtree_parent;
-    struct avl_bs_tree_node *tmp_n;
-    struct avl_bs_tree_node *child_of_removed;
+    struct avl_bs_tree_node *removed;
+    size_t path_s = 0;
+    size_t removed_at;
     int compare_keys;
-    int is_root;
+
+    // Retrieve the node, along with the path to it.
+    while (NULL != *link && 0 != (compare_keys = compare_key(key->k_prefix, key->k_key, *link))) {
+        path[path_s++] = link;
+        link           = (T_NODE_IS_LEFT(compare_keys)) ? &(*link)->avl_left : &(*link)->avl_right;
+    }
+
     // There is no node with such a key.
-    if (-1 == cjlib_dict_search(&tmp_d, *dict, key)) return -1;
-    is_root      = (!strcmp(key, (*dict)->avl_key)) ? 1 : 0;
-    parent       = search_node(*dict, key, S_RETRIEVE_KEY_NODE_PARENT);
-    compare_keys = strcmp(key, parent->avl_key);
-
-    removed = (is_root) ? (*dict) : (T_NODE_IS_RIGHT(compare_keys)) ? parent->avl_right : parent->avl_left;
-
-    if (NULL != removed->avl_left && NULL != removed->avl_right) {
-        // Case (2), There two children under removed node.
-        largest_key_of_left_subtree = removed->avl_left;
-        tmp_n                       = removed->avl_left;
-        // Move to the largest key of the left subtree of removed node.
-        while (tmp_n) {
-            largest_key_of_left_subtree = tmp_n;
-            tmp_n                       = tmp_n->avl_right;
+    removed = *link;
+    if (NULL == removed) return NULL;
+
+    if (NULL == removed->avl_left || NULL == removed->avl_right) {
+        // Case (1), The child of the removed node (if any) takes its place.
+        *link = (NULL != removed->avl_left) ? removed->avl_left : removed->avl_right;
+    } else {
+        // Case (2), There two children under removed node, the largest key of the left subtree takes its place.
+        removed_at     = path_s;
+        path[path_s++] = link;
+
+        largest_key_of_left_subtree_link = &removed->avl_left;
+        while (NULL != (*largest_key_of_left_subtree_link)->avl_right) {
+            path[path_s++]                   = largest_key_of_left_subtree_link;
+            largest_key_of_left_subtree_link = &(*largest_key_of_left_subtree_link)->avl_right;
         }
 
-        largest_key_of_left_subtree_parent = search_node(*dict, largest_key_of_left_subtree->avl_key,
-                                                         S_RETRIEVE_KEY_NODE_PARENT);
+        largest_key_of_left_subtree       = *largest_key_of_left_subtree_link;
+        *largest_key_of_left_subtree_link = largest_key_of_left_subtree->avl_left;
 
-        free(removed->avl_key);
-        removed->avl_key = strdup(largest_key_of_left_subtree->avl_key);
-        (void) memcpy(removed->avl_data, largest_key_of_left_subtree->avl_data, sizeof(struct cjlib_json_data));
-        //(void) memcpy(largest_key_of_left_subtree->avl_data, removed->avl_data, sizeof(struct cjlib_json_data));
+        largest_key_of_left_subtree->avl_left   = removed->avl_left;
+        largest_key_of_left_subtree->avl_right  = removed->avl_right;
+        largest_key_of_left_subtree->avl_height = removed->avl_height;
+        *link                                   = largest_key_of_left_subtree;
 
-        removed = largest_key_of_left_subtree;
-        parent  = largest_key_of_left_subtree_parent;
+        // The left subtree hangs now from the node that took the place of the removed one.
+        if (removed_at + 1 < path_s) path[removed_at + 1] = &largest_key_of_left_subtree->avl_left;
     }
 
-    // Remove the node from the tree.
-    if (removed->avl_left) child_of_removed = removed->avl_left;
-    else child_of_removed                   = removed->avl_right;
+    balance_path(path, path_s);
+    return removed;
+}
 
-    if (is_root) {
-        *dict = child_of_removed;
-    } else {
-        if (parent->avl_left == removed) {
-            parent->avl_left = child_of_removed;
-        } else {
-            parent->avl_right = child_of_removed;
-        }
-    }
-    /*
-    if (parent->avl_left == removed) {
-        parent->avl_left = child_of_removed;
-    } else {
-        parent->avl_right = child_of_removed;
-    }*/
+int cjlib_dict_remove(cjlib_dict_t *dict, const char *restrict key)
+{
+    struct cjlib_dict_key handle;
+    make_key(&handle, key, dict->d_backend);
+
+    return cjlib_dict_remove_k(dict, &handle);
+}
+
+int cjlib_dict_remove_k(cjlib_dict_t *dict, const struct cjlib_dict_key *restrict key)
+{
+    struct avl_bs_tree_node *removed;
+    int slot;
 
-    perform_rotation_after_delete(removed, dict);
+    switch (dict->d_backend) {
+        case CJLIB_DICT_HASH:
+            removed = cjlib_dict_hash_remove(&dict->d_hash, key->k_key, key->k_hash);
+            if (NULL == removed) return -1;
+            free_node(removed);
+            break;
+        case CJLIB_DICT_FLAT:
+            slot = cjlib_dict_flat_search(dict->d_flat, key->k_prefix, key->k_key, key->k_key_s);
+            if (-1 == slot) return -1;
+            cjlib_free(cjlib_dict_flat_keys(dict->d_flat)[slot]);
+            cjlib_dict_flat_remove(dict->d_flat, (size_t) slot);
+            break;
+        case CJLIB_DICT_BTREE:
+            removed = cjlib_dict_btree_remove(&dict->d_btree, key->k_prefix, key->k_key);
+            if (NULL == removed) return -1;
+            free_node(removed);
+            break;
+        case CJLIB_DICT_FROZEN:
+        case CJLIB_DICT_PERSISTENT:
+            return -1;
+        default:
+            removed = avl_remove(&dict->d_root, key);
+            if (NULL == removed) return -1;
+            free_node(removed);
+            break;
+    }
+    dict->d_size -= 1;
 
-    free(removed->avl_key);
-    free(removed->avl_data);
-    free(removed);
-    removed = NULL;
     return 0;
 }
 
-size_t cjlib_dict_destroy(cjlib_dict_t *dict)
+int cjlib_dict_preorder(struct cjlib_queue *restrict dst, const cjlib_dict_t *src)
 {
-    size_t size = lvl_order_traversal(dict, T_DELETE_NODES);
-    //free(dict);
+    struct cjlib_queue nodes;
+    struct avl_bs_tree_node *node;
+    size_t pos = 0;
+
+    if (T_BACKEND_IS_AVL(src->d_backend)) return avl_preorder(dst, src->d_root);
+    if (CJLIB_DICT_BTREE == src->d_backend) return cjlib_dict_btree_inorder(dst, src->d_btree);
+    // The entries of a flat array are not kept in nodes.
+    if (CJLIB_DICT_FLAT == src->d_backend) return -1;
+
+    cjlib_queue_init(&nodes);
+    if (CJLIB_DICT_HASH == src->d_backend) {
+        while (NULL != (node = cjlib_dict_hash_next(&src->d_hash, &pos))) {
+            if (-1 == cjlib_queue_enqeue(&node, sizeof(struct avl_bs_tree_node *), &nodes)) return -1;
+        }
+    } else if (CJLIB_DICT_FROZEN == src->d_backend) {
+        for (pos = cjlib_dict_frozen_first(src->d_size); 0 != pos; pos = cjlib_dict_frozen_next(src->d_size, pos)) {
+            node = &src->d_frozen->z_nodes[pos];
+            if (-1 == cjlib_queue_enqeue(&node, sizeof(struct avl_bs_tree_node *), &nodes)) return -1;
+        }
+    }
+    (void) memcpy(dst, &nodes, sizeof(struct cjlib_queue));
+
+    return 0;
+}
+
+/**
+ * Pushes a subtree in the path of an iterator, down to its first entry.
+ *
+ * @param dst The iterator.
+ * @param src The root of the subtree (an AVL or a B-tree node, depending on the backend).
+ */
+static void iter_descend(struct cjlib_dict_iter *restrict dst, const void *src)
+{
+    const struct cjlib_dict_btree_node *btree_node;
+
+    if (T_BACKEND_IS_AVL(dst->i_dict->d_backend)) {
+        for (const struct avl_bs_tree_node *node = src; NULL != node; node = node->avl_left) {
+            dst->i_path[dst->i_depth++] = node;
+        }
+        return;
+    }
+
+    for (btree_node = src; NULL != btree_node; btree_node = btree_node->b_children[0]) {
+        dst->i_slots[dst->i_depth]  = 0;
+        dst->i_path[dst->i_depth++] = btree_node;
+        if (btree_node->b_leaf) break;
+    }
+}
+
+void cjlib_dict_iter_begin(struct cjlib_dict_iter *restrict dst, const cjlib_dict_t *src)
+{
+    dst->i_dict  = src;
+    dst->i_pos   = 0;
+    dst->i_depth = 0;
+
+    if (T_BACKEND_IS_AVL(src->d_backend)) iter_descend(dst, src->d_root);
+    else if (CJLIB_DICT_BTREE == src->d_backend) iter_descend(dst, src->d_btree);
+    else if (CJLIB_DICT_FROZEN == src->d_backend) dst->i_pos = cjlib_dict_frozen_first(src->d_size);
+}
+
+/**
+ * Gives the next node of a walk over a dictionary that is not a flat array.
+ *
+ * @param src The iterator.
+ * @return The next node, or NULL if there are no more entries.
+ */
+static cjlib_dict_node_t *iter_next_node(struct cjlib_dict_iter *restrict src)
+{
+    const struct avl_bs_tree_node *node;
+    const struct cjlib_dict_btree_node *btree_node;
+    const cjlib_dict_t *dict = src->i_dict;
+    size_t slot;
+
+    switch (dict->d_backend) {
+        case CJLIB_DICT_HASH:
+            return cjlib_dict_hash_next(&dict->d_hash, &src->i_pos);
+        case CJLIB_DICT_FROZEN:
+            if (0 == src->i_pos) return NULL;
+            slot        = src->i_pos;
+            src->i_pos  = cjlib_dict_frozen_next(dict->d_size, slot);
+            return &dict->d_frozen->z_nodes[slot];
+        case CJLIB_DICT_BTREE:
+            while (src->i_depth > 0) {
+                btree_node = src->i_path[src->i_depth - 1];
+                slot       = src->i_slots[src->i_depth - 1];
+                if (slot == btree_node->b_count) {
+                    // Every entry of the node is visited, go back to its parent.
+                    src->i_depth -= 1;
+                    continue;
+                }
+
+                // The entries of the subtree on the right of the entry come next.
+                src->i_slots[src->i_depth - 1] += 1;
+                if (!btree_node->b_leaf) iter_descend(src, btree_node->b_children[slot + 1]);
+                return btree_node->b_entries[slot];
+            }
+            return NULL;
+        default:
+            if (0 == src->i_depth) return NULL;
+
+            // The left subtree of the node is visited, the right subtree comes next.
+            node = src->i_path[--src->i_depth];
+            iter_descend(src, node->avl_right);
+            return (cjlib_dict_node_t *) node;
+    }
+}
+
+bool cjlib_dict_iter_next
+(struct cjlib_dict_iter *restrict src, const char **restrict key, struct cjlib_json_data **restrict data)
+{
+    const struct cjlib_dict_flat *flat = src->i_dict->d_flat;
+    cjlib_dict_node_t *node;
+
+    // The entries of a flat array are not kept in nodes.
+    if (CJLIB_DICT_FLAT == src->i_dict->d_backend) {
+        if (NULL == flat || src->i_pos >= flat->f_size) return false;
+        *key  = cjlib_dict_flat_keys(flat)[src->i_pos];
+        *data = &cjlib_dict_flat_values(flat)[src->i_pos++];
+        return true;
+    }
+
+    node = iter_next_node(src);
+    if (NULL == node) return false;
+
+    *key  = CJLIB_DICT_NODE_KEY(node);
+    *data = CJLIB_DICT_NODE_DATA(node);
+    return true;
+}
+
+/**
+ * Fills a node with an entry of a flat array, the key is shared with the array.
+ *
+ * @param dst The node (its data point to its own space, see alloc_node).
+ * @param src The entries.
+ * @param slot The slot of the entry.
+ */
+static void flat_node(struct avl_bs_tree_node *restrict dst, const struct cjlib_dict_flat *restrict src, size_t slot)
+{
+    dst->avl_key    = cjlib_dict_flat_keys(src)[slot];
+    dst->avl_key_s  = cjlib_dict_flat_key_size(src, slot);
+    dst->avl_prefix = cjlib_dict_flat_prefixes(src)[slot];
+    (void) memcpy(dst->avl_data, &cjlib_dict_flat_values(src)[slot], sizeof(struct cjlib_json_data));
+}
+
+/**
+ * Frees a node that was detached from a flat array (see gather_nodes), but not
+ * its key, which the array still owns.
+ */
+static void free_detached_node(struct avl_bs_tree_node *src)
+{
+    cjlib_free(src);
+}
+
+/**
+ * Empties a queue of gathered nodes (see gather_nodes).
+ *
+ * @param src The queue.
+ * @param detached Whether the nodes were detached from a flat array (such nodes are freed).
+ */
+static void release_nodes(struct cjlib_queue *restrict src, bool detached)
+{
+    struct avl_bs_tree_node *node;
+
+    while (!cjlib_queue_is_empty(src)) {
+        cjlib_queue_deqeue((void *) &node, sizeof(struct avl_bs_tree_node *), src);
+        if (detached) free_detached_node(node);
+    }
+}
+
+/**
+ * Gathers the nodes of a dictionary in a queue. The entries of a flat array get
+ * nodes of their own, their keys are shared with the array.
+ *
+ * @param dst Where to store the queue.
+ * @param src The dictionary.
+ * @return 0 on success, otherwise -1.
+ */
+static int gather_nodes(struct cjlib_queue *restrict dst, const cjlib_dict_t *restrict src)
+{
+    const struct cjlib_dict_flat *flat = src->d_flat;
+    struct avl_bs_tree_node *node;
+
+    if (CJLIB_DICT_FLAT != src->d_backend) return cjlib_dict_preorder(dst, src);
+
+    cjlib_queue_init(dst);
+    for (size_t i = 0; NULL != flat && i < flat->f_size; i++) {
+        node = alloc_node();
+        if (NULL == node || -1 == cjlib_queue_enqeue(&node, sizeof(struct avl_bs_tree_node *), dst)) {
+            if (NULL != node) free_detached_node(node);
+            release_nodes(dst, true);
+            return -1;
+        }
+
+        flat_node(node, flat, i);
+    }
+
+    return 0;
+}
+
+/**
+ * Builds a B-tree out of a queue of gathered nodes (see gather_nodes).
+ *
+ * @param dst Where to store the root of the B-tree.
+ * @param src The queue, it is emptied on success.
+ * @param detached Whether the nodes were detached from a flat array.
+ * @return 0 on success, otherwise -1 (the nodes that are not yet in the queue are freed, if detached).
+ */
+static int fill_btree(struct cjlib_dict_btree_node **dst, struct cjlib_queue *restrict src, bool detached)
+{
+    struct cjlib_dict_btree_node *root = NULL;
+    struct avl_bs_tree_node *node;
+
+    while (!cjlib_queue_is_empty(src)) {
+        cjlib_queue_deqeue((void *) &node, sizeof(struct avl_bs_tree_node *), src);
+        if (-1 == cjlib_dict_btree_insert(&root, node)) {
+            if (detached) free_detached_node(node);
+            cjlib_dict_btree_destroy(root, (detached) ? &free_detached_node : NULL);
+            return -1;
+        }
+    }
+
+    *dst = root;
+    return 0;
+}
+
+/**
+ * Moves the entries of a dictionary to another backend, its policy stays the same.
+ *
+ * @param dict A pointer to the dictionary.
+ * @param target The backend.
+ * @return 0 on success, -1 otherwise (the dictionary is left as it was).
+ */
+static int move_entries(cjlib_dict_t *dict, enum cjlib_dict_backend target)
+{
+    bool detached = (CJLIB_DICT_FLAT == dict->d_backend);
+    struct cjlib_queue nodes;
+    struct cjlib_dict_hash table;
+    struct cjlib_dict_flat *flat        = NULL;
+    struct cjlib_dict_btree_node *btree = NULL;
+    struct avl_bs_tree_node *root       = NULL;
+    struct avl_bs_tree_node *node;
+
+    if (target == dict->d_backend) return 0;
+    if (-1 == gather_nodes(&nodes, dict)) return -1;
+
+    // Make the new backend, before the old one is freed. The B-tree is built at once, since its insertions may fail.
+    if ((CJLIB_DICT_HASH == target && -1 == cjlib_dict_hash_init(&table, dict->d_size)) ||
+        (CJLIB_DICT_FLAT == target && 0 != dict->d_size && NULL == (flat = cjlib_dict_flat_make(dict->d_size))) ||
+        (CJLIB_DICT_BTREE == target && -1 == fill_btree(&btree, &nodes, detached))) {
+        release_nodes(&nodes, detached);
+        return -1;
+    }
+
+    if (CJLIB_DICT_HASH == dict->d_backend) cjlib_dict_hash_destroy(&dict->d_hash);
+    else if (CJLIB_DICT_FLAT == dict->d_backend) cjlib_free(dict->d_flat);
+    else if (CJLIB_DICT_BTREE == dict->d_backend) cjlib_dict_btree_destroy(dict->d_btree, NULL);
+
+    while (!cjlib_queue_is_empty(&nodes)) {
+        cjlib_queue_deqeue((void *) &node, sizeof(struct avl_bs_tree_node *), &nodes);
+        switch (target) {
+            case CJLIB_DICT_HASH:
+                // The table has room for every node, so no insertion fails.
+                (void) cjlib_dict_hash_insert(&table, node, cjlib_dict_hash_key(node->avl_key, node->avl_key_s));
+                break;
+            case CJLIB_DICT_FLAT:
+                // The block has room for every node, so no append fails.
+                (void) cjlib_dict_flat_append(&flat, node->avl_key, node->avl_key_s, node->avl_data);
+                cjlib_free(node);
+                break;
+            default:
+                node->avl_left  = NULL;
+                node->avl_right = NULL;
+                avl_insert_node(&root, node);
+                break;
+        }
+    }
+
+    switch (target) {
+        case CJLIB_DICT_HASH:
+            (void) memcpy(&dict->d_hash, &table, sizeof(struct cjlib_dict_hash));
+            break;
+        case CJLIB_DICT_FLAT:
+            dict->d_flat = flat;
+            break;
+        case CJLIB_DICT_BTREE:
+            dict->d_btree = btree;
+            break;
+        default:
+            dict->d_root = root;
+            break;
+    }
+    dict->d_backend = target;
+
+    return 0;
+}
+
+int cjlib_dict_set_backend(cjlib_dict_t *dict, enum cjlib_dict_backend backend)
+{
+    // A dictionary is frozen/persistent only by cjlib_dict_freeze/cjlib_dict_persist, and for good.
+    if (T_DICT_IS_READ_ONLY(dict) || CJLIB_DICT_FROZEN == backend || CJLIB_DICT_PERSISTENT == backend) return -1;
+    if (-1 == move_entries(dict, resolve_backend(backend, dict->d_size))) return -1;
+    dict->d_policy = backend;
+    return 0;
+}
+
+/**
+ * The entries of a dictionary that is built at once (see cjlib_dict_stage).
+ */
+struct cjlib_dict_stage
+{
+    struct avl_bs_tree_node **s_nodes; // The entries, in the order they were collected.
+    size_t s_size;                     // The number of entries.
+    size_t s_capacity;                 // The capacity of s_nodes.
+    bool s_sorted;                     // Whether the entries were collected in the order of their keys.
+};
+
+static CJLIB_ALWAYS_INLINE int compare_nodes
+(const struct avl_bs_tree_node *restrict left, const struct avl_bs_tree_node *restrict right)
+{
+    return compare_key(left->avl_prefix, left->avl_key, right);
+}
+
+static int compare_staged_nodes(const void *left, const void *right)
+{
+    return compare_nodes(*((struct avl_bs_tree_node *const *) left), *((struct avl_bs_tree_node *const *) right));
+}
+
+int cjlib_dict_stage
+(cjlib_dict_t *dict, const char *restrict key, const struct cjlib_json_data *restrict value)
+{
+    struct cjlib_dict_stage *stage = dict->d_stage;
+    struct avl_bs_tree_node **nodes;
+    struct avl_bs_tree_node *new_node;
+    struct cjlib_dict_key handle;
+    size_t capacity;
+
+    if (T_DICT_IS_READ_ONLY(dict)) return -1;
+
+    if (NULL == stage) {
+        stage = (struct cjlib_dict_stage *) cjlib_calloc(1, sizeof(struct cjlib_dict_stage));
+        if (NULL == stage) return -1;
+        stage->s_sorted = true;
+        dict->d_stage   = stage;
+    }
+
+    if (stage->s_size == stage->s_capacity) {
+        capacity = (0 == stage->s_capacity) ? CJLIB_DICT_FLAT_SIZE : stage->s_capacity * 2;
+        nodes    = (struct avl_bs_tree_node **) cjlib_realloc(stage->s_nodes, capacity * sizeof(struct avl_bs_tree_node *));
+        if (NULL == nodes) return -1;
+
+        stage->s_nodes    = nodes;
+        stage->s_capacity = capacity;
+    }
+
+    make_key(&handle, key, CJLIB_DICT_AVL);
+    new_node = make_node(&handle, value);
+    if (NULL == new_node) return -1;
+
+    // An entry with the same key as the previous one, also requires sorting to be found.
+    if (0 != stage->s_size && compare_nodes(stage->s_nodes[stage->s_size - 1], new_node) >= 0) {
+        stage->s_sorted = false;
+    }
+    stage->s_nodes[stage->s_size++] = new_node;
+
+    return 0;
+}
+
+/**
+ * Builds a perfectly balanced AVL tree out of nodes, sorted by their key.
+ *
+ * @param nodes The nodes.
+ * @param nodes_s The number of nodes.
+ * @return The root of the AVL tree.
+ */
+static struct avl_bs_tree_node *avl_build(struct avl_bs_tree_node **nodes, size_t nodes_s)
+{
+    if (0 == nodes_s) return NULL;
+
+    // The two subtrees differ by one node at most, thus their heights by one at most.
+    size_t middle                 = nodes_s / 2;
+    struct avl_bs_tree_node *root = nodes[middle];
+
+    root->avl_left  = avl_build(nodes, middle);
+    root->avl_right = avl_build(nodes + middle + 1, nodes_s - middle - 1);
+    update_node_height(root);
+
+    return root;
+}
+
+/**
+ * Puts the collected entries of a dictionary in its backend.
+ *
+ * @param dict A pointer to the dictionary.
+ * @param stage The collected entries, every entry that is put in the dictionary is taken out.
+ * @param duplicate Where to store whether an entry was left out for its key (it is set already).
+ * @return 0 on success, otherwise -1.
+ */
+static int build_from_stage(cjlib_dict_t *dict, struct cjlib_dict_stage *restrict stage, bool *restrict duplicate)
+{
+    struct avl_bs_tree_node **nodes = stage->s_nodes;
+    struct avl_bs_tree_node *node;
+    size_t built = stage->s_size;
+    size_t taken = 0;
+    uint64_t hash;
+
+    // The entries meet the existing ones, insert them one by one.
+    if (0 != dict->d_size) {
+        for (; taken < stage->s_size; taken++) {
+            node = nodes[taken];
+            if (-1 == cjlib_dict_insert(node->avl_data, dict, node->avl_key)) {
+                *duplicate = NULL != cjlib_dict_lookup(dict, node->avl_key);
+                break;
+            }
+            free_node(node);
+        }
+        goto build_done;
+    }
+
+    if (-1 == move_entries(dict, resolve_backend(dict->d_policy, stage->s_size))) return -1;
+
+    if (CJLIB_DICT_AVL == dict->d_backend || CJLIB_DICT_BTREE == dict->d_backend) {
+        if (!stage->s_sorted) qsort(nodes, stage->s_size, sizeof(struct avl_bs_tree_node *), &compare_staged_nodes);
+
+        // Once sorted, the entries with the same key are next to each other, the ones before them are built.
+        for (size_t i = 1; i < built; i++) {
+            if (0 == compare_nodes(nodes[i - 1], nodes[i])) {
+                *duplicate = true;
+                built      = i;
+            }
+        }
+    }
+
+    switch (dict->d_backend) {
+        case CJLIB_DICT_AVL:
+            dict->d_root = avl_build(nodes, built);
+            taken        = built;
+            break;
+        case CJLIB_DICT_BTREE:
+            for (; taken < built; taken++) {
+                if (-1 == cjlib_dict_btree_insert(&dict->d_btree, nodes[taken])) break;
+            }
+            break;
+        case CJLIB_DICT_HASH:
+            // Make room for every entry at once, no insertion has to grow the table.
+            cjlib_dict_hash_destroy(&dict->d_hash);
+            if (-1 == cjlib_dict_hash_init(&dict->d_hash, stage->s_size)) break;
+
+            for (; taken < stage->s_size; taken++) {
+                node = nodes[taken];
+                hash = cjlib_dict_hash_key(node->avl_key, node->avl_key_s);
+                if (NULL != cjlib_dict_hash_search(&dict->d_hash, node->avl_key, hash)) {
+                    *duplicate = true;
+                    break;
+                }
+                (void) cjlib_dict_hash_insert(&dict->d_hash, node, hash);
+            }
+            break;
+        default:
+            // The flat array keeps the entries in the order they were collected, in a block of their number.
+            cjlib_free(dict->d_flat);
+            dict->d_flat = cjlib_dict_flat_make(stage->s_size);
+            if (NULL == dict->d_flat) break;
+
+            for (; taken < stage->s_size; taken++) {
+                node = nodes[taken];
+                if (-1 != cjlib_dict_flat_search(dict->d_flat, node->avl_prefix, node->avl_key, node->avl_key_s)) {
+                    *duplicate = true;
+                    break;
+                }
+                (void) cjlib_dict_flat_append(&dict->d_flat, node->avl_key, node->avl_key_s, node->avl_data);
+                free_detached_node(node);
+            }
+            break;
+    }
+    dict->d_size = taken;
+
+build_done:
+    // Keep only the entries that were not taken.
+    (void) memmove(nodes, nodes + taken, (stage->s_size - taken) * sizeof(struct avl_bs_tree_node *));
+    stage->s_size -= taken;
+
+    return (0 == stage->s_size) ? 0 : -1;
+}
+
+/**
+ * Frees the collected entries of a dictionary (see cjlib_dict_stage), along with their data.
+ */
+static void discard_stage(struct cjlib_dict_stage *restrict stage)
+{
+    for (size_t i = 0; i < stage->s_size; i++) destroy_node(stage->s_nodes[i]);
+    cjlib_free(stage->s_nodes);
+    cjlib_free(stage);
+}
+
+int cjlib_dict_build(cjlib_dict_t *dict, bool *restrict duplicate)
+{
+    struct cjlib_dict_stage *stage = dict->d_stage;
+    bool left_out                  = false;
+    int ret;
+
+    if (NULL != duplicate) *duplicate = false;
+    if (NULL == stage) return 0;
+
+    dict->d_stage = NULL;
+    ret = build_from_stage(dict, stage, &left_out);
+    if (NULL != duplicate) *duplicate = left_out;
+    discard_stage(stage);
+
+    return ret;
+}
+
+/**
+ * Collects the entries of a dictionary, sorted by their key.
+ *
+ * @param dict A pointer to the dictionary.
+ * @param scratch The nodes that hold the entries of a flat array (CJLIB_DICT_FLAT_SIZE of them).
+ * @param nodes_s Where to store the number of entries.
+ * @return The entries, or NULL on failure.
+ */
+static struct avl_bs_tree_node **collect_sorted
+(const cjlib_dict_t *dict, struct node_block *restrict scratch, size_t *restrict nodes_s)
+{
+    const struct cjlib_dict_flat *flat = dict->d_flat;
+    struct avl_bs_tree_node **nodes;
+    struct cjlib_dict_iter iter;
+
+    // One more slot, for the end of the walk.
+    nodes = (struct avl_bs_tree_node **) cjlib_malloc(sizeof(struct avl_bs_tree_node *) * (dict->d_size + 1));
+    if (NULL == nodes) return NULL;
+
+    *nodes_s = 0;
+    if (CJLIB_DICT_FLAT == dict->d_backend) {
+        // The entries of a flat array are not kept in nodes.
+        for (; NULL != flat && *nodes_s < flat->f_size; *nodes_s += 1) {
+            scratch[*nodes_s].b_node.avl_data = &scratch[*nodes_s].b_data;
+            flat_node(&scratch[*nodes_s].b_node, flat, *nodes_s);
+            nodes[*nodes_s] = &scratch[*nodes_s].b_node;
+        }
+    } else {
+        cjlib_dict_iter_begin(&iter, dict);
+        while (NULL != (nodes[*nodes_s] = iter_next_node(&iter))) *nodes_s += 1;
+    }
+
+    // The trees give their entries sorted already.
+    if (CJLIB_DICT_HASH == dict->d_backend || CJLIB_DICT_FLAT == dict->d_backend) {
+        qsort(nodes, *nodes_s, sizeof(struct avl_bs_tree_node *), &compare_staged_nodes);
+    }
+    return nodes;
+}
+
+/**
+ * Frees the backend of a dictionary, whose values were moved elsewhere.
+ *
+ * @param dict A pointer to the dictionary.
+ * @param nodes The entries of the dictionary (see collect_sorted).
+ * @param nodes_s The number of entries.
+ */
+static void discard_entries(cjlib_dict_t *dict, struct avl_bs_tree_node **nodes, size_t nodes_s)
+{
+    if (CJLIB_DICT_FLAT == dict->d_backend) {
+        for (size_t i = 0; i < nodes_s; i++) cjlib_free(nodes[i]->avl_key);
+        cjlib_free(dict->d_flat);
+        return;
+    }
+
+    for (size_t i = 0; i < nodes_s; i++) free_node(nodes[i]);
+    if (CJLIB_DICT_HASH == dict->d_backend) cjlib_dict_hash_destroy(&dict->d_hash);
+    else if (CJLIB_DICT_BTREE == dict->d_backend) cjlib_dict_btree_destroy(dict->d_btree, NULL);
+}
+
+int cjlib_dict_freeze(cjlib_dict_t *dict)
+{
+    struct node_block scratch[CJLIB_DICT_FLAT_SIZE];
+    struct avl_bs_tree_node **nodes;
+    struct cjlib_dict_frozen *frozen;
+    size_t nodes_s;
+
+    if (CJLIB_DICT_FROZEN == dict->d_backend) return 0;
+    // The entries of a persistent dictionary are shared with its other versions.
+    if (CJLIB_DICT_PERSISTENT == dict->d_backend || -1 == cjlib_dict_build(dict, NULL)) return -1;
+
+    nodes = collect_sorted(dict, scratch, &nodes_s);
+    if (NULL == nodes) return -1;
+
+    frozen = cjlib_dict_frozen_make(nodes, nodes_s);
+    if (NULL == frozen) {
+        cjlib_free(nodes);
+        return -1;
+    }
+
+    // The values are moved to the block, only the old entries are freed.
+    discard_entries(dict, nodes, nodes_s);
+    cjlib_free(nodes);
+
+    dict->d_frozen  = frozen;
+    dict->d_backend = CJLIB_DICT_FROZEN;
+    return 0;
+}
+
+/**
+ * The key and the value of an entry of a persistent dictionary, shared by the
+ * nodes that hold the entry in each version.
+ */
+struct version_entry
+{
+    size_t e_refs;                 // The number of nodes that hold the entry.
+    struct cjlib_json_data e_data; // The value.
+    char e_key[];                  // The key.
+};
+
+static CJLIB_ALWAYS_INLINE struct version_entry *node_entry(const struct avl_bs_tree_node *restrict src)
+{
+    return (struct version_entry *) ((char *) src->avl_data - offsetof(struct version_entry, e_data));
+}
+
+static CJLIB_ALWAYS_INLINE void node_key(struct cjlib_dict_key *restrict dst, const struct avl_bs_tree_node *restrict src)
+{
+    dst->k_key    = src->avl_key;
+    dst->k_key_s  = src->avl_key_s;
+    dst->k_prefix = src->avl_prefix;
+    dst->k_hash   = 0;
+}
+
+/**
+ * Makes the entry of a persistent dictionary.
+ *
+ * @param key The handle of the key (the key is copied).
+ * @param value The value, it is moved to the entry.
+ * @return The entry (with one reference), or NULL on failure.
+ */
+static struct version_entry *make_entry
+(const struct cjlib_dict_key *restrict key, const struct cjlib_json_data *restrict value)
+{
+    struct version_entry *dst = (struct version_entry *) cjlib_malloc(sizeof(struct version_entry) + key->k_key_s + 1);
+    if (NULL == dst) return NULL;
+
+    dst->e_refs = 1;
+    (void) memcpy(&dst->e_data, value, sizeof(struct cjlib_json_data));
+    (void) memcpy(dst->e_key, key->k_key, key->k_key_s + 1);
+    return dst;
+}
+
+/**
+ * Drops a reference to an entry, the last one frees the entry along with its value.
+ */
+static void release_entry(struct version_entry *src)
+{
+    if (0 != --src->e_refs) return;
+    cjlib_json_data_destroy(&src->e_data);
+    cjlib_free(src);
+}
+
+/**
+ * Makes a leaf of a persistent AVL tree.
+ *
+ * @param entry The entry of the leaf, the leaf takes over a reference to it.
+ * @param key The handle of the key of the entry.
+ * @return The leaf, or NULL on failure (the reference to the entry remains to the caller).
+ */
+static struct avl_bs_tree_node *make_leaf(struct version_entry *entry, const struct cjlib_dict_key *restrict key)
+{
+    struct avl_bs_tree_node *dst = (struct avl_bs_tree_node *) cjlib_calloc(1, sizeof(struct avl_bs_tree_node));
+    if (NULL == dst) return NULL;
+
+    dst->avl_data   = &entry->e_data;
+    dst->avl_key    = entry->e_key;
+    dst->avl_key_s  = key->k_key_s;
+    dst->avl_prefix = key->k_prefix;
+    dst->avl_height = 1;
+    dst->avl_refs   = 1;
+    return dst;
+}
+
+/**
+ * Drops a reference to a node of a persistent AVL tree, the last one frees the node and
+ * drops its references to its children and its entry.
+ */
+static void release_node(struct avl_bs_tree_node *src)
+{
+    if (NULL == src || 0 != --src->avl_refs) return;
+
+    release_node(src->avl_left);
+    release_node(src->avl_right);
+    release_entry(node_entry(src));
+    cjlib_free(src);
+}
+
+/**
+ * Copies a node of a persistent AVL tree, the copy shares the children and the entry of the node.
+ *
+ * @param src The node.
+ * @return The copy (with one reference), or NULL on failure.
+ */
+static struct avl_bs_tree_node *copy_node(const struct avl_bs_tree_node *restrict src)
+{
+    struct avl_bs_tree_node *dst = (struct avl_bs_tree_node *) cjlib_malloc(sizeof(struct avl_bs_tree_node));
+    if (NULL == dst) return NULL;
+
+    (void) memcpy(dst, src, sizeof(struct avl_bs_tree_node));
+    dst->avl_refs = 1;
+    node_entry(src)->e_refs += 1;
+    if (NULL != src->avl_left) src->avl_left->avl_refs += 1;
+    if (NULL != src->avl_right) src->avl_right->avl_refs += 1;
+    return dst;
+}
+
+/**
+ * Makes sure that the node of a link belongs to a single version, copying it if it is shared.
+ *
+ * @param link The link to the node.
+ * @return 0 on success, otherwise -1.
+ */
+static int own_node(struct avl_bs_tree_node **link)
+{
+    struct avl_bs_tree_node *copy;
+
+    if (1 == (*link)->avl_refs) return 0;
+    copy = copy_node(*link);
+    if (NULL == copy) return -1;
+
+    release_node(*link);
+    *link = copy;
+    return 0;
+}
+
+/**
+ * Balances a node of a new version of a persistent AVL tree, whose subtree changed.
+ * The nodes that take part in the rotation (see balance_rotation) are copied first, if
+ * they are shared with other versions.
+ *
+ * @param dst Where to store the root of the balanced subtree.
+ * @param src The node (it belongs to the new version only).
+ * @return 0 on success, otherwise -1 (then the node is released).
+ */
+static int balance_version(struct avl_bs_tree_node **dst, struct avl_bs_tree_node *src)
+{
+    int balance_factor;
+    int ret = 0;
+
+    update_node_height(src);
+    balance_factor = calc_balance_factor(src);
+
+    if (T_IMBALANCE_ON_LEFT(balance_factor)) {
+        ret = own_node(&src->avl_left);
+        if (0 == ret && calc_balance_factor(src->avl_left) < 0) ret = own_node(&src->avl_left->avl_right);
+    } else if (T_IMBALANCE_ON_RIGHT(balance_factor)) {
+        ret = own_node(&src->avl_right);
+        if (0 == ret && calc_balance_factor(src->avl_right) > 0) ret = own_node(&src->avl_right->avl_left);
+    }
+
+    if (-1 == ret) {
+        release_node(src);
+        return -1;
+    }
+    *dst = balance_rotation(src);
+    return 0;
+}
+
+/**
+ * Inserts an entry in a new version of a persistent AVL tree (or replaces the entry with the
+ * same key), copying the nodes on the path to it.
+ *
+ * @param dst Where to store the root of the new version.
+ * @param src The root of the tree.
+ * @param key The handle of the key of the entry.
+ * @param entry The entry, the new version takes over a reference to it on success.
+ * @return 0 on success, otherwise -1.
+ */
+static int version_insert
+(struct avl_bs_tree_node **dst, const struct avl_bs_tree_node *src,
+ const struct cjlib_dict_key *restrict key, struct version_entry *entry)
+{
+    struct avl_bs_tree_node **link;
+    struct avl_bs_tree_node *node;
+    struct avl_bs_tree_node *child;
+    int compare_keys;
+
+    if (NULL == src) return (NULL == (*dst = make_leaf(entry, key))) ? -1 : 0;
+
+    node = copy_node(src);
+    if (NULL == node) return -1;
+
+    compare_keys = compare_key(key->k_prefix, key->k_key, src);
+    if (0 == compare_keys) {
+        // The entry takes the place of the old one, the structure of the tree is the same.
+        release_entry(node_entry(node));
+        node->avl_data = &entry->e_data;
+        node->avl_key  = entry->e_key;
+        *dst           = node;
+        return 0;
+    }
+
+    link = (T_NODE_IS_LEFT(compare_keys)) ? &node->avl_left : &node->avl_right;
+    if (-1 == version_insert(&child, *link, key, entry)) {
+        release_node(node);
+        return -1;
+    }
+    release_node(*link);
+    *link = child;
+
+    return balance_version(dst, node);
+}
+
+/**
+ * Removes an entry from a new version of a persistent AVL tree, copying the nodes on the path to it.
+ *
+ * @param dst Where to store the root of the new version.
+ * @param src The root of the tree, it must hold the key.
+ * @param key The handle of the key of the entry.
+ * @return 0 on success, otherwise -1.
+ */
+static int version_remove
+(struct avl_bs_tree_node **dst, const struct avl_bs_tree_node *src, const struct cjlib_dict_key *restrict key)
+{
+    struct cjlib_dict_key largest_key;
+    const struct avl_bs_tree_node *largest;
+    struct avl_bs_tree_node **link;
+    struct avl_bs_tree_node *node;
+    struct avl_bs_tree_node *child;
+    int compare_keys = compare_key(key->k_prefix, key->k_key, src);
+
+    if (0 == compare_keys && (NULL == src->avl_left || NULL == src->avl_right)) {
+        // Case (1), The child of the removed node (if any) takes its place.
+        *dst = (NULL != src->avl_left) ? src->avl_left : src->avl_right;
+        if (NULL != *dst) (*dst)->avl_refs += 1;
+        return 0;
+    }
+
+    node = copy_node(src);
+    if (NULL == node) return -1;
+
+    if (0 == compare_keys) {
+        // Case (2), The largest key of the left subtree takes the place of the removed one.
+        for (largest = src->avl_left; NULL != largest->avl_right; largest = largest->avl_right);
+
+        node_entry(largest)->e_refs += 1;
+        release_entry(node_entry(node));
+        node->avl_data   = largest->avl_data;
+        node->avl_key    = largest->avl_key;
+        node->avl_key_s  = largest->avl_key_s;
+        node->avl_prefix = largest->avl_prefix;
+
+        node_key(&largest_key, largest);
+        key  = &largest_key;
+        link = &node->avl_left;
+    } else {
+        link = (T_NODE_IS_LEFT(compare_keys)) ? &node->avl_left : &node->avl_right;
+    }
+
+    if (-1 == version_remove(&child, *link, key)) {
+        release_node(node);
+        return -1;
+    }
+    release_node(*link);
+    *link = child;
+
+    return balance_version(dst, node);
+}
+
+/**
+ * Makes a new (empty) version of a persistent dictionary.
+ */
+static cjlib_dict_t *make_version(const cjlib_dict_t *restrict src)
+{
+    cjlib_dict_t *dst = cjlib_make_dict();
+    if (NULL == dst) return NULL;
+
+    cjlib_dict_init(dst);
+    dst->d_policy  = src->d_policy;
+    dst->d_backend = CJLIB_DICT_PERSISTENT;
+    return dst;
+}
+
+int cjlib_dict_persist(cjlib_dict_t *dict)
+{
+    struct node_block scratch[CJLIB_DICT_FLAT_SIZE];
+    struct avl_bs_tree_node **nodes;
+    struct avl_bs_tree_node **leaves;
+    struct version_entry *entry;
+    struct cjlib_dict_key key;
+    size_t nodes_s;
+    size_t made;
+
+    if (CJLIB_DICT_PERSISTENT == dict->d_backend) return 0;
+    if (CJLIB_DICT_FROZEN == dict->d_backend || -1 == cjlib_dict_build(dict, NULL)) return -1;
+
+    nodes = collect_sorted(dict, scratch, &nodes_s);
+    if (NULL == nodes) return -1;
+    leaves = (struct avl_bs_tree_node **) cjlib_malloc(sizeof(struct avl_bs_tree_node *) * (nodes_s + 1));
+
+    for (made = 0; NULL != leaves && made < nodes_s; made++) {
+        node_key(&key, nodes[made]);
+        entry = make_entry(&key, nodes[made]->avl_data);
+        if (NULL == entry) break;
+
+        leaves[made] = make_leaf(entry, &key);
+        if (NULL == leaves[made]) {
+            cjlib_free(entry);
+            break;
+        }
+    }
+
+    if (NULL == leaves || made < nodes_s) {
+        // The values still belong to the old entries.
+        while (NULL != leaves && made > 0) {
+            made -= 1;
+            cjlib_free(node_entry(leaves[made]));
+            cjlib_free(leaves[made]);
+        }
+        cjlib_free(leaves);
+        cjlib_free(nodes);
+        return -1;
+    }
+
+    // The values are moved to the new entries, only the old ones are freed.
+    discard_entries(dict, nodes, nodes_s);
+    cjlib_free(nodes);
+
+    dict->d_root    = avl_build(leaves, nodes_s);
+    dict->d_backend = CJLIB_DICT_PERSISTENT;
+    cjlib_free(leaves);
+    return 0;
+}
+
+int cjlib_dict_set_version
+(cjlib_dict_t **dst, const cjlib_dict_t *src, const struct cjlib_dict_key *restrict key,
+ const struct cjlib_json_data *restrict value)
+{
+    struct version_entry *entry;
+    cjlib_dict_t *version;
+    bool exists;
+
+    if (CJLIB_DICT_PERSISTENT != src->d_backend) return -1;
+
+    exists  = NULL != search_node(src->d_root, key);
+    version = make_version(src);
+    entry   = make_entry(key, value);
+    if (NULL == version || NULL == entry || -1 == version_insert(&version->d_root, src->d_root, key, entry)) {
+        cjlib_free(version);
+        cjlib_free(entry);
+        return -1;
+    }
+
+    version->d_size = src->d_size + (exists ? 0 : 1);
+    *dst            = version;
+    return 0;
+}
+
+int cjlib_dict_remove_version
+(cjlib_dict_t **dst, const cjlib_dict_t *src, const struct cjlib_dict_key *restrict key)
+{
+    cjlib_dict_t *version;
+
+    if (CJLIB_DICT_PERSISTENT != src->d_backend || NULL == search_node(src->d_root, key)) return -1;
+
+    version = make_version(src);
+    if (NULL == version || -1 == version_remove(&version->d_root, src->d_root, key)) {
+        cjlib_free(version);
+        return -1;
+    }
+
+    version->d_size = src->d_size - 1;
+    *dst            = version;
+    return 0;
+}
+
+size_t cjlib_dict_destroy(cjlib_dict_t *dict)
+{
+    if (NULL == dict) return 0;
+
+    struct avl_bs_tree_node *node;
+    size_t pos  = 0;
+    size_t size = 0;
+
+    switch (dict->d_backend) {
+        case CJLIB_DICT_HASH:
+            while (NULL != (node = cjlib_dict_hash_next(&dict->d_hash, &pos))) destroy_node(node);
+            cjlib_dict_hash_destroy(&dict->d_hash);
+            break;
+        case CJLIB_DICT_BTREE:
+            cjlib_dict_btree_destroy(dict->d_btree, &destroy_node);
+            break;
+        case CJLIB_DICT_FROZEN:
+            cjlib_dict_frozen_destroy(dict->d_frozen);
+            break;
+        case CJLIB_DICT_PERSISTENT:
+            // The nodes shared with other versions stay.
+            release_node(dict->d_root);
+            break;
+        case CJLIB_DICT_FLAT:
+            for (; NULL != dict->d_flat && pos < dict->d_flat->f_size; pos++) {
+                cjlib_json_data_destroy(&cjlib_dict_flat_values(dict->d_flat)[pos]);
+                cjlib_free(cjlib_dict_flat_keys(dict->d_flat)[pos]);
+            }
+            cjlib_free(dict->d_flat);
+            break;
+        default:
+            size = (NULL == dict->d_root) ? 0 : lvl_order_traversal(dict->d_root, T_DELETE_NODES);
+            break;
+    }
+    if (NULL != dict->d_stage) discard_stage(dict->d_stage);
+    cjlib_fragment_drop(&dict->d_fragment);
+    cjlib_free(dict);
 
     return size;
 }
+
+/**
+ * Counts a block that holds a node along with its key, the key is counted apart.
+ */
+static CJLIB_ALWAYS_INLINE void account_node_with_key
+(struct cjlib_json_memory *restrict dst, const void *block, size_t block_s, size_t key_s)
+{
+    cjlib_memory_account(dst, &dst->m_nodes, block, block_s);
+    dst->m_nodes -= key_s;
+    dst->m_keys  += key_s;
+}
+
+void cjlib_dict_memory_usage(struct cjlib_json_memory *restrict dst, const cjlib_dict_t *src)
+{
+    struct cjlib_dict_iter iter;
+    const struct avl_bs_tree_node *node;
+    const struct cjlib_dict_stage *stage = src->d_stage;
+    size_t keys_s = 0;
+
+    cjlib_memory_account(dst, &dst->m_containers, src, sizeof(cjlib_dict_t));
+    cjlib_memory_account(dst, &dst->m_fragments, src->d_fragment.f_bytes, src->d_fragment.f_bytes_s);
+
+    switch (src->d_backend) {
+        case CJLIB_DICT_HASH:
+            cjlib_memory_account(dst, &dst->m_containers, src->d_hash.h_ctrl,
+                                 src->d_hash.h_capacity * (sizeof(uint8_t) + sizeof(uint64_t) +
+                                                           sizeof(struct avl_bs_tree_node *)));
+            break;
+        case CJLIB_DICT_FLAT:
+            if (NULL == src->d_flat) break;
+            cjlib_memory_account(dst, &dst->m_nodes, src->d_flat, cjlib_dict_flat_size(src->d_flat->f_capacity));
+            for (size_t i = 0; i < src->d_flat->f_size; i++) {
+                cjlib_memory_account(dst, &dst->m_keys, cjlib_dict_flat_keys(src->d_flat)[i],
+                                     cjlib_dict_flat_key_size(src->d_flat, i) + 1);
+            }
+            break;
+        case CJLIB_DICT_BTREE:
+            cjlib_dict_btree_memory_usage(dst, src->d_btree);
+            break;
+        default:
+            break;
+    }
+
+    // The entries of a flat array are not kept in nodes, they are counted above.
+    cjlib_dict_iter_begin(&iter, src);
+    while (CJLIB_DICT_FLAT != src->d_backend && NULL != (node = iter_next_node(&iter))) {
+        switch (src->d_backend) {
+            case CJLIB_DICT_FROZEN:
+                // The keys are part of the block of the dictionary.
+                keys_s += node->avl_key_s + 1;
+                break;
+            case CJLIB_DICT_PERSISTENT:
+                cjlib_memory_account(dst, &dst->m_nodes, node, sizeof(struct avl_bs_tree_node));
+                account_node_with_key(dst, node_entry(node), sizeof(struct version_entry) + node->avl_key_s + 1,
+                                      node->avl_key_s + 1);
+                break;
+            default:
+                cjlib_memory_account(dst, &dst->m_nodes, node, sizeof(struct node_block));
+                cjlib_memory_account(dst, &dst->m_keys, node->avl_key, node->avl_key_s + 1);
+                break;
+        }
+    }
+
+    if (CJLIB_DICT_FROZEN == src->d_backend) {
+        account_node_with_key(dst, src->d_frozen, sizeof(struct cjlib_dict_frozen) +
+                              (src->d_size + 1) * (sizeof(uint64_t) + sizeof(struct avl_bs_tree_node) +
+                                                   sizeof(struct cjlib_json_data)) + keys_s, keys_s);
+    }
+
+    if (NULL == stage) return;
+
+    cjlib_memory_account(dst, &dst->m_containers, stage, sizeof(struct cjlib_dict_stage));
+    cjlib_memory_account(dst, &dst->m_containers, stage->s_nodes, stage->s_capacity * sizeof(struct avl_bs_tree_node *));
+    for (size_t i = 0; i < stage->s_size; i++) {
+        cjlib_memory_account(dst, &dst->m_nodes, stage->s_nodes[i], sizeof(struct node_block));
+        cjlib_memory_account(dst, &dst->m_keys, stage->s_nodes[i]->avl_key, stage->s_nodes[i]->avl_key_s + 1);
+    }
+}
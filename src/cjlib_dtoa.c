@@ -0,0 +1,546 @@
+/* File: cjlib_dtoa.c
+ *
+ * This file contains the conversion of a double into its shortest decimal
+ * representation that, when read back, produces the same double. The digit
+ * generation is the Grisu3 algorithm, described by Florian Loitsch in
+ * "Printing Floating-Point Numbers Quickly and Accurately with Integers",
+ * which only uses 64-bit integer arithmetic. Grisu3 knows when it can't
+ * be sure that its digits are the shortest ones (about 0.5% of the inputs),
+ * those inputs are converted by printf instead.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "cjlib_dtoa.h"
+
+// IEEE-754 binary64 layout.
+#define DTOA_SIGNIFICAND_BITS (52)
+#define DTOA_HIDDEN_BIT       (0x10000000000000ULL)
+#define DTOA_SIGNIFICAND_MASK (0xFFFFFFFFFFFFFULL)
+#define DTOA_EXPONENT_MASK    (0x7FF)
+#define DTOA_EXPONENT_BIAS    (1075) // 1023 + 52.
+#define DTOA_MIN_EXPONENT     (1 - DTOA_EXPONENT_BIAS)
+
+// The range in which the binary exponent of the scaled value must lie.
+#define DTOA_ALPHA (-60)
+#define DTOA_GAMMA (-32)
+
+// The cached powers of ten start at 10^-300 and increase by 10^8.
+#define DTOA_CACHED_POWERS_MIN_DEC_EXP (-300)
+#define DTOA_CACHED_POWERS_DEC_STEP    (8)
+
+// Integral values below this limit are exact and take the integer path (2^53).
+#define DTOA_MAX_SAFE_INTEGER (9007199254740992.0)
+
+// The range of the decimal point position in which no exponent is written (same as ECMAScript).
+#define DTOA_DECIMAL_MIN_POINT (-6)
+#define DTOA_DECIMAL_MAX_POINT (21)
+
+#define DTOA_MAX_DIGITS (17)
+
+/**
+ * A floating point number with a 64-bit significand, f * 2^e.
+ */
+struct diy_fp
+{
+    uint64_t f; // The significand.
+    int e;      // The binary exponent.
+};
+
+/**
+ * A normalized power of ten, f * 2^e ~= 10^k.
+ */
+struct cached_power
+{
+    uint64_t f; // The significand.
+    int e;      // The binary exponent.
+    int k;      // The decimal exponent.
+};
+
+static const struct cached_power cached_powers[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL, -980, -276 },
+    { 0xD3515C2831559A83ULL, -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL, -927, -260 },
+    { 0xEA9C227723EE8BCBULL, -901, -252 },
+    { 0xAECC49914078536DULL, -874, -244 },
+    { 0x823C12795DB6CE57ULL, -847, -236 },
+    { 0xC21094364DFB5637ULL, -821, -228 },
+    { 0x9096EA6F3848984FULL, -794, -220 },
+    { 0xD77485CB25823AC7ULL, -768, -212 },
+    { 0xA086CFCD97BF97F4ULL, -741, -204 },
+    { 0xEF340A98172AACE5ULL, -715, -196 },
+    { 0xB23867FB2A35B28EULL, -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL, -661, -180 },
+    { 0xC5DD44271AD3CDBAULL, -635, -172 },
+    { 0x936B9FCEBB25C996ULL, -608, -164 },
+    { 0xDBAC6C247D62A584ULL, -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL, -555, -148 },
+    { 0xF3E2F893DEC3F126ULL, -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL, -502, -132 },
+    { 0x87625F056C7C4A8BULL, -475, -124 },
+    { 0xC9BCFF6034C13053ULL, -449, -116 },
+    { 0x964E858C91BA2655ULL, -422, -108 },
+    { 0xDFF9772470297EBDULL, -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL, -369, -92 },
+    { 0xF8A95FCF88747D94ULL, -343, -84 },
+    { 0xB94470938FA89BCFULL, -316, -76 },
+    { 0x8A08F0F8BF0F156BULL, -289, -68 },
+    { 0xCDB02555653131B6ULL, -263, -60 },
+    { 0x993FE2C6D07B7FACULL, -236, -52 },
+    { 0xE45C10C42A2B3B06ULL, -210, -44 },
+    { 0xAA242499697392D3ULL, -183, -36 },
+    { 0xFD87B5F28300CA0EULL, -157, -28 },
+    { 0xBCE5086492111AEBULL, -130, -20 },
+    { 0x8CBCCC096F5088CCULL, -103, -12 },
+    { 0xD1B71758E219652CULL,  -77,  -4 },
+    { 0x9C40000000000000ULL,  -50,   4 },
+    { 0xE8D4A51000000000ULL,  -24,  12 },
+    { 0xAD78EBC5AC620000ULL,    3,  20 },
+    { 0x813F3978F8940984ULL,   30,  28 },
+    { 0xC097CE7BC90715B3ULL,   56,  36 },
+    { 0x8F7E32CE7BEA5C70ULL,   83,  44 },
+    { 0xD5D238A4ABE98068ULL,  109,  52 },
+    { 0x9F4F2726179A2245ULL,  136,  60 },
+    { 0xED63A231D4C4FB27ULL,  162,  68 },
+    { 0xB0DE65388CC8ADA8ULL,  189,  76 },
+    { 0x83C7088E1AAB65DBULL,  216,  84 },
+    { 0xC45D1DF942711D9AULL,  242,  92 },
+    { 0x924D692CA61BE758ULL,  269, 100 },
+    { 0xDA01EE641A708DEAULL,  295, 108 },
+    { 0xA26DA3999AEF774AULL,  322, 116 },
+    { 0xF209787BB47D6B85ULL,  348, 124 },
+    { 0xB454E4A179DD1877ULL,  375, 132 },
+    { 0x865B86925B9BC5C2ULL,  402, 140 },
+    { 0xC83553C5C8965D3DULL,  428, 148 },
+    { 0x952AB45CFA97A0B3ULL,  455, 156 },
+    { 0xDE469FBD99A05FE3ULL,  481, 164 },
+    { 0xA59BC234DB398C25ULL,  508, 172 },
+    { 0xF6C69A72A3989F5CULL,  534, 180 },
+    { 0xB7DCBF5354E9BECEULL,  561, 188 },
+    { 0x88FCF317F22241E2ULL,  588, 196 },
+    { 0xCC20CE9BD35C78A5ULL,  614, 204 },
+    { 0x98165AF37B2153DFULL,  641, 212 },
+    { 0xE2A0B5DC971F303AULL,  667, 220 },
+    { 0xA8D9D1535CE3B396ULL,  694, 228 },
+    { 0xFB9B7CD9A4A7443CULL,  720, 236 },
+    { 0xBB764C4CA7A44410ULL,  747, 244 },
+    { 0x8BAB8EEFB6409C1AULL,  774, 252 },
+    { 0xD01FEF10A657842CULL,  800, 260 },
+    { 0x9B10A4E5E9913129ULL,  827, 268 },
+    { 0xE7109BFBA19C0C9DULL,  853, 276 },
+    { 0xAC2820D9623BF429ULL,  880, 284 },
+    { 0x80444B5E7AA7CF85ULL,  907, 292 },
+    { 0xBF21E44003ACDD2DULL,  933, 300 },
+    { 0x8E679C2F5E44FF8FULL,  960, 308 },
+    { 0xD433179D9C8CB841ULL,  986, 316 },
+    { 0x9E19DB92B4E31BA9ULL, 1013, 324 }
+};
+
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Writes the decimal digits of an unsigned integer, two digits at a time.
+ *
+ * @param dst Where to write the digits.
+ * @param value The integer to write.
+ * @return The number of digits written.
+ */
+static size_t write_uint64(char *restrict dst, uint64_t value)
+{
+    char tmp[20];
+    char *curr = tmp + sizeof(tmp);
+    size_t len;
+
+    while (value >= 100) {
+        curr -= 2;
+        (void) memcpy(curr, &digit_pairs[(value % 100) * 2], 2);
+        value /= 100;
+    }
+
+    if (value >= 10) {
+        curr -= 2;
+        (void) memcpy(curr, &digit_pairs[value * 2], 2);
+    } else {
+        *--curr = (char) ('0' + value);
+    }
+
+    len = (size_t) (tmp + sizeof(tmp) - curr);
+    (void) memcpy(dst, curr, len);
+    return len;
+}
+
+/**
+ * Computes x * y, rounded, keeping the upper 64 bits of the product.
+ */
+static inline void diy_fp_mul(struct diy_fp *dst, const struct diy_fp *x, const struct diy_fp *y)
+{
+    const uint64_t u_lo = x->f & 0xFFFFFFFFU;
+    const uint64_t u_hi = x->f >> 32U;
+    const uint64_t v_lo = y->f & 0xFFFFFFFFU;
+    const uint64_t v_hi = y->f >> 32U;
+
+    const uint64_t p0 = u_lo * v_lo;
+    const uint64_t p1 = u_lo * v_hi;
+    const uint64_t p2 = u_hi * v_lo;
+    const uint64_t p3 = u_hi * v_hi;
+
+    uint64_t q = (p0 >> 32U) + (p1 & 0xFFFFFFFFU) + (p2 & 0xFFFFFFFFU);
+    q += 1ULL << 31U; // Round, ties up.
+
+    dst->f = p3 + (p2 >> 32U) + (p1 >> 32U) + (q >> 32U);
+    dst->e = x->e + y->e + 64;
+}
+
+/**
+ * Shifts the significand until its most significant bit is set.
+ */
+static inline void diy_fp_normalize(struct diy_fp *src)
+{
+    while (0 == (src->f >> 63U)) {
+        src->f <<= 1U;
+        src->e--;
+    }
+}
+
+/**
+ * Computes the normalized value of @value together with its lower (m_minus) and upper (m_plus)
+ * boundaries. Every number between the two boundaries rounds to @value.
+ */
+static void compute_boundaries
+(struct diy_fp *restrict v, struct diy_fp *restrict m_minus,
+ struct diy_fp *restrict m_plus, double value)
+{
+    uint64_t bits;
+    (void) memcpy(&bits, &value, sizeof(bits));
+
+    const uint64_t biased_e = (bits >> DTOA_SIGNIFICAND_BITS) & DTOA_EXPONENT_MASK;
+    const uint64_t f        = bits & DTOA_SIGNIFICAND_MASK;
+
+    if (0 == biased_e) {
+        // Subnormal number.
+        v->f = f;
+        v->e = DTOA_MIN_EXPONENT;
+    } else {
+        v->f = f + DTOA_HIDDEN_BIT;
+        v->e = (int) biased_e - DTOA_EXPONENT_BIAS;
+    }
+
+    // On powers of two the lower neighbour is closer than the upper one.
+    const bool lower_boundary_is_closer = (0 == f && biased_e > 1);
+
+    m_plus->f = 2 * v->f + 1;
+    m_plus->e = v->e - 1;
+
+    if (lower_boundary_is_closer) {
+        m_minus->f = 4 * v->f - 1;
+        m_minus->e = v->e - 2;
+    } else {
+        m_minus->f = 2 * v->f - 1;
+        m_minus->e = v->e - 1;
+    }
+
+    diy_fp_normalize(m_plus);
+    diy_fp_normalize(v);
+
+    // Bring m_minus to the exponent of m_plus.
+    m_minus->f <<= (unsigned int) (m_minus->e - m_plus->e);
+    m_minus->e   = m_plus->e;
+}
+
+/**
+ * Retrieves the cached power of ten c = 10^-k such that the binary exponent of
+ * c * 2^e lies in [DTOA_ALPHA, DTOA_GAMMA].
+ */
+static inline const struct cached_power *get_cached_power(int e)
+{
+    const int f     = DTOA_ALPHA - e - 1;
+    const int k     = (f * 78913) / (1 << 18) + (f > 0); // ceil(f * log10(2)).
+    const int index = (-DTOA_CACHED_POWERS_MIN_DEC_EXP + k + (DTOA_CACHED_POWERS_DEC_STEP - 1))
+                      / DTOA_CACHED_POWERS_DEC_STEP;
+
+    return &cached_powers[index];
+}
+
+/**
+ * Returns the number of decimal digits of @n and the largest power of ten not greater than it.
+ */
+static inline int find_largest_pow10(uint32_t n, uint32_t *restrict pow10)
+{
+    static const uint32_t powers[] = {
+        1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+    };
+    int digits = 10;
+
+    while (digits > 1 && n < powers[digits - 1]) --digits;
+
+    *pow10 = powers[digits - 1];
+    return digits;
+}
+
+/**
+ * Moves the last generated digit closer to the exact value w, as long as the result stays
+ * inside the rounding interval, then checks that the digits are, for sure, the shortest
+ * ones closest to w: w and the boundaries are only known within @unit.
+ *
+ * @param buf The digits.
+ * @param len The number of digits.
+ * @param dist The distance from w to the upper end of the unsafe interval.
+ * @param delta The size of the unsafe interval.
+ * @param rest The distance from the digits to the upper end of the unsafe interval.
+ * @param ten_k The weight of the last digit.
+ * @param unit The error of w and the boundaries.
+ * @return true if the digits are correct, otherwise false (see fallback).
+ */
+static inline bool grisu3_round
+(char *restrict buf, int len, uint64_t dist, uint64_t delta,
+ uint64_t rest, uint64_t ten_k, uint64_t unit)
+{
+    const uint64_t small_dist = dist - unit; // The farthest w may be from the upper end.
+    const uint64_t big_dist   = dist + unit; // The closest w may be to the upper end.
+
+    while (rest < small_dist && delta - rest >= ten_k &&
+           (rest + ten_k < small_dist || small_dist - rest >= rest + ten_k - small_dist)) {
+        buf[len - 1]--;
+        rest += ten_k;
+    }
+
+    // If the digits would move once more for the other end of w, it is not known which is closer.
+    if (rest < big_dist && delta - rest >= ten_k &&
+        (rest + ten_k < big_dist || big_dist - rest > rest + ten_k - big_dist)) {
+        return false;
+    }
+
+    // The digits must be inside the safe interval as well.
+    return 2 * unit <= rest && rest <= delta - 4 * unit;
+}
+
+/**
+ * Generates the shortest digits of a number inside the unsafe interval (m_minus, m_plus),
+ * widened by one unit on each side for the rounding of the products, closest to w.
+ *
+ * @return true if the digits are correct, otherwise false (see grisu3_round).
+ */
+static bool grisu3_digit_gen
+(char *restrict buf, int *restrict len, int *restrict dec_exp,
+ const struct diy_fp *m_minus, const struct diy_fp *w, const struct diy_fp *m_plus)
+{
+    uint64_t unit       = 1;
+    const uint64_t high = m_plus->f + unit;
+    uint64_t delta      = high - (m_minus->f - unit);
+    const uint64_t dist = high - w->f;
+
+    const unsigned int shift = (unsigned int) -m_plus->e;
+    const uint64_t one_f     = 1ULL << shift;
+
+    uint32_t p1 = (uint32_t) (high >> shift); // The integral part.
+    uint64_t p2 = high & (one_f - 1);         // The fractional part.
+    uint32_t pow10;
+    uint64_t rest;
+    uint32_t digit;
+    int n = find_largest_pow10(p1, &pow10);
+    int m = 0;
+
+    *len = 0;
+    while (n > 0) {
+        digit = p1 / pow10;
+        p1    = p1 % pow10;
+        buf[(*len)++] = (char) ('0' + digit);
+        --n;
+
+        rest = ((uint64_t) p1 << shift) + p2;
+        if (rest < delta) {
+            *dec_exp += n;
+            return grisu3_round(buf, *len, dist, delta, rest, (uint64_t) pow10 << shift, unit);
+        }
+        pow10 /= 10;
+    }
+
+    do {
+        p2    *= 10;
+        unit  *= 10;
+        delta *= 10;
+        digit  = (uint32_t) (p2 >> shift);
+        p2    &= one_f - 1;
+        buf[(*len)++] = (char) ('0' + digit);
+        ++m;
+    } while (p2 >= delta);
+
+    *dec_exp -= m;
+    return grisu3_round(buf, *len, dist * unit, delta, p2, one_f, unit);
+}
+
+/**
+ * Produces the digits and the decimal exponent of a positive, finite double, so that
+ * value = digits * 10^dec_exp.
+ *
+ * @return true if the digits are the shortest ones, otherwise false (see fallback).
+ */
+static bool grisu3(char *restrict buf, int *restrict len, int *restrict dec_exp, double value)
+{
+    struct diy_fp v;
+    struct diy_fp m_minus;
+    struct diy_fp m_plus;
+    struct diy_fp c_minus_k;
+    struct diy_fp w;
+    struct diy_fp w_minus;
+    struct diy_fp w_plus;
+
+    compute_boundaries(&v, &m_minus, &m_plus, value);
+
+    const struct cached_power *cached = get_cached_power(m_plus.e);
+    c_minus_k.f = cached->f;
+    c_minus_k.e = cached->e;
+
+    diy_fp_mul(&w, &v, &c_minus_k);
+    diy_fp_mul(&w_minus, &m_minus, &c_minus_k);
+    diy_fp_mul(&w_plus, &m_plus, &c_minus_k);
+
+    *dec_exp = -cached->k;
+    return grisu3_digit_gen(buf, len, dec_exp, &w_minus, &w, &w_plus);
+}
+
+/**
+ * Produces the same as grisu3, for the few numbers that it can't decide on, by trying each
+ * precision until the number reads back (printf rounds correctly, thus it is exact but slow).
+ */
+static void fallback(char *restrict buf, int *restrict len, int *restrict dec_exp, double value)
+{
+    char tmp[CJLIB_DTOA_BUF_SIZE];
+    const char *curr;
+
+    for (int precision = 1; precision <= DTOA_MAX_DIGITS; precision++) {
+        (void) snprintf(tmp, sizeof(tmp), "%.*e", precision - 1, value);
+        if (strtod(tmp, NULL) == value) break;
+    }
+
+    // d.ddde[+-]xx, the decimal point depends on the locale.
+    *len = 0;
+    for (curr = tmp; 'e' != *curr; curr++) {
+        if (isdigit((unsigned char) *curr)) buf[(*len)++] = *curr;
+    }
+    while (*len > 1 && '0' == buf[*len - 1]) --(*len);
+
+    *dec_exp = atoi(curr + 1) - (*len - 1);
+}
+
+/**
+ * Lays out the digits, digits * 10^dec_exp, in either the plain decimal or the exponent notation.
+ *
+ * @return The number of characters written.
+ */
+static size_t format_digits(char *restrict dst, const char *restrict digits, int len, int dec_exp)
+{
+    const int point = len + dec_exp; // The position of the decimal point relative to the digits.
+    char *curr      = dst;
+    int exp;
+
+    if (len <= point && point <= DTOA_DECIMAL_MAX_POINT) {
+        // dddd000
+        (void) memcpy(curr, digits, (size_t) len);
+        (void) memset(curr + len, '0', (size_t) (point - len));
+        return (size_t) point;
+    }
+
+    if (0 < point && point <= DTOA_DECIMAL_MAX_POINT) {
+        // dd.dd
+        (void) memcpy(curr, digits, (size_t) point);
+        curr[point] = '.';
+        (void) memcpy(curr + point + 1, digits + point, (size_t) (len - point));
+        return (size_t) len + 1;
+    }
+
+    if (DTOA_DECIMAL_MIN_POINT < point && point <= 0) {
+        // 0.000dd
+        curr[0] = '0';
+        curr[1] = '.';
+        (void) memset(curr + 2, '0', (size_t) -point);
+        (void) memcpy(curr + 2 - point, digits, (size_t) len);
+        return (size_t) (2 - point + len);
+    }
+
+    // d.ddde+xx
+    *curr++ = digits[0];
+    if (len > 1) {
+        *curr++ = '.';
+        (void) memcpy(curr, digits + 1, (size_t) (len - 1));
+        curr += len - 1;
+    }
+
+    *curr++ = 'e';
+    exp     = point - 1;
+    if (exp < 0) {
+        *curr++ = '-';
+        exp     = -exp;
+    } else {
+        *curr++ = '+';
+    }
+    curr += write_uint64(curr, (uint64_t) exp);
+
+    return (size_t) (curr - dst);
+}
+
+size_t cjlib_dtoa(char *restrict dst, double value)
+{
+    char digits[DTOA_MAX_DIGITS + 1];
+    char *curr = dst;
+    int len;
+    int dec_exp;
+
+    if (!isfinite(value)) {
+        // JSON has no representation for NaN and infinity.
+        (void) memcpy(dst, "null", sizeof("null"));
+        return sizeof("null") - 1;
+    }
+
+    if (signbit(value)) {
+        *curr++ = '-';
+        value   = -value;
+    }
+
+    if (value < DTOA_MAX_SAFE_INTEGER && value == (double) (uint64_t) value) {
+        // Fast path, the value is an integer.
+        curr += write_uint64(curr, (uint64_t) value);
+    } else {
+        if (!grisu3(digits, &len, &dec_exp, value)) fallback(digits, &len, &dec_exp, value);
+        curr += format_digits(curr, digits, len, dec_exp);
+    }
+
+    *curr = '\0';
+    return (size_t) (curr - dst);
+}
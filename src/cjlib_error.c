@@ -17,29 +17,39 @@
  *************************************************************************
  */
 
-#include <threads.h>
+#include <string.h>
 
 #include "cjlib_error.h"
 
-static struct cjlib_json_error g_error;
-static mtx_t g_error_mtx;
+// Each thread reports its errors in its own structure, no lock is required.
+static _Thread_local struct cjlib_json_error g_error;
+
+/**
+ * Copies a string in a buffer of the error, truncating it if it does not fit.
+ *
+ * @param dst The buffer of the error (CJLIB_ERROR_FIELD_SIZE bytes).
+ * @param src The string to copy (can be NULL).
+ */
+static inline void copy_error_field(char *restrict dst, const char *restrict src)
+{
+    if (NULL == src) src = "";
+    size_t src_s = strnlen(src, CJLIB_ERROR_FIELD_SIZE - 1);
+
+    (void) memcpy(dst, src, src_s);
+    dst[src_s] = '\0';
+}
 
 int cjlib_json_error_init(void)
 {
     (void) memset(&g_error, 0x0, sizeof(struct cjlib_json_error));
     g_error.c_error_code = NO_ERROR;
 
-    if (thrd_error == mtx_init(&g_error_mtx, mtx_plain)) return -1;
-
     return 0;
 }
 
 void cjlib_json_error_destroy(void)
 {
-    free(g_error.c_property_name);
-    free(g_error.c_property_value);
-
-    mtx_destroy(&g_error_mtx);
+    (void) cjlib_json_error_init();
 }
 
 void cjlib_json_get_error(struct cjlib_json_error *restrict dst)
@@ -47,18 +57,20 @@ void cjlib_json_get_error(struct cjlib_json_error *restrict dst)
     (void) memcpy(dst, &g_error, sizeof(struct cjlib_json_error));
 }
 
+void cjlib_make_error
+(struct cjlib_json_error *restrict dst, const char *property_name,
+ const char *property_value, enum cjlib_json_error_types error_code)
+{
+    copy_error_field(dst->c_property_name, property_name);
+    copy_error_field(dst->c_property_value, property_value);
+    dst->c_error_code = error_code;
+}
+
 void cjlib_setup_error
 (const char *property_name, const char *property_value,
  enum cjlib_json_error_types error_code)
 {
-    // Lock the mutex, in order to be thread safe.
-    if (thrd_error == mtx_lock(&g_error_mtx)) return;
-
-    g_error.c_property_name  = strdup(property_name);
-    g_error.c_property_value = strdup(property_value);
-    g_error.c_error_code     = error_code;
-    // Unlock the mutex.
-    if (thrd_error == mtx_unlock(&g_error_mtx)) return;
+    cjlib_make_error(&g_error, property_name, property_value, error_code);
 }
 
 enum cjlib_json_error_types cjlib_error_indicator_correction(int func_err_code)
@@ -0,0 +1,320 @@
+/* File: cjlib_escape.c
+ *
+ * This file contains the escaping (and unescaping) of the contents of
+ * JSON strings. The search for the bytes that require escaping is done
+ * in blocks of 32/16 bytes using SIMD instructions, when available, or
+ * in words of 8 bytes otherwise.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "cjlib.h"
+#include "cjlib_escape.h"
+
+#define DOUBLE_QUOTES (0x22) // ASCII representative of "
+#define BACKSLASH     (0x5C) // ASCII representative of \ (backslash)
+#define CONTROL_MAX   (0x1F) // The last control character.
+
+// The length of an escaped control character without shorthand, \u00XX.
+#define UNICODE_ESCAPE_LEN (0x6)
+
+// SWAR helpers, they operate on all the bytes of a 64-bit word at once.
+#define SWAR_ONES  (0x0101010101010101ULL)
+#define SWAR_HIGHS (0x8080808080808080ULL)
+#define SWAR_BROADCAST(BYTE) (SWAR_ONES * (uint64_t) (BYTE))
+// Non zero if any byte of WORD is less than N (N <= 128).
+#define SWAR_HAS_LESS(WORD, N) (((WORD) - SWAR_BROADCAST(N)) & ~(WORD) & SWAR_HIGHS)
+// Non zero if any byte of WORD is zero.
+#define SWAR_HAS_ZERO(WORD) SWAR_HAS_LESS(WORD, 1)
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/**
+ * The shorthand escape of each control character, or 0 if it has to be
+ * written in the \u00XX form.
+ */
+static const char control_shorthand[CONTROL_MAX + 1] = {
+    ['\b'] = 'b',
+    ['\t'] = 't',
+    ['\n'] = 'n',
+    ['\f'] = 'f',
+    ['\r'] = 'r'
+};
+
+static CJLIB_ALWAYS_INLINE bool needs_escape(unsigned char byte)
+{
+    return byte <= CONTROL_MAX || DOUBLE_QUOTES == byte || BACKSLASH == byte;
+}
+
+/**
+ * Finds the first byte of @src that must be escaped.
+ *
+ * @param src The string to examine.
+ * @param len The length of the string.
+ * @return The index of the first byte that must be escaped, or @len if there is none.
+ */
+static size_t find_escape(const unsigned char *restrict src, size_t len)
+{
+    size_t i = 0;
+    uint64_t word;
+
+#if defined(__AVX2__)
+    const __m256i quotes_32    = _mm256_set1_epi8(DOUBLE_QUOTES);
+    const __m256i backslash_32 = _mm256_set1_epi8(BACKSLASH);
+    const __m256i control_32   = _mm256_set1_epi8(CONTROL_MAX);
+    __m256i block_32;
+    __m256i found_32;
+    unsigned int mask_32;
+
+    for (; i + 32 <= len; i += 32) {
+        block_32 = _mm256_loadu_si256((const __m256i *) (src + i));
+        // max(byte, 0x1F) == 0x1F only for the control characters.
+        found_32 = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block_32, quotes_32),
+                                                   _mm256_cmpeq_epi8(block_32, backslash_32)),
+                                   _mm256_cmpeq_epi8(_mm256_max_epu8(block_32, control_32), control_32));
+        mask_32 = (unsigned int) _mm256_movemask_epi8(found_32);
+        if (0 != mask_32) return i + (size_t) __builtin_ctz(mask_32);
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i quotes_16    = _mm_set1_epi8(DOUBLE_QUOTES);
+    const __m128i backslash_16 = _mm_set1_epi8(BACKSLASH);
+    const __m128i control_16   = _mm_set1_epi8(CONTROL_MAX);
+    __m128i block_16;
+    __m128i found_16;
+    unsigned int mask_16;
+
+    for (; i + 16 <= len; i += 16) {
+        block_16 = _mm_loadu_si128((const __m128i *) (src + i));
+        found_16 = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block_16, quotes_16),
+                                             _mm_cmpeq_epi8(block_16, backslash_16)),
+                                _mm_cmpeq_epi8(_mm_max_epu8(block_16, control_16), control_16));
+        mask_16 = (unsigned int) _mm_movemask_epi8(found_16);
+        if (0 != mask_16) return i + (size_t) __builtin_ctz(mask_16);
+    }
+#endif
+
+    for (; i + 8 <= len; i += 8) {
+        (void) memcpy(&word, src + i, sizeof(word));
+        if (SWAR_HAS_LESS(word, CONTROL_MAX + 1) ||
+            SWAR_HAS_ZERO(word ^ SWAR_BROADCAST(DOUBLE_QUOTES)) ||
+            SWAR_HAS_ZERO(word ^ SWAR_BROADCAST(BACKSLASH))) break;
+    }
+
+    for (; i < len; i++) {
+        if (needs_escape(src[i])) return i;
+    }
+
+    return len;
+}
+
+/**
+ * Writes the escape sequence of a single byte.
+ *
+ * @return The length of the escape sequence.
+ */
+static CJLIB_ALWAYS_INLINE size_t escape_byte(char *restrict dst, unsigned char byte)
+{
+    dst[0] = BACKSLASH;
+    if (DOUBLE_QUOTES == byte || BACKSLASH == byte) {
+        dst[1] = (char) byte;
+        return 2;
+    }
+
+    if (0 != control_shorthand[byte]) {
+        dst[1] = control_shorthand[byte];
+        return 2;
+    }
+
+    (void) memcpy(dst + 1, "u00", 3);
+    dst[4] = hex_digits[byte >> 4];
+    dst[5] = hex_digits[byte & 0xF];
+    return UNICODE_ESCAPE_LEN;
+}
+
+static CJLIB_ALWAYS_INLINE size_t escape_byte_size(unsigned char byte)
+{
+    if (DOUBLE_QUOTES == byte || BACKSLASH == byte || 0 != control_shorthand[byte]) return 2;
+    return UNICODE_ESCAPE_LEN;
+}
+
+size_t cjlib_escaped_size(const char *restrict src, size_t len)
+{
+    const unsigned char *curr = (const unsigned char *) src;
+    size_t size               = len;
+    size_t run;
+
+    while (len > 0) {
+        run   = find_escape(curr, len);
+        curr += run;
+        len  -= run;
+        if (0 == len) break;
+
+        size += escape_byte_size(*curr) - 1;
+        curr++;
+        len--;
+    }
+
+    return size;
+}
+
+size_t cjlib_escape(char *restrict dst, const char *restrict src, size_t len)
+{
+    const unsigned char *curr = (const unsigned char *) src;
+    char *out                 = dst;
+    size_t run;
+
+    while (len > 0) {
+        // Copy the run of bytes that need no escaping as it is.
+        run = find_escape(curr, len);
+        (void) memcpy(out, curr, run);
+        out  += run;
+        curr += run;
+        len  -= run;
+        if (0 == len) break;
+
+        out += escape_byte(out, *curr);
+        curr++;
+        len--;
+    }
+
+    return (size_t) (out - dst);
+}
+
+static inline int hex_value(char digit)
+{
+    if (digit >= '0' && digit <= '9') return digit - '0';
+    if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+    if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Reads the four hex digits of a \uXXXX escape.
+ *
+ * @return The code unit, or -1 if the digits are invalid.
+ */
+static inline long read_code_unit(const char *src)
+{
+    long unit = 0;
+    int digit;
+
+    for (int i = 0; i < 4; i++) {
+        digit = hex_value(src[i]);
+        if (-1 == digit) return -1;
+        unit = (unit << 4) | digit;
+    }
+
+    return unit;
+}
+
+/**
+ * Writes a code point as UTF-8.
+ *
+ * @return The number of bytes written.
+ */
+static inline size_t write_utf8(char *dst, unsigned long code_point)
+{
+    if (code_point < 0x80) {
+        dst[0] = (char) code_point;
+        return 1;
+    }
+    if (code_point < 0x800) {
+        dst[0] = (char) (0xC0 | (code_point >> 6));
+        dst[1] = (char) (0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        dst[0] = (char) (0xE0 | (code_point >> 12));
+        dst[1] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+        dst[2] = (char) (0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    dst[0] = (char) (0xF0 | (code_point >> 18));
+    dst[1] = (char) (0x80 | ((code_point >> 12) & 0x3F));
+    dst[2] = (char) (0x80 | ((code_point >> 6) & 0x3F));
+    dst[3] = (char) (0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+size_t cjlib_unescape(char *dst, const char *src, size_t len)
+{
+    const char *end = src + len;
+    char *out       = dst;
+    long unit;
+    long low_unit;
+    unsigned long code_point;
+
+    while (src < end) {
+        if (BACKSLASH != *src || src + 1 == end) {
+            *out++ = *src++;
+            continue;
+        }
+
+        switch (src[1]) {
+            case '"':  *out++ = '"';  break;
+            case '\\': *out++ = '\\'; break;
+            case '/':  *out++ = '/';  break;
+            case 'b':  *out++ = '\b'; break;
+            case 'f':  *out++ = '\f'; break;
+            case 'n':  *out++ = '\n'; break;
+            case 'r':  *out++ = '\r'; break;
+            case 't':  *out++ = '\t'; break;
+            case 'u':
+                unit = (end - src >= 6) ? read_code_unit(src + 2) : -1;
+                if (-1 == unit) goto invalid_escape;
+
+                code_point = (unsigned long) unit;
+                if (unit >= 0xD800 && unit <= 0xDBFF && end - src >= 12 &&
+                    BACKSLASH == src[6] && 'u' == src[7]) {
+                    // A surrogate pair, combine the two code units.
+                    low_unit = read_code_unit(src + 8);
+                    if (low_unit >= 0xDC00 && low_unit <= 0xDFFF) {
+                        code_point = 0x10000 + (((unsigned long) unit - 0xD800) << 10)
+                                     + ((unsigned long) low_unit - 0xDC00);
+                        src += 6;
+                    }
+                }
+
+                out += write_utf8(out, code_point);
+                src += 4;
+                break;
+            default:
+                goto invalid_escape;
+        }
+
+        src += 2;
+        continue;
+
+invalid_escape:
+        // Not a valid escape sequence, keep it as it is.
+        *out++ = *src++;
+    }
+
+    *out = '\0';
+    return (size_t) (out - dst);
+}
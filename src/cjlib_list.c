@@ -22,6 +22,7 @@
 #include <stdbool.h>
 
 #include "cjlib_list.h"
+#include "cjlib_memory.h"
 
 int cjlib_list_append(const void *restrict src, size_t s_size, struct cjlib_list *list)
 {
@@ -35,11 +36,11 @@ int cjlib_list_append(const void *restrict src, size_t s_size, struct cjlib_list
     while (tmp->l_next) tmp = tmp->l_next;
 
 skip:
-    new_node = (struct cjlib_list_node *) malloc(sizeof(struct cjlib_list_node));
+    new_node = (struct cjlib_list_node *) cjlib_malloc(sizeof(struct cjlib_list_node));
     if (NULL == new_node) return -1;
 
     new_node->l_next = NULL;
-    new_node->l_data = malloc(s_size);
+    new_node->l_data = cjlib_malloc(s_size);
     if (NULL == new_node->l_data) return -1;
 
     (void) memcpy(new_node->l_data, (void *) src, s_size);
@@ -53,9 +54,9 @@ skip:
     return 0;
 }
 
-int cjlib_list_get(void *restrict dst, size_t s_size, int index, const struct cjlib_list *list)
+void *cjlib_list_at(int index, const struct cjlib_list *list)
 {
-    if (NULL == list) return -1;
+    if (NULL == list) return NULL;
 
     struct cjlib_list_node *tmp = list->l_head;
     int count                   = 0;
@@ -65,9 +66,15 @@ int cjlib_list_get(void *restrict dst, size_t s_size, int index, const struct cj
         count++;
     }
 
-    if (NULL == tmp) return -1;
+    return (NULL == tmp) ? NULL : tmp->l_data;
+}
+
+int cjlib_list_get(void *restrict dst, size_t s_size, int index, const struct cjlib_list *list)
+{
+    void *data = cjlib_list_at(index, list);
+    if (NULL == data) return -1;
 
-    (void) memcpy(dst, tmp->l_data, s_size);
+    (void) memcpy(dst, data, s_size);
     return 0;
 }
 
@@ -89,16 +96,17 @@ int cjlib_list_destroy(struct cjlib_list *restrict src, void (*data_disposal_rou
     while (tmp->l_next) {
         tmp = tmp->l_next;
         data_disposal_routine(remove->l_data);
-        free(remove->l_data);
-        free(remove);
+        cjlib_free(remove->l_data);
+        cjlib_free(remove);
         remove = tmp;
     }
 
     data_disposal_routine(tmp->l_data);
-    free(tmp->l_data);
-    free(tmp);
+    cjlib_free(tmp->l_data);
+    cjlib_free(tmp);
 
 cjlib_list_done:
-    free(src);
+    cjlib_fragment_drop(&src->l_fragment);
+    cjlib_free(src);
     return 0;
 }
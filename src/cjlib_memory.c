@@ -0,0 +1,295 @@
+/* File: cjlib_memory.c
+ *
+ * This file contains the allocation routines of the library, which keep
+ * the global counters of its memory (when enabled), and reuse the blocks that a json kept
+ * on its reset.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "cjlib.h"
+#include "cjlib_memory.h"
+
+#define MEMORY_STRIPES    (0x40) // The stripes of the counters, the threads share one only when there are more.
+#define MEMORY_CACHE_LINE (0x40) // Each stripe is kept on a separate cache line.
+
+/**
+ * A stripe of the counters. Each thread updates the stripe it was given (relaxed), thus the
+ * threads do not contend; a block may be freed on another stripe, only the sum is exact.
+ */
+struct memory_stripe
+{
+    _Alignas(MEMORY_CACHE_LINE) atomic_size_t s_live_bytes;
+    atomic_size_t s_live_allocations;
+    atomic_size_t s_allocations;
+};
+
+// The counters are off, unless they are enabled (see cjlib_json_memory_counters_enable).
+static atomic_bool g_counting;
+static struct memory_stripe g_stripes[MEMORY_STRIPES];
+static atomic_uint g_next_stripe;
+static _Thread_local struct memory_stripe *g_stripe;
+
+// The spare blocks that the allocation routines of each thread reuse (see cjlib_memory_spare_use).
+static _Thread_local struct cjlib_json_spare *g_spare;
+
+static CJLIB_ALWAYS_INLINE size_t block_size(void *src)
+{
+    return malloc_usable_size(src) + CJLIB_MEMORY_CHUNK_HEADER;
+}
+
+static CJLIB_ALWAYS_INLINE bool counting(void)
+{
+    return atomic_load_explicit(&g_counting, memory_order_relaxed);
+}
+
+/**
+ * The stripe of the counters of the calling thread, given on its first use.
+ */
+static inline struct memory_stripe *stripe(void)
+{
+    if (NULL == g_stripe) {
+        g_stripe = &g_stripes[atomic_fetch_add_explicit(&g_next_stripe, 1, memory_order_relaxed) % MEMORY_STRIPES];
+    }
+    return g_stripe;
+}
+
+static inline void count_allocation(void *src)
+{
+    struct memory_stripe *dst;
+
+    if (!counting()) return;
+
+    dst = stripe();
+    atomic_fetch_add_explicit(&dst->s_live_bytes, block_size(src), memory_order_relaxed);
+    atomic_fetch_add_explicit(&dst->s_live_allocations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&dst->s_allocations, 1, memory_order_relaxed);
+}
+
+/**
+ * Rounds the bytes of a block up to its class, while the spare blocks are in use, thus the
+ * block holds any size of its class when it is reused (the allocator may round it less).
+ *
+ * @param size The bytes that are asked for.
+ * @return The bytes to allocate.
+ */
+static CJLIB_ALWAYS_INLINE size_t spare_size(size_t size)
+{
+    if (NULL == g_spare || CJLIB_MEMORY_SPARE_MAX < size) return size;
+    return (size + CJLIB_MEMORY_SPARE_STEP - 1) & ~((size_t) CJLIB_MEMORY_SPARE_STEP - 1);
+}
+
+/**
+ * Takes a spare block that holds at least @size bytes.
+ *
+ * @param size The bytes that are asked for.
+ * @return The block, or NULL if there is no spare block of that class.
+ */
+static inline void *take_spare(size_t size)
+{
+    size_t class = spare_size(size) / CJLIB_MEMORY_SPARE_STEP;
+    void *block;
+
+    if (CJLIB_MEMORY_SPARE_MAX < size) return NULL;
+
+    // A block is kept in the class of the bytes it holds (rounded down), while @size is rounded
+    // up, thus every block of the class (or of the next one) holds it.
+    block = g_spare->s_bins[class];
+    if (NULL == block) block = g_spare->s_bins[++class];
+    if (NULL == block) return NULL;
+
+    // The block is still counted as live, it never left the library.
+    g_spare->s_bins[class] = *((void **) block);
+    return block;
+}
+
+/**
+ * Keeps a block as spare, in the class of the bytes it can hold.
+ *
+ * @param src The block.
+ * @return true if the block is kept, otherwise false (it is too small or too large).
+ */
+static inline bool give_spare(void *src)
+{
+    size_t usable = malloc_usable_size(src);
+    size_t class  = usable / CJLIB_MEMORY_SPARE_STEP;
+
+    // The spare blocks are linked through their first bytes.
+    if (usable < sizeof(void *) || CJLIB_MEMORY_SPARE_MAX / CJLIB_MEMORY_SPARE_STEP < class) return false;
+
+    *((void **) src)       = g_spare->s_bins[class];
+    g_spare->s_bins[class] = src;
+    return true;
+}
+
+/**
+ * Frees a block, without keeping it as spare.
+ *
+ * @param src The block.
+ */
+static void release(void *src)
+{
+    struct memory_stripe *dst;
+
+    if (NULL != src && counting()) {
+        dst = stripe();
+        atomic_fetch_sub_explicit(&dst->s_live_bytes, block_size(src), memory_order_relaxed);
+        atomic_fetch_sub_explicit(&dst->s_live_allocations, 1, memory_order_relaxed);
+    }
+    free(src);
+}
+
+bool cjlib_json_memory_counters_enable(bool enable)
+{
+    return atomic_exchange_explicit(&g_counting, enable, memory_order_relaxed);
+}
+
+void cjlib_json_memory_counters(struct cjlib_json_memory_counters *restrict dst)
+{
+    (void) memset(dst, 0x0, sizeof(struct cjlib_json_memory_counters));
+
+    // The stripes wrap around on their own (a block freed on another one), their sum does not.
+    for (size_t i = 0; i < MEMORY_STRIPES; i++) {
+        dst->c_live_bytes       += atomic_load_explicit(&g_stripes[i].s_live_bytes, memory_order_relaxed);
+        dst->c_live_allocations += atomic_load_explicit(&g_stripes[i].s_live_allocations, memory_order_relaxed);
+        dst->c_allocations      += atomic_load_explicit(&g_stripes[i].s_allocations, memory_order_relaxed);
+    }
+}
+
+void *cjlib_malloc(size_t size)
+{
+    void *block = (NULL == g_spare) ? NULL : take_spare(size);
+    if (NULL != block) return block;
+
+    block = malloc(spare_size(size));
+    if (NULL != block) count_allocation(block);
+    return block;
+}
+
+void *cjlib_calloc(size_t count, size_t size)
+{
+    void *block = (NULL == g_spare || 0 == size || SIZE_MAX / size < count) ? NULL : take_spare(count * size);
+    if (NULL != block) return memset(block, 0x0, count * size);
+
+    block = (NULL == g_spare || 0 == size || SIZE_MAX / size < count) ? calloc(count, size) : calloc(1, spare_size(count * size));
+    if (NULL != block) count_allocation(block);
+    return block;
+}
+
+/**
+ * Resizes a block through the spare blocks, thus the block it replaces is kept for reuse.
+ *
+ * @param src The block (not NULL).
+ * @param size The bytes that are asked for.
+ * @return The block, or NULL if there is no spare block that holds @size bytes.
+ */
+static void *resize_spare(void *src, size_t size)
+{
+    size_t usable = malloc_usable_size(src);
+    void *block;
+
+    if (size <= usable) return src;
+    if (NULL == (block = take_spare(size))) return NULL;
+
+    (void) memcpy(block, src, usable);
+    cjlib_free(src);
+    return block;
+}
+
+void *cjlib_realloc(void *src, size_t size)
+{
+    struct memory_stripe *dst;
+    size_t previous_s;
+    bool count;
+    void *block;
+
+    if (NULL != g_spare) {
+        block = (NULL == src) ? take_spare(size) : resize_spare(src, size);
+        if (NULL != block) return block;
+    }
+
+    count      = counting();
+    previous_s = (NULL != src && count) ? block_size(src) : 0;
+    block      = realloc(src, spare_size(size));
+
+    if (NULL == block) return block;
+
+    if (NULL == src) {
+        count_allocation(block);
+    } else if (count) {
+        dst = stripe();
+        atomic_fetch_add_explicit(&dst->s_live_bytes, block_size(block), memory_order_relaxed);
+        atomic_fetch_sub_explicit(&dst->s_live_bytes, previous_s, memory_order_relaxed);
+    }
+    return block;
+}
+
+void cjlib_free(void *src)
+{
+    if (NULL != src && NULL != g_spare && give_spare(src)) return;
+    release(src);
+}
+
+char *cjlib_strdup(const char *src)
+{
+    size_t src_s = strlen(src) + 1;
+    char *copy   = (char *) cjlib_malloc(src_s);
+
+    if (NULL == copy) return NULL;
+    return (char *) memcpy(copy, src, src_s);
+}
+
+struct cjlib_json_spare *cjlib_memory_spare_use(struct cjlib_json_spare *src)
+{
+    struct cjlib_json_spare *previous = g_spare;
+
+    g_spare = src;
+    return previous;
+}
+
+void cjlib_memory_spare_release(struct cjlib_json_spare *src)
+{
+    void *block;
+
+    if (NULL == src) return;
+
+    for (size_t i = 0; i < sizeof(src->s_bins) / sizeof(void *); i++) {
+        while (NULL != (block = src->s_bins[i])) {
+            src->s_bins[i] = *((void **) block);
+            release(block);
+        }
+    }
+    release(src);
+}
+
+void cjlib_memory_spare_usage(struct cjlib_json_memory *restrict dst, const struct cjlib_json_spare *src)
+{
+    if (NULL == src) return;
+
+    cjlib_memory_account(dst, &dst->m_spare, src, sizeof(struct cjlib_json_spare));
+    for (size_t i = 0; i < sizeof(src->s_bins) / sizeof(void *); i++) {
+        for (const void *block = src->s_bins[i]; NULL != block; block = *((void *const *) block)) {
+            cjlib_memory_account(dst, &dst->m_spare, block, malloc_usable_size((void *) block));
+        }
+    }
+}
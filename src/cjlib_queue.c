@@ -22,6 +22,7 @@
 
 #include "cjlib_queue.h"
 #include "cjlib_dictionary.h"
+#include "cjlib_memory.h"
 
 void cjlib_queue_deqeue(void *restrict dst, size_t d_size, struct cjlib_queue *restrict queue)
 {
@@ -30,8 +31,8 @@ void cjlib_queue_deqeue(void *restrict dst, size_t d_size, struct cjlib_queue *r
     struct cjlib_queue_node *tmp = queue->front;
     queue->front                 = tmp->q_next;
     (void) memcpy((void *) dst, tmp->q_data, sizeof(d_size));
-    free(tmp->q_data);
-    free(tmp);
+    cjlib_free(tmp->q_data);
+    cjlib_free(tmp);
 }
 
 bool cjlib_queue_is_empty(const struct cjlib_queue *restrict queue)
@@ -57,9 +58,9 @@ int cjlib_queue_enqeue(const void *restrict src, size_t s_size, struct cjlib_que
 {
     if (NULL == src || NULL == queue) return -1;
 
-    struct cjlib_queue_node *new_node = (struct cjlib_queue_node *) malloc(sizeof(struct cjlib_queue_node));
+    struct cjlib_queue_node *new_node = (struct cjlib_queue_node *) cjlib_malloc(sizeof(struct cjlib_queue_node));
     if (NULL == new_node) return -1;
-    new_node->q_data = malloc(s_size);
+    new_node->q_data = cjlib_malloc(s_size);
     if (NULL == new_node->q_data) return -1;
 
     new_node->q_next = NULL;
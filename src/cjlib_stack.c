@@ -21,6 +21,7 @@
 #include <malloc.h>
 
 #include "cjlib_stack.h"
+#include "cjlib_memory.h"
 
 int cjlib_stack_pop(void *restrict dst, size_t d_size, struct cjlib_stack *restrict src)
 {
@@ -31,8 +32,8 @@ int cjlib_stack_pop(void *restrict dst, size_t d_size, struct cjlib_stack *restr
     src->s_top = src->s_top->s_next;
 
     (void) memcpy(dst, top_node->s_data, d_size);
-    free(top_node->s_data);
-    free(top_node);
+    cjlib_free(top_node->s_data);
+    cjlib_free(top_node);
 
     return 0;
 }
@@ -41,10 +42,10 @@ int cjlib_stack_push(const void *restrict src, size_t s_size, struct cjlib_stack
 {
     if (NULL == src || stack == NULL) return -1;
 
-    struct cjlib_stack_node *new_node = (struct cjlib_stack_node *) malloc(sizeof(struct cjlib_stack_node));
+    struct cjlib_stack_node *new_node = (struct cjlib_stack_node *) cjlib_malloc(sizeof(struct cjlib_stack_node));
     struct cjlib_stack_node *tmp      = NULL;
     if (NULL == new_node) return -1;
-    new_node->s_data = malloc(s_size);
+    new_node->s_data = cjlib_malloc(s_size);
 
     new_node->s_next = NULL;
     (void) memcpy(new_node->s_data, (void *) src, s_size);
@@ -0,0 +1,618 @@
+/* File: cjlib_tape.c
+ *
+ * This file contains the tape representation of a JSON. The JSON is parsed
+ * straight into one array of words (and one buffer of strings), which is
+ * only ever appended to, and it is written back by reading that array from
+ * the front to the back.
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "cjlib.h"
+#include "cjlib_error.h"
+#include "cjlib_dtoa.h"
+#include "cjlib_escape.h"
+
+#define TAPE_WORDS_INIT   (0x40) // The least number of words a tape starts with.
+#define TAPE_STRINGS_INIT (0x100) // The least size of the strings a tape starts with.
+#define TAPE_NUMBER_SIZE  (0x40) // The numbers shorter than this are converted without allocating.
+#define TAPE_POSITION_MAX (0xFFFFFFFFULL) // The positions of the words must fit in CJLIB_TAPE_END.
+
+#define TAPE_WORD(TAG, PAYLOAD) (((uint64_t) (TAG) << 56) | (uint64_t) (PAYLOAD))
+
+/**
+ * The state of the parsing of a tape. While an object/array is open, the low 32
+ * bits of its start hold the position of the object/array that it is in, instead
+ * of its end, thus the open ones form a stack inside the tape itself.
+ */
+struct tape_builder
+{
+    struct cjlib_json_tape *b_dst; // The tape being written.
+    size_t b_words_cap;            // The capacity of the words of the tape.
+    size_t b_strings_cap;          // The capacity of the strings of the tape.
+    size_t b_open;                 // The position of the innermost open object/array.
+    size_t b_depth;                // The number of open objects/arrays.
+    const char *b_src;             // The JSON to parse.
+    size_t b_src_s;                // The size of the JSON.
+    size_t b_pos;                  // The position of the next byte to read.
+};
+
+/**
+ * What the parser expects to read next.
+ */
+enum tape_state
+{
+    EXPECT_VALUE, // A value (at the beginning, after a key or after a comma in an array).
+    EXPECT_KEY,   // The key of a member (after a comma in an object).
+    EXPECT_NEXT   // A comma or the end of the innermost object/array (after a value).
+};
+
+static int tape_error(const struct tape_builder *restrict b, enum cjlib_json_error_types err_code)
+{
+    char value[CJLIB_ERROR_FIELD_SIZE];
+    size_t value_s = b->b_src_s - b->b_pos;
+
+    // The JSON may not end with a '\0', thus the part of it near the error is copied.
+    if (value_s > sizeof(value) - 1) value_s = sizeof(value) - 1;
+    (void) memcpy(value, b->b_src + b->b_pos, value_s);
+    value[value_s] = '\0';
+
+    cjlib_setup_error("", value, err_code);
+    return -1;
+}
+
+/**
+ * Skips the white spaces and reads the next byte of the JSON.
+ *
+ * @return The byte, or EOF if the JSON is over.
+ */
+static CJLIB_ALWAYS_INLINE int next_token(struct tape_builder *restrict b)
+{
+    while (b->b_pos < b->b_src_s) {
+        switch (b->b_src[b->b_pos++]) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                continue;
+            default:
+                return (unsigned char) b->b_src[b->b_pos - 1];
+        }
+    }
+    return EOF;
+}
+
+static int reserve_words(struct tape_builder *restrict b, size_t words_s)
+{
+    uint64_t *words;
+    size_t words_cap = b->b_words_cap;
+
+    if (CJLIB_BRANCH_LIKELY(b->b_dst->t_words_s + words_s <= words_cap)) return 0;
+    if (b->b_dst->t_words_s + words_s > TAPE_POSITION_MAX) return tape_error(b, MEMORY_ERROR);
+
+    while (b->b_dst->t_words_s + words_s > words_cap) words_cap *= 2;
+
+    words = (uint64_t *) cjlib_realloc(b->b_dst->t_words, sizeof(uint64_t) * words_cap);
+    if (NULL == words) return tape_error(b, MEMORY_ERROR);
+
+    b->b_dst->t_words = words;
+    b->b_words_cap    = words_cap;
+    return 0;
+}
+
+static int reserve_strings(struct tape_builder *restrict b, size_t strings_s)
+{
+    char *strings;
+    size_t strings_cap = b->b_strings_cap;
+
+    if (CJLIB_BRANCH_LIKELY(b->b_dst->t_strings_s + strings_s <= strings_cap)) return 0;
+
+    while (b->b_dst->t_strings_s + strings_s > strings_cap) strings_cap *= 2;
+
+    strings = (char *) cjlib_realloc(b->b_dst->t_strings, sizeof(char) * strings_cap);
+    if (NULL == strings) return tape_error(b, MEMORY_ERROR);
+
+    b->b_dst->t_strings = strings;
+    b->b_strings_cap    = strings_cap;
+    return 0;
+}
+
+static CJLIB_ALWAYS_INLINE int append_word(struct tape_builder *restrict b, uint64_t word)
+{
+    if (-1 == reserve_words(b, 1)) return -1;
+    b->b_dst->t_words[b->b_dst->t_words_s++] = word;
+    return 0;
+}
+
+/**
+ * Counts a completed value as a member of the innermost open object/array.
+ */
+static CJLIB_ALWAYS_INLINE void count_member(struct tape_builder *restrict b)
+{
+    uint64_t *open;
+
+    if (0 == b->b_depth) return;
+
+    open = &b->b_dst->t_words[b->b_open];
+    if (CJLIB_TAPE_COUNT(*open) < CJLIB_TAPE_COUNT_MAX) *open += (uint64_t) 1 << 32;
+}
+
+static int open_container(struct tape_builder *restrict b, enum cjlib_json_tape_tags tag)
+{
+    size_t at = b->b_dst->t_words_s;
+
+    if (-1 == append_word(b, TAPE_WORD(tag, (0 == b->b_depth) ? 0 : b->b_open))) return -1;
+
+    b->b_open = at;
+    b->b_depth++;
+    return 0;
+}
+
+static int close_container(struct tape_builder *restrict b)
+{
+    size_t at       = b->b_open;
+    size_t end      = b->b_dst->t_words_s;
+    uint64_t open   = b->b_dst->t_words[at];
+    unsigned int tag = CJLIB_TAPE_TAG(open);
+
+    if (-1 == append_word(b, TAPE_WORD((CJLIB_TAPE_OBJECT == tag) ? CJLIB_TAPE_OBJECT_END
+                                                                  : CJLIB_TAPE_ARRAY_END, at))) return -1;
+
+    // The start points to its end from now on, instead of to the object/array it is in.
+    b->b_dst->t_words[at] = TAPE_WORD(tag, ((uint64_t) CJLIB_TAPE_COUNT(open) << 32) | end);
+    b->b_open             = CJLIB_TAPE_END(open);
+    b->b_depth--;
+
+    count_member(b);
+    return 0;
+}
+
+/**
+ * Appends a string (or key), whose opening double quotes are read.
+ */
+static int append_string(struct tape_builder *restrict b, enum cjlib_json_tape_tags tag)
+{
+    size_t begin = b->b_pos;
+    size_t raw_s;
+    size_t offset;
+    uint32_t decoded_s;
+
+    while (b->b_pos < b->b_src_s && '"' != b->b_src[b->b_pos]) {
+        b->b_pos += ('\\' == b->b_src[b->b_pos]) ? 2 : 1;
+    }
+    if (b->b_pos >= b->b_src_s) {
+        b->b_pos = begin;
+        return tape_error(b, INCOMPLETE_DOUBLE_QUOTES);
+    }
+
+    raw_s = b->b_pos - begin;
+    if (raw_s > UINT32_MAX) return tape_error(b, MEMORY_ERROR);
+
+    // The decoded string is never longer than the raw one.
+    if (-1 == reserve_strings(b, sizeof(uint32_t) + raw_s + 1)) return -1;
+    if (-1 == reserve_words(b, 1)) return -1;
+
+    offset    = b->b_dst->t_strings_s;
+    decoded_s = (uint32_t) cjlib_unescape(b->b_dst->t_strings + offset + sizeof(uint32_t), b->b_src + begin, raw_s);
+    (void) memcpy(b->b_dst->t_strings + offset, &decoded_s, sizeof(uint32_t));
+
+    b->b_dst->t_strings_s += sizeof(uint32_t) + decoded_s + 1;
+    b->b_dst->t_words[b->b_dst->t_words_s++] = TAPE_WORD(tag, offset);
+    b->b_pos++;
+
+    if (CJLIB_TAPE_STRING == tag) count_member(b);
+    return 0;
+}
+
+static CJLIB_ALWAYS_INLINE bool skip_digits(struct tape_builder *restrict b)
+{
+    size_t begin = b->b_pos;
+    while (b->b_pos < b->b_src_s && isdigit((unsigned char) b->b_src[b->b_pos])) b->b_pos++;
+    return b->b_pos != begin;
+}
+
+static CJLIB_ALWAYS_INLINE bool skip_byte(struct tape_builder *restrict b, char byte)
+{
+    if (b->b_pos >= b->b_src_s || byte != b->b_src[b->b_pos]) return false;
+    b->b_pos++;
+    return true;
+}
+
+/**
+ * Appends a number, whose first byte is read.
+ */
+static int append_number(struct tape_builder *restrict b)
+{
+    char number_init[TAPE_NUMBER_SIZE];
+    char *number = number_init;
+    size_t begin = b->b_pos - 1;
+    size_t number_s;
+    cjlib_json_num value;
+
+    // Follows the JSON grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    b->b_pos = begin;
+    (void) skip_byte(b, '-');
+    if (!skip_byte(b, '0') && !skip_digits(b)) goto append_number_err;
+    if (skip_byte(b, '.') && !skip_digits(b)) goto append_number_err;
+    if (skip_byte(b, 'e') || skip_byte(b, 'E')) {
+        if (!skip_byte(b, '+')) (void) skip_byte(b, '-');
+        if (!skip_digits(b)) goto append_number_err;
+    }
+
+    // The JSON may not end with a '\0', thus the number is copied before it is converted.
+    number_s = b->b_pos - begin;
+    if (number_s >= TAPE_NUMBER_SIZE) {
+        number = (char *) cjlib_malloc(sizeof(char) * (number_s + 1));
+        if (NULL == number) return tape_error(b, MEMORY_ERROR);
+    }
+    (void) memcpy(number, b->b_src + begin, number_s);
+    number[number_s] = '\0';
+    value = strtod(number, NULL);
+    if (number != number_init) cjlib_free(number);
+
+    if (-1 == reserve_words(b, 2)) return -1;
+    b->b_dst->t_words[b->b_dst->t_words_s++] = TAPE_WORD(CJLIB_TAPE_NUMBER, 0);
+    (void) memcpy(&b->b_dst->t_words[b->b_dst->t_words_s++], &value, sizeof(uint64_t));
+
+    count_member(b);
+    return 0;
+
+append_number_err:
+    b->b_pos = begin;
+    return tape_error(b, INVALID_NUMBER);
+}
+
+/**
+ * Appends true, false or null, whose first byte is read.
+ */
+static int append_literal(struct tape_builder *restrict b, const char *literal, enum cjlib_json_tape_tags tag)
+{
+    size_t literal_s = strlen(literal);
+    size_t begin     = b->b_pos - 1;
+
+    if (b->b_src_s - begin < literal_s || 0 != memcmp(b->b_src + begin, literal, literal_s)) {
+        b->b_pos = begin;
+        return tape_error(b, INVALID_TYPE);
+    }
+    b->b_pos = begin + literal_s;
+
+    if (-1 == append_word(b, TAPE_WORD(tag, 0))) return -1;
+
+    count_member(b);
+    return 0;
+}
+
+/**
+ * Appends the value that starts with a byte, which is read.
+ *
+ * @param b The state of the parsing.
+ * @param byte The first byte of the value.
+ * @param state Where to store what is expected after the value.
+ * @return 0 on success, otherwise -1.
+ */
+static int append_value(struct tape_builder *restrict b, int byte, enum tape_state *restrict state)
+{
+    int next;
+
+    *state = EXPECT_NEXT;
+
+    switch (byte) {
+        case '{':
+        case '[':
+            if (-1 == open_container(b, ('{' == byte) ? CJLIB_TAPE_OBJECT : CJLIB_TAPE_ARRAY)) return -1;
+
+            next = next_token(b);
+            if (('{' == byte && '}' == next) || ('[' == byte && ']' == next)) return close_container(b);
+
+            // Read the first member again, as a key or a value.
+            if (EOF != next) b->b_pos--;
+            *state = ('{' == byte) ? EXPECT_KEY : EXPECT_VALUE;
+            return 0;
+        case '"':
+            return append_string(b, CJLIB_TAPE_STRING);
+        case 't':
+            return append_literal(b, "true", CJLIB_TAPE_TRUE);
+        case 'f':
+            return append_literal(b, "false", CJLIB_TAPE_FALSE);
+        case 'n':
+            return append_literal(b, "null", CJLIB_TAPE_NULL);
+        case EOF:
+            return tape_error(b, (0 == b->b_depth) ? INVALID_JSON
+                                                   : (CJLIB_TAPE_OBJECT == CJLIB_TAPE_TAG(b->b_dst->t_words[b->b_open]))
+                                                     ? INCOMPLETE_CURLY_BRACKETS : INCOMPLETE_SQUARE_BRACKETS);
+        default:
+            if ('-' == byte || isdigit(byte)) return append_number(b);
+            b->b_pos--;
+            return tape_error(b, INVALID_TYPE);
+    }
+}
+
+/**
+ * Parses the JSON into the tape. No recursion is involved, thus the depth of the
+ * JSON is not limited by the size of the call stack.
+ *
+ * @param b The state of the parsing.
+ * @return 0 on success, otherwise -1.
+ */
+static int build_tape(struct tape_builder *restrict b)
+{
+    enum tape_state state = EXPECT_VALUE;
+    unsigned int open_tag;
+    int byte;
+
+    while (true) {
+        byte = next_token(b);
+
+        switch (state) {
+            case EXPECT_VALUE:
+                if (-1 == append_value(b, byte, &state)) return -1;
+                break;
+            case EXPECT_KEY:
+                if ('"' != byte) {
+                    if (EOF != byte) b->b_pos--;
+                    return tape_error(b, (EOF == byte) ? INCOMPLETE_CURLY_BRACKETS : INVALID_PROPERTY);
+                }
+                if (-1 == append_string(b, CJLIB_TAPE_KEY)) return -1;
+                if (':' != next_token(b)) return tape_error(b, MISSING_SEPERATOR);
+                state = EXPECT_VALUE;
+                break;
+            case EXPECT_NEXT:
+                if (0 == b->b_depth) {
+                    if (EOF == byte) return 0;
+                    b->b_pos--;
+                    return tape_error(b, INVALID_JSON);
+                }
+
+                open_tag = CJLIB_TAPE_TAG(b->b_dst->t_words[b->b_open]);
+                if (',' == byte) {
+                    state = (CJLIB_TAPE_OBJECT == open_tag) ? EXPECT_KEY : EXPECT_VALUE;
+                } else if ((CJLIB_TAPE_OBJECT == open_tag && '}' == byte) || (CJLIB_TAPE_ARRAY == open_tag && ']' == byte)) {
+                    if (-1 == close_container(b)) return -1;
+                } else if (EOF == byte) {
+                    return tape_error(b, (CJLIB_TAPE_OBJECT == open_tag) ? INCOMPLETE_CURLY_BRACKETS
+                                                                         : INCOMPLETE_SQUARE_BRACKETS);
+                } else {
+                    b->b_pos--;
+                    return tape_error(b, MISSING_COMMA);
+                }
+                break;
+        }
+    }
+}
+
+int cjlib_json_tape_parse(struct cjlib_json_tape *restrict dst, const char *restrict src, size_t src_s)
+{
+    struct tape_builder b;
+    uint64_t *words;
+    char *strings;
+
+    (void) memset(dst, 0x0, sizeof(struct cjlib_json_tape));
+    (void) memset(&b, 0x0, sizeof(struct tape_builder));
+    b.b_dst   = dst;
+    b.b_src   = src;
+    b.b_src_s = src_s;
+
+    // Most JSONs take fewer words than a quarter of their bytes, and fewer strings than their half.
+    b.b_words_cap   = (src_s / 4 > TAPE_WORDS_INIT) ? src_s / 4 : TAPE_WORDS_INIT;
+    b.b_strings_cap = (src_s / 2 > TAPE_STRINGS_INIT) ? src_s / 2 : TAPE_STRINGS_INIT;
+    dst->t_words    = (uint64_t *) cjlib_malloc(sizeof(uint64_t) * b.b_words_cap);
+    dst->t_strings  = (char *) cjlib_malloc(sizeof(char) * b.b_strings_cap);
+    if (NULL == dst->t_words || NULL == dst->t_strings) {
+        (void) tape_error(&b, MEMORY_ERROR);
+        goto tape_parse_err;
+    }
+
+    if (-1 == build_tape(&b)) goto tape_parse_err;
+
+    // Give back the capacity that is left, failing to do so is not an error.
+    words = (uint64_t *) cjlib_realloc(dst->t_words, sizeof(uint64_t) * dst->t_words_s);
+    if (NULL != words) dst->t_words = words;
+    strings = (char *) cjlib_realloc(dst->t_strings, sizeof(char) * ((0 == dst->t_strings_s) ? 1 : dst->t_strings_s));
+    if (NULL != strings) dst->t_strings = strings;
+
+    return 0;
+
+tape_parse_err:
+    cjlib_json_tape_destroy(dst);
+    return -1;
+}
+
+void cjlib_json_tape_destroy(struct cjlib_json_tape *restrict src)
+{
+    cjlib_free(src->t_words);
+    cjlib_free(src->t_strings);
+    (void) memset(src, 0x0, sizeof(struct cjlib_json_tape));
+}
+
+int cjlib_json_tape_object_get
+(size_t *restrict dst, const struct cjlib_json_tape *restrict src, size_t object, const char *restrict key)
+{
+    size_t key_s = strlen(key);
+    size_t end;
+
+    if (object >= src->t_words_s || CJLIB_TAPE_OBJECT != CJLIB_TAPE_TAG(src->t_words[object])) return -1;
+
+    end = CJLIB_TAPE_END(src->t_words[object]);
+    for (size_t at = object + 1; at < end; at = cjlib_json_tape_skip(src, at + 1)) {
+        // The length is compared first, thus most keys are rejected without reading them.
+        if (key_s == cjlib_json_tape_string_size(src, at) && 0 == memcmp(key, cjlib_json_tape_string(src, at), key_s)) {
+            *dst = at + 1;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int cjlib_json_tape_array_get(size_t *restrict dst, const struct cjlib_json_tape *restrict src, size_t array, int index)
+{
+    size_t end;
+    size_t at;
+
+    if (array >= src->t_words_s || CJLIB_TAPE_ARRAY != CJLIB_TAPE_TAG(src->t_words[array])) return -1;
+    if (index < 0 || (size_t) index >= cjlib_json_tape_size(src, array)) return -1;
+
+    end = CJLIB_TAPE_END(src->t_words[array]);
+    at  = array + 1;
+    for (int i = 0; i < index && at < end; i++) at = cjlib_json_tape_skip(src, at);
+
+    *dst = at;
+    return 0;
+}
+
+/**
+ * The state of the serialization of a tape. When w_dst is NULL, nothing is
+ * written and only the size of the serialization is calculated.
+ */
+struct tape_writer
+{
+    char *w_dst;    // Where to write the JSON (can be NULL).
+    size_t w_dst_s; // The size of w_dst.
+    size_t w_pos;   // The number of bytes produced so far.
+};
+
+static inline int writer_emit(struct tape_writer *restrict w, const char *restrict src, size_t src_s)
+{
+    if (NULL != w->w_dst) {
+        if (CJLIB_BRANCH_UNLIKELY(src_s > w->w_dst_s - w->w_pos)) return -1;
+        (void) memcpy(w->w_dst + w->w_pos, src, src_s);
+    }
+    w->w_pos += src_s;
+    return 0;
+}
+
+static CJLIB_ALWAYS_INLINE int writer_emit_byte(struct tape_writer *restrict w, char byte)
+{
+    return writer_emit(w, &byte, 1);
+}
+
+static int writer_emit_string(struct tape_writer *restrict w, const char *restrict src, size_t src_s)
+{
+    size_t escaped_s = cjlib_escaped_size(src, src_s);
+    const size_t double_quotes_len = 2;
+
+    if (NULL != w->w_dst) {
+        if (CJLIB_BRANCH_UNLIKELY(escaped_s + double_quotes_len > w->w_dst_s - w->w_pos)) return -1;
+
+        w->w_dst[w->w_pos] = '"';
+        (void) cjlib_escape(w->w_dst + w->w_pos + 1, src, src_s);
+        w->w_dst[w->w_pos + escaped_s + 1] = '"';
+    }
+    w->w_pos += escaped_s + double_quotes_len;
+    return 0;
+}
+
+/**
+ * Writes a tape as a JSON. The separator before each word depends only on the
+ * word before it (none after a start, a colon after a key and a comma after
+ * anything else), thus the words are written in order, without a stack.
+ *
+ * @param w The state of the serialization.
+ * @param src The tape.
+ * @return 0 on success, otherwise -1.
+ */
+static int write_tape(struct tape_writer *restrict w, const struct cjlib_json_tape *restrict src)
+{
+    char number_str[CJLIB_DTOA_BUF_SIZE];
+    unsigned int previous = CJLIB_TAPE_ARRAY;
+    unsigned int tag;
+    int ret = 0;
+
+    for (size_t at = 0; at < src->t_words_s && 0 == ret; at++) {
+        tag = CJLIB_TAPE_TAG(src->t_words[at]);
+
+        if (CJLIB_TAPE_OBJECT_END != tag && CJLIB_TAPE_ARRAY_END != tag &&
+            CJLIB_TAPE_OBJECT != previous && CJLIB_TAPE_ARRAY != previous) {
+            if (-1 == writer_emit_byte(w, (CJLIB_TAPE_KEY == previous) ? ':' : ',')) return -1;
+        }
+
+        switch (tag) {
+            case CJLIB_TAPE_OBJECT:
+            case CJLIB_TAPE_OBJECT_END:
+            case CJLIB_TAPE_ARRAY:
+            case CJLIB_TAPE_ARRAY_END:
+                ret = writer_emit_byte(w, (char) tag);
+                break;
+            case CJLIB_TAPE_KEY:
+            case CJLIB_TAPE_STRING:
+                ret = writer_emit_string(w, cjlib_json_tape_string(src, at), cjlib_json_tape_string_size(src, at));
+                break;
+            case CJLIB_TAPE_NUMBER:
+                ret = writer_emit(w, number_str, cjlib_dtoa(number_str, cjlib_json_tape_number(src, at)));
+                at++;
+                break;
+            case CJLIB_TAPE_TRUE:
+                ret = writer_emit(w, "true", sizeof("true") - 1);
+                break;
+            case CJLIB_TAPE_FALSE:
+                ret = writer_emit(w, "false", sizeof("false") - 1);
+                break;
+            case CJLIB_TAPE_NULL:
+                ret = writer_emit(w, "null", sizeof("null") - 1);
+                break;
+            default:
+                return -1;
+        }
+        previous = tag;
+    }
+
+    return ret;
+}
+
+size_t cjlib_json_tape_serialized_size(const struct cjlib_json_tape *restrict src)
+{
+    struct tape_writer w;
+    (void) memset(&w, 0x0, sizeof(struct tape_writer));
+
+    if (-1 == write_tape(&w, src)) return 0;
+
+    return w.w_pos;
+}
+
+size_t cjlib_json_tape_serialize(char *restrict dst, size_t dst_s, const struct cjlib_json_tape *restrict src)
+{
+    struct tape_writer w;
+    (void) memset(&w, 0x0, sizeof(struct tape_writer));
+    w.w_dst   = dst;
+    w.w_dst_s = dst_s;
+
+    if (NULL == dst || -1 == write_tape(&w, src)) return 0;
+
+    return w.w_pos;
+}
+
+const char *cjlib_json_tape_stringtify(const struct cjlib_json_tape *restrict src)
+{
+    size_t json_s = cjlib_json_tape_serialized_size(src);
+    if (0 == json_s) return NULL;
+
+    char *json = (char *) malloc(sizeof(char) * (json_s + 1));
+    if (NULL == json) return NULL;
+
+    if (json_s != cjlib_json_tape_serialize(json, json_s, src)) {
+        free(json);
+        return NULL;
+    }
+    json[json_s] = '\0';
+
+    return json;
+}
@@ -0,0 +1,109 @@
+/* File: cjlib_dict_btree.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_DICT_BTREE_H
+#define CJLIB_DICT_BTREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cjlib_queue.h"
+#include "cjlib_memory.h"
+
+struct avl_bs_tree_node;
+
+// The minimum degree of the B-tree, every node but the root has at least this many children.
+#define CJLIB_DICT_BTREE_DEGREE (0x4)
+// The maximum number of entries in a node, their prefixes fill a cache line.
+#define CJLIB_DICT_BTREE_MAX_KEYS (2 * CJLIB_DICT_BTREE_DEGREE - 1)
+
+/**
+ * A node of the B-tree. The entries of a node are sorted by their key. The first
+ * 8 bytes of each key are kept as a big-endian integer, thus most comparisons
+ * are done on the prefixes of the node, without reading the keys.
+ */
+struct cjlib_dict_btree_node
+{
+    uint64_t b_prefixes[CJLIB_DICT_BTREE_MAX_KEYS];                          // The first 8 bytes of each key.
+    struct avl_bs_tree_node *b_entries[CJLIB_DICT_BTREE_MAX_KEYS];           // The entries.
+    struct cjlib_dict_btree_node *b_children[CJLIB_DICT_BTREE_MAX_KEYS + 1]; // The children (none on a leaf).
+    uint8_t b_count;                                                         // The number of entries.
+    bool b_leaf;                                                             // Whether the node has no children.
+};
+
+/**
+ * Searches for the entry with a specific key.
+ *
+ * @param root   The root of the B-tree (NULL if it is empty).
+ * @param prefix The prefix of the key (see cjlib_dict_key_prefix).
+ * @param key    The key.
+ * @return The entry, or NULL if there is no entry with such a key.
+ */
+extern struct avl_bs_tree_node *cjlib_dict_btree_search
+(const struct cjlib_dict_btree_node *root, uint64_t prefix, const char *restrict key);
+
+/**
+ * Inserts an entry, whose key must not exist in the B-tree.
+ *
+ * @param root  A pointer to the root of the B-tree.
+ * @param entry The entry.
+ * @return 0 on success, otherwise -1 (the B-tree holds the same entries as before).
+ */
+extern int cjlib_dict_btree_insert(struct cjlib_dict_btree_node **root, struct avl_bs_tree_node *entry);
+
+/**
+ * Removes the entry with a specific key. The entry itself is not freed.
+ *
+ * @param root   A pointer to the root of the B-tree.
+ * @param prefix The prefix of the key (see cjlib_dict_key_prefix).
+ * @param key    The key.
+ * @return The removed entry, or NULL if there is no entry with such a key.
+ */
+extern struct avl_bs_tree_node *cjlib_dict_btree_remove
+(struct cjlib_dict_btree_node **root, uint64_t prefix, const char *restrict key);
+
+/**
+ * Builds a queue with the entries of the B-tree, sorted by their key.
+ *
+ * @param dst  Where to store the queue.
+ * @param root The root of the B-tree.
+ * @return 0 on success, otherwise -1.
+ */
+extern int cjlib_dict_btree_inorder(struct cjlib_queue *restrict dst, const struct cjlib_dict_btree_node *root);
+
+/**
+ * Frees the nodes of a B-tree.
+ *
+ * @param root                   The root of the B-tree.
+ * @param entry_disposal_routine The routine to call on each entry (NULL to keep the entries).
+ */
+extern void cjlib_dict_btree_destroy
+(struct cjlib_dict_btree_node *root, void (*entry_disposal_routine)(struct avl_bs_tree_node *entry));
+
+/**
+ * Counts the memory of the nodes of a B-tree, but not of its entries.
+ *
+ * @param dst  The memory to add to.
+ * @param root The root of the B-tree.
+ */
+extern void cjlib_dict_btree_memory_usage(struct cjlib_json_memory *restrict dst, const struct cjlib_dict_btree_node *root);
+
+#endif
@@ -0,0 +1,126 @@
+/* File: cjlib_dict_flat.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_DICT_FLAT_H
+#define CJLIB_DICT_FLAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cjlib.h"
+#include "cjlib_dictionary.h"
+
+/**
+ * The entries of a small dictionary, kept in a single block of f_capacity slots
+ * (up to CJLIB_DICT_FLAT_SIZE). The block holds four arrays, one after the other:
+ * the lengths of the keys, their prefixes (see cjlib_dict_key_prefix), the keys and
+ * the values. The lengths and the prefixes are apart from the keys, so that a lookup
+ * examines all of them at once and touches the keys only on a match. The key of
+ * each entry is owned by the block.
+ */
+struct cjlib_dict_flat
+{
+    uint32_t f_size;      // The number of entries.
+    uint32_t f_capacity;  // The number of slots.
+    uint32_t f_lengths[]; // The length of each key (saturated to UINT32_MAX), the other arrays follow.
+};
+
+// The bytes of the lengths of a block, rounded up so that the prefixes are aligned.
+#define CJLIB_DICT_FLAT_LENGTHS_SIZE(CAPACITY) (((CAPACITY) * sizeof(uint32_t) + 7) & ~((size_t) 7))
+
+/**
+ * The size of a block with a specific number of slots.
+ */
+static inline size_t cjlib_dict_flat_size(size_t capacity)
+{
+    return sizeof(struct cjlib_dict_flat) + CJLIB_DICT_FLAT_LENGTHS_SIZE(capacity) +
+           capacity * (sizeof(uint64_t) + sizeof(char *) + sizeof(struct cjlib_json_data));
+}
+
+static inline uint64_t *cjlib_dict_flat_prefixes(const struct cjlib_dict_flat *src)
+{
+    return (uint64_t *) ((char *) src->f_lengths + CJLIB_DICT_FLAT_LENGTHS_SIZE(src->f_capacity));
+}
+
+static inline char **cjlib_dict_flat_keys(const struct cjlib_dict_flat *src)
+{
+    return (char **) (cjlib_dict_flat_prefixes(src) + src->f_capacity);
+}
+
+static inline struct cjlib_json_data *cjlib_dict_flat_values(const struct cjlib_dict_flat *src)
+{
+    return (struct cjlib_json_data *) (cjlib_dict_flat_keys(src) + src->f_capacity);
+}
+
+/**
+ * Gives the length of the key of an entry.
+ *
+ * @param src  The entries.
+ * @param slot The slot of the entry.
+ */
+static inline size_t cjlib_dict_flat_key_size(const struct cjlib_dict_flat *src, size_t slot)
+{
+    return (UINT32_MAX != src->f_lengths[slot]) ? src->f_lengths[slot] : strlen(cjlib_dict_flat_keys(src)[slot]);
+}
+
+/**
+ * Makes an empty block.
+ *
+ * @param capacity The number of slots (at least 1, up to CJLIB_DICT_FLAT_SIZE).
+ * @return The block, or NULL on failure.
+ */
+extern struct cjlib_dict_flat *cjlib_dict_flat_make(size_t capacity);
+
+/**
+ * Searches for the entry with a specific key.
+ *
+ * @param src    The entries (may be NULL).
+ * @param prefix The prefix of the key (see cjlib_dict_key_prefix).
+ * @param key    The key.
+ * @param key_s  The length of the key.
+ * @return The slot of the entry, or -1 if there is no entry with such a key.
+ */
+extern int cjlib_dict_flat_search
+(const struct cjlib_dict_flat *restrict src, uint64_t prefix, const char *restrict key, size_t key_s);
+
+/**
+ * Appends an entry, whose key must not exist. A full block grows (up to
+ * CJLIB_DICT_FLAT_SIZE slots, the dictionary must not hold more entries).
+ *
+ * @param dst   Where the block is stored (a NULL block is made).
+ * @param key   The key, the block takes it over on success.
+ * @param key_s The length of the key.
+ * @param value The value of the entry.
+ * @return 0 on success, otherwise -1 (the block is left as it was).
+ */
+extern int cjlib_dict_flat_append
+(struct cjlib_dict_flat **dst, char *key, size_t key_s, const struct cjlib_json_data *restrict value);
+
+/**
+ * Removes an entry, the last entry takes its place. Neither its key nor its
+ * value are freed.
+ *
+ * @param src  The entries.
+ * @param slot The slot of the entry.
+ */
+extern void cjlib_dict_flat_remove(struct cjlib_dict_flat *restrict src, size_t slot);
+
+#endif
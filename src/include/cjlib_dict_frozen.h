@@ -0,0 +1,100 @@
+/* File: cjlib_dict_frozen.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_DICT_FROZEN_H
+#define CJLIB_DICT_FROZEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct avl_bs_tree_node;
+struct cjlib_json_data;
+
+/**
+ * The entries of a dictionary that no longer changes. They are kept in a single
+ * block, in the order of an implicit binary search tree (Eytzinger layout): the
+ * children of the entry at index i are at 2i and 2i + 1 and the root is at 1, thus
+ * the first levels of every search share the same few cache lines. The prefixes
+ * of the keys are kept in an array of their own, so that a search touches a key
+ * only when the prefixes match.
+ */
+struct cjlib_dict_frozen
+{
+    size_t z_size;                    // The number of entries.
+    uint64_t *z_prefixes;             // The first 8 bytes of each key (see cjlib_dict_key_prefix), from index 1.
+    struct avl_bs_tree_node *z_nodes; // The entries, from index 1, their keys and data are part of the block.
+};
+
+/**
+ * Makes the block of a frozen dictionary. The keys are copied and the values are
+ * moved to the block, thus the nodes can be freed (but not their data).
+ *
+ * @param nodes   The entries, sorted by their key.
+ * @param nodes_s The number of entries.
+ * @return The block, or NULL on failure.
+ */
+extern struct cjlib_dict_frozen *cjlib_dict_frozen_make(struct avl_bs_tree_node *const *nodes, size_t nodes_s);
+
+/**
+ * Searches for the entry with a specific key.
+ *
+ * @param src    The block (may be NULL).
+ * @param prefix The prefix of the key (see cjlib_dict_key_prefix).
+ * @param key    The key.
+ * @return The entry, or NULL if there is no entry with such a key.
+ */
+extern struct avl_bs_tree_node *cjlib_dict_frozen_search
+(const struct cjlib_dict_frozen *src, uint64_t prefix, const char *restrict key);
+
+/**
+ * Frees the block and the values of its entries.
+ *
+ * @param src The block (may be NULL).
+ */
+extern void cjlib_dict_frozen_destroy(struct cjlib_dict_frozen *src);
+
+/**
+ * Gives the index of the entry with the least key (0 if there are no entries).
+ */
+static inline size_t cjlib_dict_frozen_first(size_t size)
+{
+    size_t index = (0 == size) ? 0 : 1;
+    while (0 != index && 2 * index <= size) index *= 2;
+    return index;
+}
+
+/**
+ * Gives the index of the entry that follows an entry in the order of the keys (0 after the last).
+ */
+static inline size_t cjlib_dict_frozen_next(size_t size, size_t index)
+{
+    if (2 * index + 1 <= size) {
+        // The least key of the right subtree.
+        index = 2 * index + 1;
+        while (2 * index <= size) index *= 2;
+        return index;
+    }
+
+    // Go up, until the entry is reached from the left.
+    while (1 == (index & 1)) index >>= 1;
+    return index >> 1;
+}
+
+#endif
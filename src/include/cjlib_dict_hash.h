@@ -0,0 +1,141 @@
+/* File: cjlib_dict_hash.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_DICT_HASH_H
+#define CJLIB_DICT_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct avl_bs_tree_node;
+
+// The number of slots whose control bytes are examined at once.
+#define CJLIB_DICT_HASH_GROUP (0x10)
+
+// The control byte of a slot that was never used.
+#define CJLIB_DICT_HASH_EMPTY   (0x80)
+// The control byte of a slot whose entry was removed.
+#define CJLIB_DICT_HASH_DELETED (0xFE)
+
+// Whether a control byte belongs to a slot that holds an entry.
+#define CJLIB_DICT_HASH_IS_FULL(CTRL) (0 == ((CTRL) & 0x80))
+
+/**
+ * An open-addressing hash table. Each slot has a control byte, which holds
+ * the top 7 bits of the hash of its key (or marks the slot as empty/deleted),
+ * so that a whole group of slots is examined with a few SIMD instructions and
+ * the keys are compared only on a match. The full hash of each key is stored
+ * too, so that growing the table does not hash the keys again.
+ */
+struct cjlib_dict_hash
+{
+    uint8_t *h_ctrl;                   // The control byte of each slot.
+    uint64_t *h_hashes;                // The hash of the key in each slot.
+    struct avl_bs_tree_node **h_slots; // The entry in each slot.
+    size_t h_capacity;                 // The number of slots (0, or a power of two multiple of the group).
+    size_t h_size;                     // The number of entries.
+    size_t h_deleted;                  // The number of slots marked as deleted.
+};
+
+/**
+ * Hashes a key.
+ *
+ * @param key   The key.
+ * @param key_s The length of the key.
+ * @return The hash of the key.
+ */
+extern uint64_t cjlib_dict_hash_key(const char *restrict key, size_t key_s);
+
+/**
+ * Initializes a hash table with room for @size entries.
+ *
+ * @param dst  The hash table.
+ * @param size The number of entries to make room for.
+ * @return 0 on success, otherwise -1.
+ */
+extern int cjlib_dict_hash_init(struct cjlib_dict_hash *restrict dst, size_t size);
+
+/**
+ * Searches for the entry with a specific key.
+ *
+ * @param src  The hash table.
+ * @param key  The key.
+ * @param hash The hash of the key.
+ * @return The entry, or NULL if there is no entry with such a key.
+ */
+extern struct avl_bs_tree_node *cjlib_dict_hash_search
+(const struct cjlib_dict_hash *restrict src, const char *restrict key, uint64_t hash);
+
+/**
+ * Inserts an entry, whose key must not exist in the hash table.
+ *
+ * @param dst   The hash table.
+ * @param entry The entry.
+ * @param hash  The hash of the key of the entry.
+ * @return 0 on success, otherwise -1.
+ */
+extern int cjlib_dict_hash_insert
+(struct cjlib_dict_hash *restrict dst, struct avl_bs_tree_node *entry, uint64_t hash);
+
+/**
+ * Removes the entry with a specific key. The entry itself is not freed.
+ *
+ * @param src  The hash table.
+ * @param key  The key.
+ * @param hash The hash of the key.
+ * @return The removed entry, or NULL if there is no entry with such a key.
+ */
+extern struct avl_bs_tree_node *cjlib_dict_hash_remove
+(struct cjlib_dict_hash *restrict src, const char *restrict key, uint64_t hash);
+
+/**
+ * Frees the slots of a hash table (the entries are not freed).
+ *
+ * @param src The hash table.
+ */
+extern void cjlib_dict_hash_destroy(struct cjlib_dict_hash *restrict src);
+
+/**
+ * Loads the first group of slots that a search for a hash probes into the cache,
+ * without waiting for it. Searching for several keys, after prefetching all of
+ * them, overlaps their cache misses.
+ *
+ * @param src  The hash table.
+ * @param hash The hash of the key.
+ */
+extern void cjlib_dict_hash_prefetch(const struct cjlib_dict_hash *restrict src, uint64_t hash);
+
+/**
+ * Returns the next entry of a hash table, in the order of the slots.
+ *
+ * @param src The hash table.
+ * @param pos The slot to continue from (0 on the first call), it is updated.
+ * @return The next entry, or NULL if there are no more entries.
+ */
+static inline struct avl_bs_tree_node *cjlib_dict_hash_next
+(const struct cjlib_dict_hash *restrict src, size_t *restrict pos)
+{
+    for (; *pos < src->h_capacity; (*pos)++) {
+        if (CJLIB_DICT_HASH_IS_FULL(src->h_ctrl[*pos])) return src->h_slots[(*pos)++];
+    }
+    return NULL;
+}
+
+#endif
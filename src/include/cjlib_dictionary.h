@@ -22,11 +22,21 @@
 #define CJLIB_DICTIONARY_H
 
 #include "cjlib_queue.h"
+#include "cjlib_fragment.h"
+#include "cjlib_dict_hash.h"
+#include "cjlib_dict_btree.h"
+#include "cjlib_memory.h"
 
 #include <memory.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 struct cjlib_json_data;
+struct cjlib_dict_flat;
+struct cjlib_dict_frozen;
+struct cjlib_dict_stage;
 
 // Requires a pointer and accesses the key of a node.
 #define CJLIB_DICT_NODE_KEY(NODE_PTR) (NODE_PTR)->avl_key
@@ -43,16 +53,139 @@ struct avl_bs_tree_node
     char *avl_key;                      // The key of the node.
     struct avl_bs_tree_node *avl_left;  // The left child of the node.
     struct avl_bs_tree_node *avl_right; // The right child of the node.
+    uint64_t avl_prefix;                // The first 8 bytes of the key (see cjlib_dict_key_prefix).
+    size_t avl_key_s;                   // The length of the key.
+    int avl_height;                     // The height of the subtree, whose root is the node (1 on a leaf).
+    uint32_t avl_refs;                  // The number of links to the node (only in a persistent dictionary).
 };
 
 /**
- * The following two types are the same. The only reason that there 
- * are two distinct names for the same structure is to enchace the 
- * readability of the codebose.
+ * The first 8 bytes of a key as a big-endian integer (padded with zeros), thus
+ * the prefixes of two keys compare the same way as the keys do with strcmp.
  */
-typedef struct avl_bs_tree_node cjlib_dict_t;       // Used to represent the whole dictionary.
+static inline uint64_t cjlib_dict_key_prefix(const char *restrict key)
+{
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < sizeof(uint64_t) && '\0' != key[i]; i++) {
+        prefix |= (uint64_t) (unsigned char) key[i] << (8 * (sizeof(uint64_t) - 1 - i));
+    }
+    return prefix;
+}
+
+// The bytes of a key that its prefix holds (see cjlib_dict_key_prefix).
+#define CJLIB_DICT_PREFIX_SIZE (sizeof(uint64_t))
+
+/**
+ * Compares two keys through their prefixes, and through the rest of them only if the prefixes
+ * are the same and the keys go on past them.
+ *
+ * @param prefix The prefix of the key (see cjlib_dict_key_prefix).
+ * @param key The key.
+ * @param other_prefix The prefix of the other key.
+ * @param other The other key.
+ * @return Less than, equal or greater than zero if the key is less than, equal or greater than the other key.
+ */
+static inline int cjlib_dict_key_compare
+(uint64_t prefix, const char *restrict key, uint64_t other_prefix, const char *restrict other)
+{
+    if (prefix != other_prefix) return (prefix < other_prefix) ? -1 : 1;
+    // The keys are the same if they end in the prefix.
+    if (0 == (prefix & 0xFF)) return 0;
+    return strcmp(key + CJLIB_DICT_PREFIX_SIZE, other + CJLIB_DICT_PREFIX_SIZE);
+}
+
+/**
+ * A key along with its length, prefix and hash, computed once so that any number
+ * of operations on any dictionary can use them.
+ */
+struct cjlib_dict_key
+{
+    const char *k_key; // The key (it is not copied, it must outlive the handle).
+    size_t k_key_s;    // The length of the key.
+    uint64_t k_prefix; // The first 8 bytes of the key (see cjlib_dict_key_prefix).
+    uint64_t k_hash;   // The hash of the key (see cjlib_dict_hash_key).
+};
+
+/**
+ * Makes the handle of a key.
+ *
+ * @param dst Where to store the handle.
+ * @param key The key.
+ */
+static inline void cjlib_dict_key_make(struct cjlib_dict_key *restrict dst, const char *key)
+{
+    dst->k_key    = key;
+    dst->k_key_s  = strlen(key);
+    dst->k_prefix = cjlib_dict_key_prefix(key);
+    dst->k_hash   = cjlib_dict_hash_key(key, dst->k_key_s);
+}
+
+// The number of entries that a flat dictionary holds, a dictionary with more moves to the AVL tree.
+#define CJLIB_DICT_FLAT_SIZE (0x8)
+
+// The size past which a dictionary with the CJLIB_DICT_AUTO policy moves to the hash table.
+#define CJLIB_DICT_HASH_THRESHOLD (0x40)
+
+// The number of keys that cjlib_dict_search_many resolves together.
+#define CJLIB_DICT_BATCH_SIZE (0x40)
+
+// The height of an AVL tree is less than 1.45 * log2(n + 2), thus no path of a tree that fits in memory is longer.
+#define CJLIB_DICT_MAX_DEPTH (0x60)
+
+/**
+ * The data structures that can hold the entries of a dictionary.
+ */
+enum cjlib_dict_backend
+{
+    CJLIB_DICT_AUTO, // Chosen by the size of the dictionary (only as a policy).
+    CJLIB_DICT_AVL,  // An AVL tree.
+    CJLIB_DICT_HASH, // An open-addressing hash table.
+    CJLIB_DICT_FLAT, // An array of up to CJLIB_DICT_FLAT_SIZE entries, searched linearly.
+    CJLIB_DICT_BTREE, // A B-tree, its entries are visited in the order of their keys.
+    CJLIB_DICT_FROZEN, // A read-only block of entries (only through cjlib_dict_freeze).
+    CJLIB_DICT_PERSISTENT // An AVL tree shared by its versions (only through cjlib_dict_persist).
+};
+
+/**
+ * The dictionary. It holds the data structure of the entries (e.g., the root of
+ * the AVL tree), which changes on insertions/removals, thus the address of the
+ * dictionary remains the same for as long as the dictionary exists. Every
+ * backend keeps its entries in cjlib_dict_node_t nodes.
+ */
+struct cjlib_dict
+{
+    enum cjlib_dict_backend d_policy;  // The requested backend.
+    enum cjlib_dict_backend d_backend; // The backend that holds the entries (never CJLIB_DICT_AUTO).
+    size_t d_size;                     // The number of entries.
+    union
+    {
+        struct avl_bs_tree_node *d_root;       // The root of the AVL tree (NULL if the dictionary is empty).
+        struct cjlib_dict_hash d_hash;         // The hash table.
+        struct cjlib_dict_flat *d_flat;        // The array of entries (NULL if the dictionary is empty).
+        struct cjlib_dict_btree_node *d_btree; // The root of the B-tree (NULL if the dictionary is empty).
+        struct cjlib_dict_frozen *d_frozen;    // The block of a frozen dictionary.
+    };
+    struct cjlib_fragment d_fragment;  // The cached serialization of the dictionary.
+    struct cjlib_dict_stage *d_stage;  // The entries collected for cjlib_dict_build (NULL if there are none).
+};
+
+typedef struct cjlib_dict cjlib_dict_t;             // Used to represent the whole dictionary.
 typedef struct avl_bs_tree_node cjlib_dict_node_t;  // Used to represent a node of the dictionary (consisting of a key:value pair).
 
+/**
+ * The position of a walk over the entries of a dictionary (see cjlib_dict_iter_next).
+ * The path to the next entry of a tree is kept in the iterator itself, thus the walk
+ * does not allocate any memory.
+ */
+struct cjlib_dict_iter
+{
+    const cjlib_dict_t *i_dict;                   // The dictionary.
+    size_t i_pos;                                 // The next slot of the hash table/flat array/frozen block.
+    size_t i_depth;                               // The number of nodes in i_path.
+    const void *i_path[CJLIB_DICT_MAX_DEPTH];     // The nodes of the tree, from the root to the next entry.
+    uint8_t i_slots[CJLIB_DICT_MAX_DEPTH];        // The next entry of each B-tree node in i_path.
+};
+
 /**
  * initialize the dictionary.
  * 
@@ -61,6 +194,8 @@ typedef struct avl_bs_tree_node cjlib_dict_node_t;  // Used to represent a node
 static inline void cjlib_dict_init(cjlib_dict_t *restrict src)
 {
     (void) memset(src, 0x0, sizeof(cjlib_dict_t));
+    src->d_policy  = CJLIB_DICT_AUTO;
+    src->d_backend = CJLIB_DICT_FLAT;
 }
 
 /**
@@ -68,12 +203,15 @@ static inline void cjlib_dict_init(cjlib_dict_t *restrict src)
 */
 static inline cjlib_dict_t *cjlib_make_dict(void)
 {
-    return (cjlib_dict_t *) malloc(sizeof(cjlib_dict_t));
+    return (cjlib_dict_t *) cjlib_malloc(sizeof(cjlib_dict_t));
 }
 
 /**
  * Travel through the whole tree using the PRE-ORDER method. This function builds a 
  * queue that consists of all the available nodes in the dictionary of interest. 
+ * The B-tree gives its nodes in the order of their keys, the hash table in the order
+ * they are stored. The entries of a flat array are not kept in nodes, they are visited
+ * through cjlib_dict_iter_begin instead (this function fails on them).
  *
  * @param dst A pointer pointing to the memory where the built queue is stored.
  * @param src A pointer to the dictionary (or object) of interest.
@@ -81,6 +219,27 @@ static inline cjlib_dict_t *cjlib_make_dict(void)
 */
 extern int cjlib_dict_preorder(struct cjlib_queue *restrict dst, const cjlib_dict_t *src);
 
+/**
+ * Starts a walk over the entries of a dictionary. The AVL tree, the B-tree and the
+ * frozen block give their entries in the order of their keys, the hash table and the flat array in the
+ * order they are stored. Inserting or removing an entry ends the walk.
+ *
+ * @param dst The iterator.
+ * @param src The dictionary.
+ */
+extern void cjlib_dict_iter_begin(struct cjlib_dict_iter *restrict dst, const cjlib_dict_t *src);
+
+/**
+ * Gives the next entry of a walk (see cjlib_dict_iter_begin).
+ *
+ * @param src The iterator.
+ * @param key Where to store the key of the entry.
+ * @param data Where to store a pointer to the data of the entry.
+ * @return true if there was a next entry, otherwise false.
+ */
+extern bool cjlib_dict_iter_next
+(struct cjlib_dict_iter *restrict src, const char **restrict key, struct cjlib_json_data **restrict data);
+
 /**
  * Searches for an element in a dictionary based on its associated key.
  * 
@@ -103,9 +262,77 @@ extern int cjlib_dict_search
  * @return 0 on success, -1 otherwise.
 */
 extern int cjlib_dict_insert
-(const struct cjlib_json_data *restrict src, cjlib_dict_t **dict,
+(const struct cjlib_json_data *restrict src, cjlib_dict_t *dict,
  const char *restrict key);
 
+/**
+ * The same as cjlib_dict_search, with a key handle (see cjlib_dict_key_make).
+ */
+extern int cjlib_dict_search_k
+(struct cjlib_json_data *restrict dst, const cjlib_dict_t *restrict dict,
+ const struct cjlib_dict_key *restrict key);
+
+/**
+ * Finds the data of an element based on its key, without copying them.
+ *
+ * @param dict A pointer to the dictionary.
+ * @param key  A pointer to a constant character string representing the key.
+ * @return The data kept by the dictionary (valid until the element is removed), or NULL if
+ * there is no such key.
+ */
+extern struct cjlib_json_data *cjlib_dict_lookup(const cjlib_dict_t *restrict dict, const char *restrict key);
+
+/**
+ * The same as cjlib_dict_lookup, with a key handle (see cjlib_dict_key_make).
+ */
+extern struct cjlib_json_data *cjlib_dict_lookup_k
+(const cjlib_dict_t *restrict dict, const struct cjlib_dict_key *restrict key);
+
+/**
+ * Searches for several keys at once. The keys are resolved in batches: in the AVL
+ * tree the paths to the keys of a batch are walked together, while in the hash
+ * table the slots of every key of a batch are loaded before any is probed.
+ *
+ * @param dst    Where to store the data of each key (an array of `keys_s` entries),
+ *               the data of a key that does not exist are left as they were.
+ * @param dict   A pointer to the dictionary.
+ * @param keys   The keys.
+ * @param keys_s The number of keys.
+ * @return The number of keys that exist.
+ */
+extern size_t cjlib_dict_search_many
+(struct cjlib_json_data *restrict dst, const cjlib_dict_t *restrict dict,
+ const char *const *restrict keys, size_t keys_s);
+
+/**
+ * The same as cjlib_dict_insert, with a key handle (see cjlib_dict_key_make).
+ */
+extern int cjlib_dict_insert_k
+(const struct cjlib_json_data *restrict src, cjlib_dict_t *dict,
+ const struct cjlib_dict_key *restrict key);
+
+/**
+ * Sets the data of a key, whether the key exists or not. The data of an existing
+ * key are replaced in place, thus the dictionary is searched once and its
+ * structure does not change.
+ *
+ * @param old  Where to store the previous data of the key (untouched if the key did not exist).
+ * @param src  A pointer to the `cjlib_json_data` structure containing the new data.
+ * @param dict A pointer to the dictionary.
+ * @param key  A pointer to a constant character string representing the key.
+ * @return 1 if the key existed, 0 if it was inserted, -1 on failure (the dictionary is left as it was).
+ */
+extern int cjlib_dict_upsert
+(struct cjlib_json_data *restrict old, const struct cjlib_json_data *restrict src,
+ cjlib_dict_t *dict, const char *restrict key);
+
+/**
+ * The same as cjlib_dict_upsert, with a key handle (see cjlib_dict_key_make).
+ */
+extern int cjlib_dict_upsert_k
+(struct cjlib_json_data *restrict old, const struct cjlib_json_data *restrict src,
+ cjlib_dict_t *dict, const struct cjlib_dict_key *restrict key);
+
 /**
  * Removes an element from a CJLib dictionary based on its key.
  * 
@@ -113,14 +340,118 @@ extern int cjlib_dict_insert
  * @param key  A pointer to a constant character string representing the key.
  * @return 0 on success, -1 otherwise.
 */
-extern int cjlib_dict_remove(cjlib_dict_t **dict, const char *restrict key);
+extern int cjlib_dict_remove(cjlib_dict_t *dict, const char *restrict key);
+
+/**
+ * The same as cjlib_dict_remove, with a key handle (see cjlib_dict_key_make).
+ */
+extern int cjlib_dict_remove_k(cjlib_dict_t *dict, const struct cjlib_dict_key *restrict key);
+
+/**
+ * Moves the entries of a dictionary to another backend. With CJLIB_DICT_AUTO the
+ * backend is chosen by the size of the dictionary, now and on every insertion: the
+ * flat array up to CJLIB_DICT_FLAT_SIZE entries, the AVL tree up to
+ * CJLIB_DICT_HASH_THRESHOLD entries and the hash table past that. A flat dictionary
+ * moves to the AVL tree once it outgrows the array. An insertion never moves a
+ * dictionary back to a smaller backend, after its removals.
+ *
+ * @param dict    A pointer to the dictionary.
+ * @param backend The backend to use.
+ * @return 0 on success, -1 otherwise (the dictionary is left as it was).
+ */
+extern int cjlib_dict_set_backend(cjlib_dict_t *dict, enum cjlib_dict_backend backend);
+
+/**
+ * Collects an entry of a dictionary that is built at once (see cjlib_dict_build).
+ * The entry is not part of the dictionary until then, thus the dictionary must not
+ * be used in any other way meanwhile.
+ *
+ * @param dict  A pointer to the dictionary.
+ * @param key   A pointer to a constant character string representing the key.
+ * @param value A pointer to the data of the entry.
+ * @return 0 on success, -1 otherwise.
+ */
+extern int cjlib_dict_stage
+(cjlib_dict_t *dict, const char *restrict key, const struct cjlib_json_data *restrict value);
+
+/**
+ * Puts the collected entries (see cjlib_dict_stage) in a dictionary. The backend is
+ * built in one pass: the AVL tree is built perfectly balanced out of the sorted
+ * entries, while the hash table is sized for all of them at once.
+ *
+ * @param dict A pointer to the dictionary.
+ * @param duplicate Where to store whether two entries had the same key (can be NULL).
+ * @return 0 on success, -1 otherwise (e.g., two entries with the same key), then the
+ *         entries that did not make it into the dictionary are freed along with their data.
+ */
+extern int cjlib_dict_build(cjlib_dict_t *dict, bool *restrict duplicate);
+
+/**
+ * Moves the entries of a dictionary to a single read-only block, laid out for
+ * searching (see struct cjlib_dict_frozen). From then on, the insertions, the
+ * removals and the changes of backend fail, while any number of threads can
+ * search the dictionary at the same time.
+ *
+ * @param dict A pointer to the dictionary.
+ * @return 0 on success, -1 otherwise (the dictionary is left as it was).
+ */
+extern int cjlib_dict_freeze(cjlib_dict_t *dict);
+
+/**
+ * Moves the entries of a dictionary to a persistent AVL tree. A persistent dictionary
+ * is never changed in place: cjlib_dict_set_version and cjlib_dict_remove_version make
+ * a new version of it, which shares every subtree off the changed path with the old
+ * one and copies only the O(log n) nodes on it. The nodes and the entries are
+ * reference counted, thus the versions are freed in any order (cjlib_dict_destroy),
+ * but the versions that share nodes must not be changed or freed by two threads at
+ * the same time. The insertions, the removals and the changes of backend fail.
+ *
+ * @param dict A pointer to the dictionary.
+ * @return 0 on success, otherwise -1 (the dictionary is left as it was).
+ */
+extern int cjlib_dict_persist(cjlib_dict_t *dict);
+
+/**
+ * Makes a new version of a persistent dictionary (see cjlib_dict_persist), where a key
+ * is associated with some data, whether the key exists or not.
+ *
+ * @param dst   Where to store the new version.
+ * @param src   A pointer to the dictionary, it is left as it was.
+ * @param key   The handle of the key (see cjlib_dict_key_make).
+ * @param value A pointer to the data, the new version takes them over.
+ * @return 0 on success, otherwise -1.
+ */
+extern int cjlib_dict_set_version
+(cjlib_dict_t **dst, const cjlib_dict_t *src, const struct cjlib_dict_key *restrict key,
+ const struct cjlib_json_data *restrict value);
+
+/**
+ * Makes a new version of a persistent dictionary (see cjlib_dict_persist), without a key.
+ *
+ * @param dst Where to store the new version.
+ * @param src A pointer to the dictionary, it is left as it was (and still holds the data of the key).
+ * @param key The handle of the key (see cjlib_dict_key_make).
+ * @return 0 on success, otherwise -1 (e.g., there is no such key).
+ */
+extern int cjlib_dict_remove_version
+(cjlib_dict_t **dst, const cjlib_dict_t *src, const struct cjlib_dict_key *restrict key);
 
 /**
  * This function free's the space of all the nodes in the
- * AVL tree.
+ * AVL tree, as well as the dictionary itself.
  * @param dict A pointer to the dictionary.
- * @return The height of the dictinary (a feature that came as after affect due to the implemantation).
+ * @return The height of the dictinary (a feature that came as after affect due to the implemantation),
+ *         0 on the backends other than the AVL tree.
 */
 extern size_t cjlib_dict_destroy(cjlib_dict_t *dict);
 
+/**
+ * Counts the memory of a dictionary: the dictionary itself, the structure of its backend,
+ * its nodes and their keys. What the values point to (e.g., a string) is not counted.
+ *
+ * @param dst The memory to add to.
+ * @param src The dictionary.
+ */
+extern void cjlib_dict_memory_usage(struct cjlib_json_memory *restrict dst, const cjlib_dict_t *src);
+
 #endif
@@ -0,0 +1,46 @@
+/* File: cjlib_dtoa.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_DTOA_H
+#define CJLIB_DTOA_H
+
+#include <stddef.h>
+
+/**
+ * The minimum size of the buffer given to cjlib_dtoa. Enough for the longest
+ * representation (sign, 17 digits, decimal point, exponent) plus the '\0'.
+ */
+#define CJLIB_DTOA_BUF_SIZE (32)
+
+/**
+ * Writes the shortest decimal representation of @value that reads back
+ * (with strtod) to the exact same double, the closest one to @value if there
+ * are several (the rare inputs that Grisu3 can't decide on are converted by
+ * printf, thus they take longer). Integral values are written
+ * without a fraction, very small/large values use the exponent notation
+ * and non finite values, that JSON can't represent, are written as null.
+ *
+ * @param dst A buffer of at least CJLIB_DTOA_BUF_SIZE bytes.
+ * @param value The number to convert.
+ * @return The number of characters written, excluding the terminating '\0'.
+ */
+extern size_t cjlib_dtoa(char *restrict dst, double value);
+
+#endif
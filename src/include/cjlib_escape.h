@@ -0,0 +1,61 @@
+/* File: cjlib_escape.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_ESCAPE_H
+#define CJLIB_ESCAPE_H
+
+#include <stddef.h>
+
+/**
+ * Calculates the size of a string after escaping it as the contents of a
+ * JSON string (without the surrounding double quotes).
+ *
+ * @param src The string to escape.
+ * @param len The length of the string.
+ * @return The size of the escaped string.
+ */
+extern size_t cjlib_escaped_size(const char *restrict src, size_t len);
+
+/**
+ * Escapes the double quotes, the backslashes and the control characters
+ * of a string, so that it can be placed between double quotes in a JSON.
+ * The string is scanned in blocks, the runs that need no escaping are
+ * copied as they are.
+ *
+ * @param dst Where to write the escaped string (at least cjlib_escaped_size bytes, no '\0' is written).
+ * @param src The string to escape.
+ * @param len The length of the string.
+ * @return The number of bytes written.
+ */
+extern size_t cjlib_escape(char *restrict dst, const char *restrict src, size_t len);
+
+/**
+ * Decodes the escape sequences of the contents of a JSON string. Unicode
+ * escapes (\uXXXX, including surrogate pairs) are decoded into UTF-8. The
+ * decoded string is never longer than the source, thus @dst may be @src.
+ *
+ * @param dst Where to write the decoded string ('\0' terminated).
+ * @param src The contents of the JSON string.
+ * @param len The length of the contents.
+ * @return The length of the decoded string.
+ */
+extern size_t cjlib_unescape(char *dst, const char *src, size_t len);
+
+#endif
@@ -0,0 +1,83 @@
+/* File: cjlib_fragment.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef CJLIB_FRAGMENT_H
+#define CJLIB_FRAGMENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <memory.h>
+#include <malloc.h>
+
+#include "cjlib_memory.h"
+
+/**
+ * The smallest serialization of an object/array that is kept in the cache,
+ * the smaller ones are cheaper to serialize again than to keep in memory.
+ */
+#define CJLIB_FRAGMENT_MIN_SIZE (0x40)
+
+/**
+ * The cached serialization of an object or an array. Each fragment points to
+ * the fragment of the object/array that encloses it, so that a change can
+ * mark as dirty every fragment on the path to the root. If a fragment is dirty,
+ * then so are the fragments of all its ancestors.
+ */
+struct cjlib_fragment
+{
+    char *f_bytes;                   // The cached serialization (NULL if not cached).
+    size_t f_bytes_s;                // The size of f_bytes.
+    bool f_clean;                    // Whether nothing changed since the last cached serialization.
+    struct cjlib_fragment *f_parent; // The fragment of the enclosing object/array (NULL on the root).
+};
+
+static inline void cjlib_fragment_init(struct cjlib_fragment *restrict src)
+{
+    (void) memset(src, 0x0, sizeof(struct cjlib_fragment));
+}
+
+/**
+ * Frees the cached serialization of a fragment and marks it as dirty.
+ *
+ * @param src The fragment.
+ */
+static inline void cjlib_fragment_drop(struct cjlib_fragment *restrict src)
+{
+    cjlib_free(src->f_bytes);
+    src->f_bytes   = NULL;
+    src->f_bytes_s = 0;
+    src->f_clean   = false;
+}
+
+/**
+ * Marks a fragment and the fragments of its ancestors as dirty. The walk
+ * stops on the first dirty ancestor, since the ones above it are dirty too.
+ *
+ * @param src The fragment of the object/array that changed.
+ */
+static inline void cjlib_fragment_invalidate(struct cjlib_fragment *src)
+{
+    while (NULL != src && src->f_clean) {
+        cjlib_fragment_drop(src);
+        src = src->f_parent;
+    }
+}
+
+#endif
@@ -24,6 +24,9 @@
 #include <memory.h>
 #include <malloc.h>
 
+#include "cjlib_fragment.h"
+#include "cjlib_memory.h"
+
 /**
  * For each implementation
  */
@@ -47,6 +50,8 @@ struct cjlib_list_node
 struct cjlib_list
 {
     struct cjlib_list_node *l_head;
+    struct cjlib_fragment l_fragment; // The cached serialization of the list.
+    bool l_frozen;                    // Whether the list is read-only (see cjlib_json_freeze).
 };
 
 static inline void cjlib_list_init(struct cjlib_list *restrict src)
@@ -56,7 +61,7 @@ static inline void cjlib_list_init(struct cjlib_list *restrict src)
 
 static inline struct cjlib_list *make_list(void)
 {
-    return (struct cjlib_list *) malloc(sizeof(struct cjlib_list));
+    return (struct cjlib_list *) cjlib_malloc(sizeof(struct cjlib_list));
 }
 
 extern bool cjlib_list_is_empty(const struct cjlib_list *restrict list);
@@ -65,6 +70,13 @@ extern int cjlib_list_append(const void *restrict src, size_t s_size, struct cjl
 
 extern int cjlib_list_get(void *restrict dst, size_t s_size, int index, const struct cjlib_list *list);
 
+/**
+ * Finds the data of the element at a specific index, without copying it.
+ *
+ * @return The data kept by the list, or NULL if there is no such element.
+ */
+extern void *cjlib_list_at(int index, const struct cjlib_list *list);
+
 extern int cjlib_list_destroy(struct cjlib_list *restrict src, void (*data_disposal_routine)(void *src));
 
 #endif
@@ -27,6 +27,8 @@
 
 #include "cjlib_list.h"
 
+#include "tests.h"
+
 
 // Transform the low level CJLIB_GET_STRING to higher level GET_FIRST_NAME.
 #define GET_FIRST_NAME(JSON_DATA) \
@@ -57,7 +59,7 @@ int main(void)
         exit(-1);
     }
 
-    (void) printf("%s\n", dst.c_value.c_str);
+    (void) printf("%s\n", CJLIB_GET_STRING(dst));
 
     if (-1 == cjlib_json_get(&dst, &json_file, "configurations")) {
            (void) printf("Error\n");
@@ -74,12 +76,35 @@ int main(void)
     	exit(-1);
     }
     
-    (void) printf("%s\n", dst.c_value.c_str);
- 
+    (void) printf("%s\n", CJLIB_GET_STRING(dst));
+
+    // Serialize the json into a buffer of the exact size.
+    size_t json_s  = cjlib_json_serialized_size(&json_file);
+    char *json_str = (char *) malloc(json_s);
+    if (NULL == json_str || json_s != cjlib_json_serialize(json_str, json_s, &json_file)) {
+        (void) printf("Error\n");
+        exit(-1);
+    }
+
+    (void) printf("%.*s\n", (int) json_s, json_str);
+    free(json_str);
 
     //free((void *) cjlib_json_stringtify(&json_file));
 
     //cjlib_json_dump(&json_file);
     // // Close the json file.
     cjlib_json_close(&json_file);
+
+    test_object();
+    test_watch();
+    test_parse_many();
+    test_memory();
+    test_reset();
+    test_dtoa();
+    test_escape();
+    test_dict();
+    test_fragment();
+    test_reload();
+    test_tape();
+    (void) printf("All tests passed\n");
 }
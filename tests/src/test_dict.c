@@ -0,0 +1,331 @@
+/* File: test_dict.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <string.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// The number of keys, well past CJLIB_DICT_HASH_THRESHOLD.
+#define TEST_DICT_KEYS (0x100)
+
+// The value set on the keys that are overwritten, on top of their own.
+#define TEST_DICT_OVERWRITE (0x1000)
+
+// The number of versions of the persistent object.
+#define TEST_DICT_VERSIONS (0x20)
+
+// The keys are visited in a scattered order (TEST_DICT_STRIDE and TEST_DICT_KEYS are coprime).
+#define TEST_DICT_STRIDE (0x9D)
+
+/**
+ * The key of each index. Half of the keys share their first bytes (longer than the prefix
+ * that the backends compare at once), the other half are shorter than the prefix.
+ */
+static void dict_key(char *restrict dst, size_t dst_s, int index)
+{
+    if (index % 2) (void) snprintf(dst, dst_s, "a_shared_prefix_of_the_keys_%d", index);
+    else (void) snprintf(dst, dst_s, "k%d", index);
+}
+
+static void dict_set(cjlib_json_object **obj, int index, double number)
+{
+    struct cjlib_json_data value;
+    char key[0x40];
+
+    dict_key(key, sizeof(key), index);
+    cjlib_json_data_init(&value);
+    value.c_value.c_num = number;
+    TEST_ASSERT(0 == cjlib_json_object_set(obj, key, &value, CJLIB_NUMBER));
+}
+
+static void dict_remove(cjlib_json_object **obj, int index)
+{
+    struct cjlib_json_data value;
+    char key[0x40];
+
+    dict_key(key, sizeof(key), index);
+    TEST_ASSERT(0 == cjlib_json_object_remove(&value, obj, key));
+    TEST_ASSERT(-1 == cjlib_json_object_remove(NULL, obj, key));
+    TEST_ASSERT(NULL == cjlib_json_object_ref(*obj, key));
+}
+
+/**
+ * The object holds exactly the keys that are present, each with its value.
+ */
+static void dict_expect(const cjlib_json_object *obj, const double *values, const bool *present)
+{
+    const struct cjlib_json_data *ref;
+    struct cjlib_json_data value;
+    const char *prev_key = NULL;
+    const char *key;
+    size_t present_s     = 0;
+    size_t visited       = 0;
+    char name[0x40];
+
+    for (int i = 0; i < TEST_DICT_KEYS; i++) {
+        dict_key(name, sizeof(name), i);
+        ref = cjlib_json_object_ref(obj, name);
+        if (!present[i]) {
+            TEST_ASSERT(NULL == ref && -1 == cjlib_json_object_get(&value, obj, name));
+            continue;
+        }
+
+        present_s++;
+        TEST_ASSERT(NULL != ref && CJLIB_NUMBER == ref->c_datatype && values[i] == ref->c_value.c_num);
+        TEST_ASSERT(0 == cjlib_json_object_get(&value, obj, name) && values[i] == value.c_value.c_num);
+    }
+    TEST_ASSERT(present_s == obj->d_size);
+
+    CJLIB_OBJECT_FOR_EACH(key, ref, obj) {
+        // The B-tree visits its entries in the order of their keys.
+        if (CJLIB_DICT_BTREE == obj->d_backend && NULL != prev_key) TEST_ASSERT(0 > strcmp(prev_key, key));
+        prev_key = key;
+        visited++;
+    }
+    TEST_ASSERT(present_s == visited);
+}
+
+/**
+ * Whether the entries of an object are checked in full, at this size (around the sizes where
+ * the backends move their entries, and every so often).
+ */
+static bool dict_check_at(size_t size)
+{
+    return 0 == size % 0x20 || (size + 1) % CJLIB_DICT_FLAT_SIZE <= 2 || (size + 1) % CJLIB_DICT_HASH_THRESHOLD <= 2;
+}
+
+/**
+ * Grows an object of a backend past CJLIB_DICT_FLAT_SIZE and CJLIB_DICT_HASH_THRESHOLD, changes
+ * some of its values and then removes its keys, down to none.
+ */
+static void test_dict_backend(enum cjlib_dict_backend backend)
+{
+    cjlib_json_object *obj = cjlib_json_make_object();
+    double values[TEST_DICT_KEYS];
+    bool present[TEST_DICT_KEYS] = {false};
+    int index;
+
+    TEST_ASSERT(NULL != obj);
+    TEST_ASSERT(0 == cjlib_json_object_set_backend(obj, backend));
+
+    for (int i = 0; i < TEST_DICT_KEYS; i++) {
+        index          = (i * TEST_DICT_STRIDE) % TEST_DICT_KEYS;
+        values[index]  = index;
+        present[index] = true;
+        dict_set(&obj, index, values[index]);
+        if (dict_check_at(obj->d_size)) dict_expect(obj, values, present);
+    }
+    dict_expect(obj, values, present);
+
+    // A flat object moves to the AVL tree once it outgrows the array, an automatic one to the hash table.
+    if (CJLIB_DICT_FLAT == backend) TEST_ASSERT(CJLIB_DICT_AVL == obj->d_backend);
+    else if (CJLIB_DICT_AUTO == backend) TEST_ASSERT(CJLIB_DICT_HASH == obj->d_backend);
+    else TEST_ASSERT(backend == obj->d_backend);
+
+    // The keys that are set again keep their place.
+    for (int i = 0; i < TEST_DICT_KEYS; i += 3) {
+        values[i] = i + TEST_DICT_OVERWRITE;
+        dict_set(&obj, i, values[i]);
+    }
+    dict_expect(obj, values, present);
+
+    for (int i = TEST_DICT_KEYS - 1; i >= 0; i--) {
+        index          = (i * TEST_DICT_STRIDE + 1) % TEST_DICT_KEYS;
+        present[index] = false;
+        dict_remove(&obj, index);
+        if (dict_check_at(obj->d_size)) dict_expect(obj, values, present);
+    }
+    TEST_ASSERT(0 == obj->d_size);
+
+    // Nothing is left behind, the object takes keys again.
+    for (int i = 0; i < CJLIB_DICT_FLAT_SIZE + 1; i++) {
+        values[i]  = -i;
+        present[i] = true;
+        dict_set(&obj, i, values[i]);
+    }
+    dict_expect(obj, values, present);
+
+    // An automatic object does not move back to a smaller backend on the insertions that follow the removals.
+    if (CJLIB_DICT_AUTO == backend) TEST_ASSERT(CJLIB_DICT_HASH == obj->d_backend);
+
+    cjlib_dict_destroy(obj);
+}
+
+/**
+ * The versions of a persistent object: each change gives a new version and leaves the previous
+ * ones as they were, until each one is freed on its own.
+ */
+static void test_dict_persistent(void)
+{
+    static double values[TEST_DICT_VERSIONS][TEST_DICT_KEYS];
+    static bool present[TEST_DICT_VERSIONS][TEST_DICT_KEYS];
+    cjlib_json_object *versions[TEST_DICT_VERSIONS];
+    cjlib_json_object *nested = cjlib_json_make_object();
+    cjlib_json_object *between;
+    struct cjlib_json_data value;
+    int index;
+
+    versions[0] = cjlib_json_make_object();
+    TEST_ASSERT(NULL != versions[0] && NULL != nested);
+    for (int i = 0; i < TEST_DICT_KEYS; i++) {
+        values[0][i]  = i;
+        present[0][i] = true;
+        dict_set(&versions[0], i, values[0][i]);
+    }
+    TEST_ASSERT(0 == cjlib_json_object_persist(versions[0]));
+    TEST_ASSERT(cjlib_json_object_is_persistent(versions[0]));
+    TEST_ASSERT(NULL == cjlib_json_object_ref_mut(versions[0], "k0"));
+
+    // Each version changes a few keys of the previous one: overwrites one, removes another.
+    for (int v = 1; v < TEST_DICT_VERSIONS - 1; v++) {
+        (void) memcpy(values[v], values[v - 1], sizeof(values[v]));
+        (void) memcpy(present[v], present[v - 1], sizeof(present[v]));
+        versions[v] = versions[v - 1];
+
+        index             = (v * TEST_DICT_STRIDE) % TEST_DICT_KEYS;
+        values[v][index]  = index + v * TEST_DICT_OVERWRITE;
+        present[v][index] = true;
+        dict_set(&versions[v], index, values[v][index]);
+        TEST_ASSERT(versions[v] != versions[v - 1]);
+
+        index = (v * TEST_DICT_STRIDE + 1) % TEST_DICT_KEYS;
+        if (present[v][index]) {
+            // The version in between is freed right away, while the next one shares its entries.
+            between           = versions[v];
+            present[v][index] = false;
+            dict_remove(&versions[v], index);
+            TEST_ASSERT(versions[v] != between);
+            cjlib_dict_destroy(between);
+        }
+    }
+
+    // An object set on a persistent one is made persistent as well.
+    cjlib_json_data_init(&value);
+    value.c_value.c_obj              = nested;
+    versions[TEST_DICT_VERSIONS - 1] = versions[TEST_DICT_VERSIONS - 2];
+    TEST_ASSERT(0 == cjlib_json_object_set(&versions[TEST_DICT_VERSIONS - 1], "nested", &value, CJLIB_OBJECT));
+    TEST_ASSERT(cjlib_json_object_is_persistent(nested));
+    TEST_ASSERT(NULL != cjlib_json_object_ref(versions[TEST_DICT_VERSIONS - 1], "nested"));
+    TEST_ASSERT(NULL == cjlib_json_object_ref(versions[TEST_DICT_VERSIONS - 2], "nested"));
+
+    for (int v = 0; v < TEST_DICT_VERSIONS - 1; v++) dict_expect(versions[v], values[v], present[v]);
+
+    // The versions are freed in a scattered order, the ones that remain are intact.
+    for (int v = 0; v < TEST_DICT_VERSIONS; v++) {
+        index = (v * 3) % TEST_DICT_VERSIONS;
+        cjlib_dict_destroy(versions[index]);
+        versions[index] = NULL;
+        if (0 != v % 4) continue;
+
+        for (int w = 0; w < TEST_DICT_VERSIONS - 1; w++) {
+            if (NULL != versions[w]) dict_expect(versions[w], values[w], present[w]);
+        }
+    }
+}
+
+/**
+ * A frozen object finds each of its keys, wherever it was frozen from, and takes no changes.
+ */
+static void test_dict_frozen(enum cjlib_dict_backend backend)
+{
+    cjlib_json_object *obj = cjlib_json_make_object();
+    struct cjlib_json_data value;
+    double values[TEST_DICT_KEYS];
+    bool present[TEST_DICT_KEYS] = {false};
+    char key[0x40];
+    int index;
+
+    TEST_ASSERT(NULL != obj);
+    TEST_ASSERT(0 == cjlib_json_object_set_backend(obj, backend));
+
+    // Every other key is set, thus the keys that are missing fall between the ones that are not.
+    for (int i = 0; i < TEST_DICT_KEYS / 2; i++) {
+        index          = (2 * i * TEST_DICT_STRIDE) % TEST_DICT_KEYS;
+        values[index]  = index;
+        present[index] = true;
+        dict_set(&obj, index, values[index]);
+    }
+
+    TEST_ASSERT(0 == cjlib_json_object_freeze(obj));
+    TEST_ASSERT(cjlib_json_object_is_frozen(obj));
+    dict_expect(obj, values, present);
+
+    dict_key(key, sizeof(key), 0);
+    cjlib_json_data_init(&value);
+    TEST_ASSERT(NULL == cjlib_json_object_ref_mut(obj, key));
+    TEST_ASSERT(-1 == cjlib_json_object_set(&obj, key, &value, CJLIB_NUMBER));
+    TEST_ASSERT(-1 == cjlib_json_object_remove(&value, &obj, key));
+    dict_key(key, sizeof(key), 1);
+    TEST_ASSERT(-1 == cjlib_json_object_set(&obj, key, &value, CJLIB_NUMBER));
+    dict_expect(obj, values, present);
+
+    cjlib_dict_destroy(obj);
+}
+
+/**
+ * An object with two entries of the same key is not parsed and the error says so, while the
+ * entries before them are kept, whatever the backend.
+ */
+static void test_dict_duplicates(enum cjlib_dict_backend backend)
+{
+    static const char root[]   = "{\"a\": 1, \"c\": 3, \"b\": 2, \"c\": 4}";
+    static const char nested[] = "{\"a\": 1, \"inner\": {\"x\": 1, \"x\": 2}, \"z\": 0}";
+    struct cjlib_json_error error;
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_set_backend(&json, backend));
+    TEST_ASSERT(-1 == cjlib_json_parse(&json, root, strlen(root)));
+    cjlib_json_get_error(&error);
+    TEST_ASSERT(DUPLICATE_NAME == error.c_error_code);
+    TEST_ASSERT(0 == cjlib_json_get(&value, &json, "a") && 1 == value.c_value.c_num);
+    cjlib_json_destroy(&json);
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_set_backend(&json, backend));
+    TEST_ASSERT(-1 == cjlib_json_parse(&json, nested, strlen(nested)));
+    cjlib_json_get_error(&error);
+    TEST_ASSERT(DUPLICATE_NAME == error.c_error_code);
+    cjlib_json_destroy(&json);
+}
+
+void test_dict(void)
+{
+    test_dict_backend(CJLIB_DICT_AUTO);
+    test_dict_backend(CJLIB_DICT_AVL);
+    test_dict_backend(CJLIB_DICT_HASH);
+    test_dict_backend(CJLIB_DICT_FLAT);
+    test_dict_backend(CJLIB_DICT_BTREE);
+    test_dict_persistent();
+
+    test_dict_frozen(CJLIB_DICT_AUTO);
+    test_dict_frozen(CJLIB_DICT_AVL);
+    test_dict_frozen(CJLIB_DICT_HASH);
+    test_dict_frozen(CJLIB_DICT_BTREE);
+
+    test_dict_duplicates(CJLIB_DICT_AUTO);
+    test_dict_duplicates(CJLIB_DICT_AVL);
+    test_dict_duplicates(CJLIB_DICT_HASH);
+    test_dict_duplicates(CJLIB_DICT_FLAT);
+    test_dict_duplicates(CJLIB_DICT_BTREE);
+}
@@ -0,0 +1,155 @@
+/* File: test_dtoa.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <ctype.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cjlib_dtoa.h"
+#include "tests.h"
+
+// How many random doubles are read back.
+#define TEST_DTOA_RANDOM (0x10000)
+
+/**
+ * The representation of a number is the expected one.
+ */
+static void dtoa_is(double value, const char *expected)
+{
+    char buf[CJLIB_DTOA_BUF_SIZE];
+
+    TEST_ASSERT(strlen(expected) == cjlib_dtoa(buf, value));
+    TEST_ASSERT(0 == strcmp(expected, buf));
+}
+
+/**
+ * The number of significant digits of a representation.
+ */
+static int dtoa_digits(const char *src)
+{
+    int digits = 0;
+    int zeros  = 0; // The zeros after the last non zero digit.
+
+    for (; '\0' != *src && 'e' != *src; src++) {
+        if ('0' == *src) {
+            if (0 < digits) zeros++;
+        } else if (isdigit((unsigned char) *src)) {
+            digits += zeros + 1;
+            zeros   = 0;
+        }
+    }
+    return digits;
+}
+
+/**
+ * The fewest significant digits with which printf writes a number that reads back.
+ */
+static int dtoa_fewest_digits(double value)
+{
+    char buf[CJLIB_DTOA_BUF_SIZE];
+    int precision;
+
+    for (precision = 1; precision < 17; precision++) {
+        (void) snprintf(buf, sizeof(buf), "%.*e", precision - 1, value);
+        if (strtod(buf, NULL) == value) break;
+    }
+    return precision;
+}
+
+/**
+ * The representation of a number reads back (with strtod) to the same bits, and is not longer
+ * than the one of printf.
+ */
+static void dtoa_round_trip(double value)
+{
+    char buf[CJLIB_DTOA_BUF_SIZE];
+    double back;
+    size_t buf_s;
+
+    buf_s = cjlib_dtoa(buf, value);
+    TEST_ASSERT(buf_s < CJLIB_DTOA_BUF_SIZE && strlen(buf) == buf_s);
+
+    back = strtod(buf, NULL);
+    TEST_ASSERT(0 == memcmp(&value, &back, sizeof(double)));
+    TEST_ASSERT(0.0 == value || dtoa_digits(buf) <= dtoa_fewest_digits(value));
+}
+
+static void test_dtoa_exact(void)
+{
+    dtoa_is(0.0, "0");
+    dtoa_is(-0.0, "-0");
+    dtoa_is(5e-324, "5e-324");
+    dtoa_is(2.2250738585072014e-308, "2.2250738585072014e-308");
+    dtoa_is(DBL_MAX, "1.7976931348623157e+308");
+    dtoa_is(-DBL_MAX, "-1.7976931348623157e+308");
+    // 2^53 + 1 is not a double, it is read as 2^53, while 2^53 + 2 takes the path of the fractions.
+    dtoa_is(9007199254740993.0, "9007199254740992");
+    dtoa_is(9007199254740994.0, "9007199254740994");
+    dtoa_is(1e20, "100000000000000000000");
+    dtoa_is(1e21, "1e+21");
+    dtoa_is(1e-6, "0.000001");
+    dtoa_is(1e-7, "1e-7");
+    dtoa_is(0.1, "0.1");
+    dtoa_is(-1.5, "-1.5");
+    dtoa_is(123.456, "123.456");
+    // Grisu2 alone writes one digit more for these.
+    dtoa_is(2.718316374298659e+276, "2.718316374298659e+276");
+    dtoa_is(30892612233637950.0, "30892612233637950");
+    dtoa_is(NAN, "null");
+    dtoa_is(INFINITY, "null");
+    dtoa_is(-INFINITY, "null");
+}
+
+static void test_dtoa_random(void)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t bits;
+    double value;
+
+    dtoa_round_trip(-0.0);
+    dtoa_round_trip(5e-324);
+    dtoa_round_trip(DBL_MAX);
+    dtoa_round_trip(DBL_MIN);
+    dtoa_round_trip(9007199254740994.0);
+    dtoa_round_trip(1e21);
+
+    // Every pattern of bits (xorshift64), apart from the non finite ones.
+    for (int i = 0; i < TEST_DTOA_RANDOM; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bits = state;
+
+        (void) memcpy(&value, &bits, sizeof(double));
+        if (!isfinite(value)) continue;
+        dtoa_round_trip(value);
+    }
+}
+
+void test_dtoa(void)
+{
+    test_dtoa_exact();
+    test_dtoa_random();
+}
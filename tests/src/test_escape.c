@@ -0,0 +1,168 @@
+/* File: test_escape.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <string.h>
+
+#include "cjlib_escape.h"
+#include "tests.h"
+
+// The longest string that is escaped by the tests.
+#define TEST_ESCAPE_MAX_LEN (0x40)
+
+// Each byte may take up to six (\u00XX).
+#define TEST_ESCAPE_BUF_SIZE (TEST_ESCAPE_MAX_LEN * 6 + 1)
+
+/**
+ * Escapes a string one byte at a time, the way cjlib_escape has to.
+ */
+static size_t reference_escape(char *restrict dst, const char *restrict src, size_t len)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    unsigned char byte;
+    char *out = dst;
+
+    for (size_t i = 0; i < len; i++) {
+        byte = (unsigned char) src[i];
+        switch (byte) {
+            case '"':  out += sprintf(out, "\\\""); break;
+            case '\\': out += sprintf(out, "\\\\"); break;
+            case '\b': out += sprintf(out, "\\b");  break;
+            case '\f': out += sprintf(out, "\\f");  break;
+            case '\n': out += sprintf(out, "\\n");  break;
+            case '\r': out += sprintf(out, "\\r");  break;
+            case '\t': out += sprintf(out, "\\t");  break;
+            default:
+                if (byte <= 0x1F) {
+                    out += sprintf(out, "\\u00%c%c", hex_digits[byte >> 4], hex_digits[byte & 0xF]);
+                } else {
+                    *out++ = (char) byte;
+                }
+        }
+    }
+
+    return (size_t) (out - dst);
+}
+
+/**
+ * cjlib_escape writes what reference_escape does, and cjlib_unescape reads it back.
+ */
+static void escape_round_trip(const char *src, size_t len)
+{
+    char expected[TEST_ESCAPE_BUF_SIZE];
+    char escaped[TEST_ESCAPE_BUF_SIZE];
+    char back[TEST_ESCAPE_BUF_SIZE];
+    size_t expected_s;
+    size_t escaped_s;
+
+    expected_s = reference_escape(expected, src, len);
+    TEST_ASSERT(expected_s == cjlib_escaped_size(src, len));
+
+    escaped_s = cjlib_escape(escaped, src, len);
+    TEST_ASSERT(expected_s == escaped_s && 0 == memcmp(expected, escaped, escaped_s));
+
+    TEST_ASSERT(len == cjlib_unescape(back, escaped, escaped_s));
+    TEST_ASSERT(0 == memcmp(src, back, len) && '\0' == back[len]);
+}
+
+/**
+ * Every control character, along with the double quotes and the backslash.
+ */
+static void test_escape_special(void)
+{
+    char byte;
+
+    for (int i = 0; i <= 0x1F; i++) {
+        byte = (char) i;
+        escape_round_trip(&byte, 1);
+    }
+    escape_round_trip("\"", 1);
+    escape_round_trip("\\", 1);
+    escape_round_trip("/", 1);
+    escape_round_trip("\x7F\x80\xFF", 3);
+    escape_round_trip("caf\xC3\xA9 \"quoted\"\n", 15);
+}
+
+/**
+ * A single byte to escape, at each position of the strings around the blocks (16 and 32 bytes)
+ * that are scanned at once.
+ */
+static void test_escape_blocks(void)
+{
+    static const size_t lengths[] = {1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64};
+    static const char specials[] = {'"', '\\', '\n', 0x1, 0x1F, 0x0};
+    char src[TEST_ESCAPE_MAX_LEN];
+    size_t len;
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        len = lengths[i];
+
+        // Nothing to escape, including the bytes above 0x7F.
+        for (size_t j = 0; j < len; j++) src[j] = (j % 2) ? 'a' : (char) 0xE2;
+        escape_round_trip(src, len);
+
+        for (size_t k = 0; k < sizeof(specials); k++) {
+            for (size_t pos = 0; pos < len; pos++) {
+                (void) memset(src, 'a', len);
+                src[pos] = specials[k];
+                escape_round_trip(src, len);
+            }
+        }
+    }
+}
+
+/**
+ * The unicode escapes, including the surrogate pairs, are decoded into UTF-8.
+ */
+static void test_unescape_unicode(void)
+{
+    static const struct
+    {
+        const char *u_src;
+        const char *u_expected;
+    } cases[] = {
+        {"\\u0041", "A"},
+        {"\\u00e9", "\xC3\xA9"},
+        {"\\u00E9", "\xC3\xA9"},
+        {"\\u20ac", "\xE2\x82\xAC"},
+        {"\\ud83d\\ude00", "\xF0\x9F\x98\x80"},      // U+1F600, a surrogate pair.
+        {"\\uD834\\uDD1E", "\xF0\x9D\x84\x9E"},      // U+1D11E, a surrogate pair.
+        {"x\\ud83d\\ude00y", "x\xF0\x9F\x98\x80y"},
+        {"\\ud83d", "\xED\xA0\xBD"},                 // A lone high surrogate is kept as it is.
+        {"\\ud83dz", "\xED\xA0\xBDz"},
+        {"\\u12", "\\u12"},                          // Too short, kept as it is.
+        {"\\uzzzz", "\\uzzzz"},                      // Not hex, kept as it is.
+        {"\\x", "\\x"},                              // Not an escape, kept as it is.
+        {"a\\/b\\\"c", "a/b\"c"}
+    };
+    char dst[TEST_ESCAPE_BUF_SIZE];
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT(strlen(cases[i].u_expected) == cjlib_unescape(dst, cases[i].u_src, strlen(cases[i].u_src)));
+        TEST_ASSERT(0 == strcmp(cases[i].u_expected, dst));
+    }
+}
+
+void test_escape(void)
+{
+    test_escape_special();
+    test_escape_blocks();
+    test_unescape_unicode();
+}
@@ -0,0 +1,102 @@
+/* File: test_fragment.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <string.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// Every object/array is long enough for its serialization to be cached (see CJLIB_FRAGMENT_MIN_SIZE).
+#define TEST_FRAGMENT_JSON                                                                              \
+    "{\"outer\": {\"inner\": {\"x\": 1, \"pad\": \"a value that makes the inner object long enough\"}, " \
+    "\"list\": [1, 2, 3, \"a value that makes the list long enough to be cached\"]}, "                  \
+    "\"pad\": \"a value that makes the root long enough\"}"
+
+/**
+ * Serializes a json and checks whether it holds a piece.
+ */
+static bool json_has(const struct cjlib_json *src, const char *piece)
+{
+    char *json = (char *) cjlib_json_stringtify(src);
+    bool found;
+
+    TEST_ASSERT(NULL != json);
+    found = NULL != strstr(json, piece);
+    free(json);
+    return found;
+}
+
+/**
+ * The changes to a nested object/array reach the cached serializations of every object above it.
+ */
+void test_fragment(void)
+{
+    struct cjlib_json_data *outer;
+    struct cjlib_json_data *inner;
+    struct cjlib_json_data *list;
+    struct cjlib_json_data *item;
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_FRAGMENT_JSON, strlen(TEST_FRAGMENT_JSON)));
+    cjlib_json_cache_fragments(&json, true);
+    TEST_ASSERT(json_has(&json, "\"x\":1"));
+
+    outer = cjlib_json_ref_mut(&json, "outer");
+    TEST_ASSERT(NULL != outer && CJLIB_OBJECT == outer->c_datatype);
+    inner = cjlib_json_object_ref_mut(outer->c_value.c_obj, "inner");
+    list  = cjlib_json_object_ref_mut(outer->c_value.c_obj, "list");
+    TEST_ASSERT(NULL != inner && NULL != list);
+    TEST_ASSERT(json_has(&json, "[1,2,3,"));
+
+    // Two levels below the root.
+    cjlib_json_data_init(&value);
+    value.c_value.c_num = 2;
+    TEST_ASSERT(0 == cjlib_json_object_set(&inner->c_value.c_obj, "x", &value, CJLIB_NUMBER));
+    TEST_ASSERT(json_has(&json, "\"x\":2"));
+
+    TEST_ASSERT(0 == cjlib_json_object_remove(NULL, &inner->c_value.c_obj, "x"));
+    TEST_ASSERT(!json_has(&json, "\"x\""));
+
+    // The items of an array, appended and changed in place.
+    cjlib_json_data_init(&value);
+    value.c_datatype    = CJLIB_NUMBER;
+    value.c_value.c_num = 4;
+    TEST_ASSERT(0 == cjlib_json_array_append(list->c_value.c_arr, &value));
+    TEST_ASSERT(json_has(&json, "cached\",4]"));
+
+    item = cjlib_json_array_ref_mut(0, list->c_value.c_arr);
+    TEST_ASSERT(NULL != item);
+    item->c_value.c_num = 100;
+    TEST_ASSERT(json_has(&json, "[100,2,3,"));
+
+    // A change made after the array is serialized again, through the same reference, is announced.
+    item->c_value.c_num = 200;
+    cjlib_json_array_touch(list->c_value.c_arr);
+    TEST_ASSERT(json_has(&json, "[200,2,3,"));
+
+    // The cache can be turned off at any time, the serialization remains the same.
+    cjlib_json_cache_fragments(&json, false);
+    TEST_ASSERT(json_has(&json, "[200,2,3,"));
+
+    cjlib_json_destroy(&json);
+}
@@ -0,0 +1,203 @@
+/* File: test_memory.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <string.h>
+
+#include "cjlib.h"
+#include "cjlib_dict_flat.h"
+#include "tests.h"
+
+// Every string is short, thus every block of the json is part of the counters.
+#define TEST_MEMORY_JSON \
+    "{\"name\": \"cjlib\", \"tags\": [\"json\", \"c\", 1, 2.5, true, null], " \
+    "\"nested\": {\"a\": {\"b\": {\"c\": [1, 2, 3]}}, \"d\": false}}"
+
+/**
+ * Whether the counters are back to where they were.
+ */
+static bool counters_restored(const struct cjlib_json_memory_counters *restrict before)
+{
+    struct cjlib_json_memory_counters after;
+
+    cjlib_json_memory_counters(&after);
+    return before->c_live_bytes == after.c_live_bytes && before->c_live_allocations == after.c_live_allocations;
+}
+
+/**
+ * The memory of a json is the memory that the counters gained while it was parsed.
+ */
+static void test_memory_usage(void)
+{
+    struct cjlib_json_memory_counters before;
+    struct cjlib_json_memory_counters after;
+    struct cjlib_json_memory memory;
+    struct cjlib_json json;
+
+    cjlib_json_memory_counters(&before);
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_MEMORY_JSON, strlen(TEST_MEMORY_JSON)));
+
+    TEST_ASSERT(0 == cjlib_json_memory_usage(&memory, &json));
+    cjlib_json_memory_counters(&after);
+    TEST_ASSERT(0 != memory.m_nodes && 0 != memory.m_keys && 0 != memory.m_containers);
+    TEST_ASSERT(memory.m_total == memory.m_nodes + memory.m_keys + memory.m_strings + memory.m_containers +
+                                  memory.m_fragments + memory.m_spare + memory.m_overhead);
+    TEST_ASSERT(after.c_live_bytes - before.c_live_bytes == memory.m_total);
+    TEST_ASSERT(after.c_live_allocations - before.c_live_allocations == memory.m_allocations);
+
+    cjlib_json_destroy(&json);
+    TEST_ASSERT(counters_restored(&before));
+}
+
+/**
+ * The strings that the caller hands over do not unbalance the counters.
+ */
+static void test_memory_handed_strings(void)
+{
+    struct cjlib_json_memory_counters before;
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+
+    cjlib_json_memory_counters(&before);
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+
+    cjlib_json_data_init(&value);
+    value.c_value.c_str = strdup("a string that the caller allocated by itself");
+    TEST_ASSERT(NULL != value.c_value.c_str);
+    TEST_ASSERT(0 == cjlib_json_set(&json, "handed", &value, CJLIB_STRING));
+
+    TEST_ASSERT(0 == cjlib_json_remove(&value, &json, "handed"));
+    cjlib_json_data_destroy(&value);
+
+    TEST_ASSERT(0 == cjlib_json_data_set_string(&value, "a string copied by the library", 30));
+    TEST_ASSERT(0 == cjlib_json_set(&json, "copied", &value, CJLIB_STRING));
+
+    cjlib_json_destroy(&json);
+    TEST_ASSERT(counters_restored(&before));
+}
+
+/**
+ * The blocks of a tape are part of the counters.
+ */
+static void test_memory_tape(void)
+{
+    struct cjlib_json_memory_counters before;
+    struct cjlib_json_memory_counters after;
+    struct cjlib_json_tape tape;
+
+    cjlib_json_memory_counters(&before);
+    TEST_ASSERT(0 == cjlib_json_tape_parse(&tape, TEST_MEMORY_JSON, strlen(TEST_MEMORY_JSON)));
+    cjlib_json_memory_counters(&after);
+    TEST_ASSERT(after.c_live_bytes > before.c_live_bytes);
+
+    cjlib_json_tape_destroy(&tape);
+    TEST_ASSERT(counters_restored(&before));
+}
+
+/**
+ * The flat array of a small object holds as many slots as it needs, it grows on each
+ * insertion that finds it full.
+ */
+static void test_memory_flat(void)
+{
+    static const char small[] = "{\"a\": 1, \"b\": 2, \"c\": 3}";
+    struct cjlib_json_memory memory;
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, small, strlen(small)));
+    TEST_ASSERT(CJLIB_DICT_FLAT == json.c_dict->d_backend);
+    TEST_ASSERT(0 == cjlib_json_object_memory_usage(&memory, json.c_dict));
+    TEST_ASSERT(cjlib_dict_flat_size(3) == memory.m_nodes);
+
+    // The fourth key finds the block full, it grows to 6 slots.
+    cjlib_json_data_init(&value);
+    value.c_value.c_num = 4;
+    TEST_ASSERT(0 == cjlib_json_set(&json, "d", &value, CJLIB_NUMBER));
+    TEST_ASSERT(0 == cjlib_json_object_memory_usage(&memory, json.c_dict));
+    TEST_ASSERT(cjlib_dict_flat_size(6) == memory.m_nodes);
+    TEST_ASSERT(0 == cjlib_json_get(&value, &json, "c") && 3 == value.c_value.c_num);
+    TEST_ASSERT(0 == cjlib_json_get(&value, &json, "d") && 4 == value.c_value.c_num);
+
+    cjlib_json_destroy(&json);
+}
+
+/**
+ * A short string is kept in the value itself, which is as large as it was before.
+ */
+static void test_memory_inline_strings(void)
+{
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+
+    TEST_ASSERT(0x10 == sizeof(struct cjlib_json_data));
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+
+    cjlib_json_data_init(&value);
+    TEST_ASSERT(0 == cjlib_json_data_set_string(&value, "cjlib", 5));
+    TEST_ASSERT(CJLIB_STRING == value.c_datatype && value.c_inline);
+    TEST_ASSERT(0 == cjlib_json_set(&json, "short", &value, CJLIB_STRING));
+
+    TEST_ASSERT(0 == cjlib_json_data_set_string(&value, "a longer string", 15));
+    TEST_ASSERT(CJLIB_STRING == value.c_datatype && !value.c_inline);
+    TEST_ASSERT(0 == cjlib_json_set(&json, "long", &value, CJLIB_STRING));
+
+    TEST_ASSERT(0 == cjlib_json_get(&value, &json, "short"));
+    TEST_ASSERT(0 == strcmp("cjlib", CJLIB_GET_STRING(value)));
+    TEST_ASSERT(0 == cjlib_json_get(&value, &json, "long"));
+    TEST_ASSERT(0 == strcmp("a longer string", CJLIB_GET_STRING(value)));
+
+    cjlib_json_destroy(&json);
+}
+
+/**
+ * The counters stay where they are, while they are off.
+ */
+static void test_memory_counters_off(void)
+{
+    struct cjlib_json_memory_counters before;
+    struct cjlib_json_memory_counters after;
+    struct cjlib_json json;
+
+    cjlib_json_memory_counters(&before);
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_MEMORY_JSON, strlen(TEST_MEMORY_JSON)));
+    cjlib_json_memory_counters(&after);
+    cjlib_json_destroy(&json);
+
+    TEST_ASSERT(before.c_allocations == after.c_allocations && before.c_live_bytes == after.c_live_bytes);
+}
+
+void test_memory(void)
+{
+    bool counting = cjlib_json_memory_counters_enable(false);
+
+    test_memory_counters_off();
+
+    (void) cjlib_json_memory_counters_enable(true);
+    test_memory_usage();
+    test_memory_handed_strings();
+    test_memory_tape();
+    test_memory_flat();
+    test_memory_inline_strings();
+    (void) cjlib_json_memory_counters_enable(counting);
+}
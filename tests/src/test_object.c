@@ -0,0 +1,153 @@
+/* File: test_object.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#include <string.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// Long enough for the serialization of the object to be cached (see CJLIB_FRAGMENT_MIN_SIZE).
+#define TEST_OBJECT \
+    "{\"a\": 1, \"b\": 2, \"padding\": \"a value that makes the serialization long enough\"}"
+
+/**
+ * Serializes a json and compares it with the expected one.
+ */
+static void expect_json(const struct cjlib_json *src, const char *expected)
+{
+    char *json = (char *) cjlib_json_stringtify(src);
+
+    TEST_ASSERT(NULL != json);
+    TEST_ASSERT(NULL != strstr(json, expected));
+    free(json);
+}
+
+/**
+ * The values that are changed in place, while the serialization of the object is cached.
+ */
+static void test_ref_mut(void)
+{
+    struct cjlib_json json;
+    struct cjlib_json_data *value;
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_OBJECT, strlen(TEST_OBJECT)));
+    cjlib_json_cache_fragments(&json, true);
+
+    value = cjlib_json_ref_mut(&json, "a");
+    TEST_ASSERT(NULL != value && CJLIB_NUMBER == value->c_datatype);
+    value->c_value.c_num = 7;
+    expect_json(&json, "\"a\":7");
+
+    // The object is cached again, the change must be announced.
+    value->c_value.c_num = 999;
+    cjlib_json_object_touch(json.c_dict);
+    expect_json(&json, "\"a\":999");
+
+    cjlib_json_destroy(&json);
+}
+
+/**
+ * The references are taken again once the object changes, its entries move as it grows.
+ */
+static void test_ref_growth(void)
+{
+    struct cjlib_json json;
+    struct cjlib_json_data value;
+    const struct cjlib_json_data *ref;
+    char key[0x10];
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_OBJECT, strlen(TEST_OBJECT)));
+
+    ref = cjlib_json_ref(&json, "b");
+    TEST_ASSERT(NULL != ref && 2 == ref->c_value.c_num);
+
+    for (int i = 0; i < 10; i++) {
+        (void) snprintf(key, sizeof(key), "key%d", i);
+        cjlib_json_data_init(&value);
+        value.c_value.c_num = i;
+        TEST_ASSERT(0 == cjlib_json_set(&json, key, &value, CJLIB_NUMBER));
+    }
+    TEST_ASSERT(0 == cjlib_json_remove(NULL, &json, "a"));
+
+    ref = cjlib_json_ref(&json, "b");
+    TEST_ASSERT(NULL != ref && 2 == ref->c_value.c_num);
+    ref = cjlib_json_ref(&json, "key9");
+    TEST_ASSERT(NULL != ref && 9 == ref->c_value.c_num);
+    TEST_ASSERT(NULL == cjlib_json_ref(&json, "a"));
+
+    cjlib_json_destroy(&json);
+}
+
+/**
+ * The walks over the members, with and without changing them, while the serialization is cached.
+ */
+static void test_iter(void)
+{
+    struct cjlib_json json;
+    const struct cjlib_json_data *value;
+    struct cjlib_json_data *value_mut;
+    const char *key;
+    double sum   = 0;
+    size_t count = 0;
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_OBJECT, strlen(TEST_OBJECT)));
+    cjlib_json_cache_fragments(&json, true);
+    expect_json(&json, "\"a\":1");
+
+    CJLIB_OBJECT_FOR_EACH(key, value, json.c_dict) {
+        if (CJLIB_NUMBER == value->c_datatype) sum += value->c_value.c_num;
+    }
+    TEST_ASSERT(3 == sum);
+
+    CJLIB_OBJECT_FOR_EACH_MUT(key, value_mut, json.c_dict) {
+        if (CJLIB_NUMBER == value_mut->c_datatype) value_mut->c_value.c_num *= 10;
+    }
+    expect_json(&json, "\"a\":10");
+    expect_json(&json, "\"b\":20");
+
+    // The iterations nest, and the variables of the caller keep their names (e.g., iter).
+    cjlib_json_object *iter = json.c_dict;
+    const struct cjlib_json_data *other;
+    const char *other_key;
+    CJLIB_OBJECT_FOR_EACH(key, value, iter) {
+        CJLIB_OBJECT_FOR_EACH(other_key, other, iter) count++;
+    }
+    TEST_ASSERT(9 == count);
+    count = 0;
+
+    // The values of a frozen object are not handed out for changes.
+    TEST_ASSERT(0 == cjlib_json_freeze(&json));
+    CJLIB_OBJECT_FOR_EACH_MUT(key, value_mut, json.c_dict) count++;
+    TEST_ASSERT(0 == count);
+    CJLIB_OBJECT_FOR_EACH(key, value, json.c_dict) count++;
+    TEST_ASSERT(3 == count);
+
+    cjlib_json_destroy(&json);
+}
+
+void test_object(void)
+{
+    test_ref_mut();
+    test_ref_growth();
+    test_iter();
+}
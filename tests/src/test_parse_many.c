@@ -0,0 +1,84 @@
+/* File: test_parse_many.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <string.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// The number of inputs, more than the threads, thus some of them are stolen.
+#define TEST_PARSE_MANY_INPUTS (0x40)
+
+/**
+ * Many jsons stored in memory, every fifth of them is not valid.
+ */
+static void test_parse_many_buffers(void)
+{
+    struct cjlib_json_source src[TEST_PARSE_MANY_INPUTS];
+    struct cjlib_json_error errors[TEST_PARSE_MANY_INPUTS];
+    struct cjlib_json dst[TEST_PARSE_MANY_INPUTS];
+    char buffers[TEST_PARSE_MANY_INPUTS][0x40];
+    struct cjlib_json_data value;
+
+    for (int i = 0; i < TEST_PARSE_MANY_INPUTS; i++) {
+        if (0 == i % 5) (void) snprintf(buffers[i], sizeof(buffers[i]), "{\"id\": %d, \"name\" 1}", i);
+        else (void) snprintf(buffers[i], sizeof(buffers[i]), "{\"id\": %d, \"name\": \"input\"}", i);
+        src[i].s_path  = NULL;
+        src[i].s_buf   = buffers[i];
+        src[i].s_buf_s = strlen(buffers[i]);
+    }
+
+    TEST_ASSERT(-1 == cjlib_json_parse_many(dst, errors, src, TEST_PARSE_MANY_INPUTS, 4));
+
+    for (int i = 0; i < TEST_PARSE_MANY_INPUTS; i++) {
+        if (0 == i % 5) {
+            TEST_ASSERT(NO_ERROR != errors[i].c_error_code);
+        } else {
+            TEST_ASSERT(NO_ERROR == errors[i].c_error_code);
+            TEST_ASSERT(0 == cjlib_json_get(&value, &dst[i], "id") && i == value.c_value.c_num);
+        }
+        cjlib_json_close(&dst[i]);
+    }
+}
+
+/**
+ * The jsons and the errors are initialized, even when no input is parsed.
+ */
+static void test_parse_many_early_failure(void)
+{
+    struct cjlib_json_error errors[2];
+    struct cjlib_json dst[2];
+
+    (void) memset(dst, 0xFF, sizeof(dst));
+    (void) memset(errors, 0x0, sizeof(errors));
+
+    TEST_ASSERT(-1 == cjlib_json_parse_many(dst, errors, NULL, 2, 1));
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT(NO_ERROR != errors[i].c_error_code);
+        cjlib_json_close(&dst[i]);
+    }
+}
+
+void test_parse_many(void)
+{
+    test_parse_many_buffers();
+    test_parse_many_early_failure();
+}
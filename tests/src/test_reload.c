@@ -0,0 +1,123 @@
+/* File: test_reload.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <stdatomic.h>
+#include <string.h>
+#include <threads.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// The number of threads that read the handle, while it is reloaded.
+#define TEST_RELOAD_READERS (0x4)
+
+// The number of versions that are reloaded.
+#define TEST_RELOAD_VERSIONS (0xC8)
+
+/**
+ * The state shared by the readers and the thread that reloads.
+ */
+struct reload_state
+{
+    struct cjlib_json_handle r_handle; // The handle that is read and reloaded.
+    atomic_bool r_done;                // Set once the last version is reloaded.
+    atomic_int r_failures;             // The number of the versions that were not read as expected.
+};
+
+/**
+ * Reads the current version until the reloads are done. Each version must be whole (its
+ * "double" is twice its "version") and the versions must never go backwards.
+ */
+static int reader_run(void *arg)
+{
+    struct reload_state *state = (struct reload_state *) arg;
+    const struct cjlib_json *json;
+    struct cjlib_json_data version;
+    struct cjlib_json_data twice;
+    double last = 0;
+    unsigned int epoch;
+    char *text;
+
+    while (!atomic_load(&state->r_done)) {
+        json = cjlib_json_handle_enter(&state->r_handle, &epoch);
+
+        if (0 != cjlib_json_get(&version, json, "version") || 0 != cjlib_json_get(&twice, json, "double") ||
+            2 * version.c_value.c_num != twice.c_value.c_num || version.c_value.c_num < last) {
+            atomic_fetch_add(&state->r_failures, 1);
+        } else {
+            last = version.c_value.c_num;
+        }
+
+        // A frozen version is serialized by many threads at once.
+        text = (char *) cjlib_json_stringtify(json);
+        if (NULL == text || NULL == strstr(text, "\"version\"")) atomic_fetch_add(&state->r_failures, 1);
+        free(text);
+
+        cjlib_json_handle_leave(&state->r_handle, epoch);
+    }
+
+    return 0;
+}
+
+static int reload_version(struct cjlib_json_handle *restrict handle, const char *restrict buf)
+{
+    struct cjlib_json_source src = {.s_path = NULL, .s_buf = buf, .s_buf_s = strlen(buf)};
+
+    return cjlib_json_reload(handle, &src);
+}
+
+/**
+ * Reloads a handle while other threads read it.
+ */
+void test_reload(void)
+{
+    static struct reload_state state;
+    thrd_t readers[TEST_RELOAD_READERS];
+    struct cjlib_json_data version;
+    const struct cjlib_json *json;
+    unsigned int epoch;
+    char buf[0x80];
+
+    TEST_ASSERT(0 == cjlib_json_handle_init(&state.r_handle));
+    atomic_init(&state.r_done, false);
+    atomic_init(&state.r_failures, 0);
+    TEST_ASSERT(0 == reload_version(&state.r_handle, "{\"version\": 1, \"double\": 2}"));
+
+    for (int i = 0; i < TEST_RELOAD_READERS; i++) TEST_ASSERT(thrd_success == thrd_create(&readers[i], &reader_run, &state));
+
+    for (int i = 2; i <= TEST_RELOAD_VERSIONS; i++) {
+        (void) snprintf(buf, sizeof(buf), "{\"version\": %d, \"double\": %d, \"padding\": [1, 2, 3]}", i, 2 * i);
+        TEST_ASSERT(0 == reload_version(&state.r_handle, buf));
+
+        // A version that is not valid leaves the current one in place.
+        if (0 == i % 0x20) TEST_ASSERT(-1 == reload_version(&state.r_handle, "{\"version\" 0}"));
+    }
+
+    atomic_store(&state.r_done, true);
+    for (int i = 0; i < TEST_RELOAD_READERS; i++) TEST_ASSERT(thrd_success == thrd_join(readers[i], NULL));
+    TEST_ASSERT(0 == atomic_load(&state.r_failures));
+
+    json = cjlib_json_handle_enter(&state.r_handle, &epoch);
+    TEST_ASSERT(0 == cjlib_json_get(&version, json, "version") && TEST_RELOAD_VERSIONS == version.c_value.c_num);
+    cjlib_json_handle_leave(&state.r_handle, epoch);
+
+    cjlib_json_handle_destroy(&state.r_handle);
+}
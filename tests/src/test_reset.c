@@ -0,0 +1,110 @@
+/* File: test_reset.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// Every string is short, thus the parsing takes each of its blocks from the allocation routines of the library.
+#define TEST_RESET_JSON \
+    "{\"id\": 7, \"name\": \"cjlib\", \"tags\": [\"json\", \"c\", true, null], " \
+    "\"nested\": {\"a\": {\"b\": [1, 2, 3]}, \"c\": false}}"
+
+// How many times the same json is parsed into the same json.
+#define TEST_RESET_ROUNDS (0x10)
+
+/**
+ * After the first parsing, a json of the same shape is parsed from the spare blocks alone.
+ */
+static void test_reset_spare(void)
+{
+    struct cjlib_json_memory_counters before;
+    struct cjlib_json_memory_counters after;
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+
+    cjlib_json_memory_counters(&before);
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_RESET_JSON, strlen(TEST_RESET_JSON)));
+    TEST_ASSERT(0 == cjlib_json_reset(&json));
+    TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_RESET_JSON, strlen(TEST_RESET_JSON)));
+
+    for (int i = 0; i < TEST_RESET_ROUNDS; i++) {
+        struct cjlib_json_memory_counters round;
+
+        TEST_ASSERT(0 == cjlib_json_reset(&json));
+        cjlib_json_memory_counters(&round);
+        TEST_ASSERT(0 == cjlib_json_parse(&json, TEST_RESET_JSON, strlen(TEST_RESET_JSON)));
+        cjlib_json_memory_counters(&after);
+        TEST_ASSERT(round.c_allocations == after.c_allocations);
+    }
+    TEST_ASSERT(0 == cjlib_json_get(&value, &json, "id"));
+    TEST_ASSERT(7 == value.c_value.c_num);
+
+    // An invalid json leaves nothing behind, either.
+    TEST_ASSERT(0 == cjlib_json_reset(&json));
+    TEST_ASSERT(-1 == cjlib_json_parse(&json, "{\"id\" 7}", 8));
+
+    cjlib_json_destroy(&json);
+    cjlib_json_memory_counters(&after);
+    TEST_ASSERT(before.c_live_bytes == after.c_live_bytes && before.c_live_allocations == after.c_live_allocations);
+}
+
+/**
+ * A reset json reads its file again.
+ */
+static void test_reset_read(void)
+{
+    char path[] = "/tmp/cjlib_reset_XXXXXX";
+    struct cjlib_json_data value;
+    struct cjlib_json json;
+    FILE *fp;
+    int fd;
+
+    fd = mkstemp(path);
+    TEST_ASSERT(-1 != fd);
+    fp = fdopen(fd, "w");
+    TEST_ASSERT(NULL != fp);
+    TEST_ASSERT(strlen(TEST_RESET_JSON) == fwrite(TEST_RESET_JSON, sizeof(char), strlen(TEST_RESET_JSON), fp));
+    TEST_ASSERT(0 == fclose(fp));
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_open(&json, path, "r"));
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT(0 == cjlib_json_read(&json));
+        TEST_ASSERT(0 == cjlib_json_get(&value, &json, "name"));
+        TEST_ASSERT(0 == strcmp("cjlib", CJLIB_GET_STRING(value)));
+        TEST_ASSERT(0 == cjlib_json_reset(&json));
+    }
+    cjlib_json_close(&json);
+    TEST_ASSERT(0 == remove(path));
+}
+
+void test_reset(void)
+{
+    bool counting = cjlib_json_memory_counters_enable(true);
+
+    test_reset_spare();
+    test_reset_read();
+    (void) cjlib_json_memory_counters_enable(counting);
+}
@@ -0,0 +1,126 @@
+/* File: test_tape.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <string.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+/**
+ * Parses a json into a tape and checks its serialization. The serialization, parsed again,
+ * gives the same serialization.
+ */
+static void tape_round_trip(const char *src, const char *expected)
+{
+    struct cjlib_json_tape tape;
+    struct cjlib_json_tape again;
+    char *json;
+    char *json_again;
+    size_t json_s;
+
+    TEST_ASSERT(0 == cjlib_json_tape_parse(&tape, src, strlen(src)));
+    json = (char *) cjlib_json_tape_stringtify(&tape);
+    TEST_ASSERT(NULL != json && 0 == strcmp(expected, json));
+
+    // The size is exact, a buffer of that size is enough and a shorter one is not.
+    json_s = strlen(json);
+    TEST_ASSERT(json_s == cjlib_json_tape_serialized_size(&tape));
+    TEST_ASSERT(json_s == cjlib_json_tape_serialize(json, json_s, &tape));
+    TEST_ASSERT(0 == cjlib_json_tape_serialize(json, json_s - 1, &tape));
+
+    TEST_ASSERT(0 == cjlib_json_tape_parse(&again, json, json_s));
+    json_again = (char *) cjlib_json_tape_stringtify(&again);
+    TEST_ASSERT(NULL != json_again && 0 == strcmp(expected, json_again));
+
+    free(json_again);
+    free(json);
+    cjlib_json_tape_destroy(&again);
+    cjlib_json_tape_destroy(&tape);
+}
+
+static void test_tape_round_trip(void)
+{
+    tape_round_trip(" {} ", "{}");
+    tape_round_trip("[]", "[]");
+    tape_round_trip("\"str\"", "\"str\"");
+    tape_round_trip("12", "12");
+    tape_round_trip("[1, [2, [3, [4, {\"deep\": [5]}]]]]", "[1,[2,[3,[4,{\"deep\":[5]}]]]]");
+    tape_round_trip("{ \"a\" : [1, 2.5, -0, 1e21, 1E-7, 0.1, true, false, null], \"b\": {}, \"c\": [] }",
+                    "{\"a\":[1,2.5,-0,1e+21,1e-7,0.1,true,false,null],\"b\":{},\"c\":[]}");
+    // The escapes are decoded on parsing and written again (the unicode ones as UTF-8).
+    tape_round_trip("{\"esc\\\"key\": \"x\\\"y\\\\z\\n\\t\\u0001\\u00e9\\ud83d\\ude00\"}",
+                    "{\"esc\\\"key\":\"x\\\"y\\\\z\\n\\t\\u0001\xC3\xA9\xF0\x9F\x98\x80\"}");
+    tape_round_trip("{\"long\": \"a string that is longer than any short string, with a number 1234567890\"}",
+                    "{\"long\":\"a string that is longer than any short string, with a number 1234567890\"}");
+    // A number too long for the scratch of the tape is copied into a block of its own.
+    tape_round_trip("[1.00000000000000000000000000000000000000000000000000000000000000000000000]", "[1]");
+}
+
+/**
+ * The values of a tape are reached by their keys and indices.
+ */
+static void test_tape_navigation(void)
+{
+    static const char json[] = "{\"id\": 7, \"tags\": [\"a\", true, null, {\"x\": -1.5}], \"name\": \"cjlib\"}";
+    struct cjlib_json_tape tape;
+    size_t tags;
+    size_t at;
+
+    TEST_ASSERT(0 == cjlib_json_tape_parse(&tape, json, strlen(json)));
+    TEST_ASSERT(CJLIB_OBJECT == cjlib_json_tape_type(&tape, 0) && 3 == cjlib_json_tape_size(&tape, 0));
+
+    TEST_ASSERT(0 == cjlib_json_tape_object_get(&at, &tape, 0, "id"));
+    TEST_ASSERT(CJLIB_NUMBER == cjlib_json_tape_type(&tape, at) && 7 == cjlib_json_tape_number(&tape, at));
+    TEST_ASSERT(0 == cjlib_json_tape_object_get(&at, &tape, 0, "name"));
+    TEST_ASSERT(0 == strcmp("cjlib", cjlib_json_tape_string(&tape, at)) && 5 == cjlib_json_tape_string_size(&tape, at));
+    TEST_ASSERT(-1 == cjlib_json_tape_object_get(&at, &tape, 0, "missing"));
+
+    TEST_ASSERT(0 == cjlib_json_tape_object_get(&tags, &tape, 0, "tags"));
+    TEST_ASSERT(CJLIB_ARRAY == cjlib_json_tape_type(&tape, tags) && 4 == cjlib_json_tape_size(&tape, tags));
+    TEST_ASSERT(0 == cjlib_json_tape_array_get(&at, &tape, tags, 1) && cjlib_json_tape_bool(&tape, at));
+    TEST_ASSERT(0 == cjlib_json_tape_array_get(&at, &tape, tags, 2) && CJLIB_NULL == cjlib_json_tape_type(&tape, at));
+    TEST_ASSERT(0 == cjlib_json_tape_array_get(&at, &tape, tags, 3));
+    TEST_ASSERT(0 == cjlib_json_tape_object_get(&at, &tape, at, "x") && -1.5 == cjlib_json_tape_number(&tape, at));
+    TEST_ASSERT(-1 == cjlib_json_tape_array_get(&at, &tape, tags, 4));
+    TEST_ASSERT(-1 == cjlib_json_tape_array_get(&at, &tape, 0, 0));
+
+    cjlib_json_tape_destroy(&tape);
+}
+
+/**
+ * The jsons that are not valid are not parsed.
+ */
+static void test_tape_invalid(void)
+{
+    static const char *invalid[] = {"", "{", "\"abc", "{\"a\" 1}", "[1,]", "[1 2]", "{\"a\":1,}", "{\"a\":1}x", "[tru]"};
+    struct cjlib_json_tape tape;
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        TEST_ASSERT(-1 == cjlib_json_tape_parse(&tape, invalid[i], strlen(invalid[i])));
+    }
+}
+
+void test_tape(void)
+{
+    test_tape_round_trip();
+    test_tape_navigation();
+    test_tape_invalid();
+}
@@ -0,0 +1,98 @@
+/* File: test_watch.c
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+
+#include <stdatomic.h>
+#include <string.h>
+#include <threads.h>
+
+#include "cjlib.h"
+#include "tests.h"
+
+// The longest wait for a change to be delivered (in tenths of a second).
+#define TEST_WATCH_WAIT (50)
+
+// The last value of "version" that the routine received (-1 on a failure of the watcher).
+static atomic_int g_version;
+
+static void on_change(struct cjlib_json *restrict json, void *arg)
+{
+    struct cjlib_json_data value;
+
+    (void) arg;
+    if (NULL == json) {
+        atomic_store(&g_version, -1);
+        return;
+    }
+    if (0 == cjlib_json_get(&value, json, "version")) atomic_store(&g_version, (int) value.c_value.c_num);
+    cjlib_json_close(json);
+}
+
+static void write_file(const char *path, const char *contents)
+{
+    FILE *fp = fopen(path, "w");
+
+    TEST_ASSERT(NULL != fp);
+    TEST_ASSERT(strlen(contents) == fwrite(contents, sizeof(char), strlen(contents), fp));
+    TEST_ASSERT(0 == fclose(fp));
+}
+
+static bool wait_version(int version)
+{
+    const struct timespec tenth = {.tv_sec = 0, .tv_nsec = 100000000};
+
+    for (int i = 0; i < TEST_WATCH_WAIT; i++) {
+        if (version == atomic_load(&g_version)) return true;
+        (void) thrd_sleep(&tenth, NULL);
+    }
+    return false;
+}
+
+void test_watch(void)
+{
+    char directory[] = "/tmp/cjlib_watch_XXXXXX";
+    char path[sizeof(directory) + 0x10];
+    struct cjlib_json_watcher *watcher;
+    struct cjlib_json json;
+
+    TEST_ASSERT(NULL != mkdtemp(directory));
+    (void) snprintf(path, sizeof(path), "%s/watched.json", directory);
+    write_file(path, "{\"version\": 1}");
+
+    TEST_ASSERT(0 == cjlib_json_init(&json));
+    TEST_ASSERT(0 == cjlib_json_open(&json, path, "r"));
+    TEST_ASSERT(0 == cjlib_json_read(&json));
+
+    atomic_store(&g_version, 0);
+    TEST_ASSERT(0 == cjlib_json_watch(&watcher, &json, &on_change, NULL));
+
+    write_file(path, "{\"version\": 2}");
+    TEST_ASSERT(wait_version(2));
+
+    // A file that is not a valid json is skipped.
+    write_file(path, "{\"version\": ");
+    write_file(path, "{\"version\": 3}");
+    TEST_ASSERT(wait_version(3));
+
+    TEST_ASSERT(0 == cjlib_json_unwatch(watcher));
+    cjlib_json_close(&json);
+    TEST_ASSERT(0 == remove(path));
+    TEST_ASSERT(0 == remove(directory));
+}
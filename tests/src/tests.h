@@ -0,0 +1,48 @@
+/* File: tests.h
+ *
+ ************************************************************************
+ * Copyright (C) 2026 Constantinos Argyriou
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *************************************************************************
+ */
+
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Stops the tests, when a condition does not hold.
+#define TEST_ASSERT(COND)                                                             \
+    do {                                                                              \
+        if (!(COND)) {                                                                \
+            (void) printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #COND);          \
+            exit(-1);                                                                 \
+        }                                                                             \
+    } while (0)
+
+extern void test_object(void);
+extern void test_watch(void);
+extern void test_parse_many(void);
+extern void test_memory(void);
+extern void test_reset(void);
+extern void test_dtoa(void);
+extern void test_escape(void);
+extern void test_dict(void);
+extern void test_fragment(void);
+extern void test_reload(void);
+extern void test_tape(void);
+
+#endif